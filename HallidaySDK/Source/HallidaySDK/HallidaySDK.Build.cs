@@ -82,5 +82,8 @@ public class HallidaySDK : ModuleRules
                 Path.Combine(ModuleDirectory, "..", "ThirdParty", "secp256k1", "lib", "libsecp256k1.a")
             );
         }
+        
+        // Asset and balance responses are requested compressed and decoded with the engine's zlib.
+        AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
 	}
 }
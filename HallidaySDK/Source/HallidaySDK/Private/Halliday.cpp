@@ -1,52 +1,34 @@
 #include "Halliday.h"
+#include "HallidayHex.h"
+#include "HallidayHttpCompression.h"
+#include "HallidayKeccak.h"
+#include "Hash/CityHash.h"
+#include "HallidayRequestScheduler.h"
+#include "HallidaySigner.h"
+#include "HallidayUserOperation.h"
 #include "Kismet/GameplayStatics.h"
-#include "secp256k1.h"
-#include "secp256k1_recovery.h"
+#include "Misc/Paths.h"
+#include "Containers/Ticker.h"
 #include <assert.h>
 #include <string.h>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
-// Include the following libraries depending on OS.
-// These are used for FillRandom()
-#if defined(_WIN32)
-#include <Windows.h>
-#include <bcrypt.h>
-#elif defined(__linux__) || defined(__FreeBSD__)
-#include <sys/random.h>
-#elif defined(__APPLE__)
-#include <Security/Security.h>
-#endif
-
 /**
- * Fill a byte array with random data. Used for secp256k1 signing.
- * @param Data Byte array
- * @param Size Size of the byte array
- * @returns A boolean to indicate success or failure.
+ * Convert any response message body into the template object.
+ * @param MessageBody Body of the response.
+ * @param OutResponseObject Receives the fields that could be converted.
+ * @returns False if the body is not a JSON object or a field could not be converted, e.g. a malformed hash.
  */
-static bool FillRandom(uint8_t* Data, size_t Size) {
-#if defined(_WIN32)
-    NTSTATUS res = BCryptGenRandom(nullptr, Data, static_cast<ULONG>(Size), BCRYPT_USE_SYSTEM_PREFERRED_RNG);
-    return BCRYPT_SUCCESS(res) && Size <= ULONG_MAX;
-#elif defined(__linux__) || defined(__FreeBSD__)
-    sSize_t res = getrandom(Data, Size, 0);
-    return res >= 0 && static_cast<Size_t>(res) == Size;
-#elif defined(__APPLE__)
-    return SecRandomCopyBytes(kSecRandomDefault, Size, Data) == errSecSuccess;
-#endif
-    return false;
-}
+template<typename TResponseType>
+static bool TryParseResponse(const FString& MessageBody, TResponseType& OutResponseObject)
+{
+    TSharedPtr<FJsonObject> JsonObject;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(MessageBody);
 
-/**
- * Convert a character into its hex value. Used for sec256k1 signing.
- * @param Char Character to convert
- * @returns The hex value corresponding to the input
- */
-static int32 CharToHex(TCHAR Char) {
-    if (Char >= '0' && Char <= '9') return Char - '0';
-    if (Char >= 'a' && Char <= 'f') return 10 + Char - 'a';
-    if (Char >= 'A' && Char <= 'F') return 10 + Char - 'A';
-    return -1; // or handle invalid character
+    return FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid()
+        && FJsonObjectConverter::JsonObjectToUStruct(JsonObject.ToSharedRef(), TResponseType::StaticStruct(), &OutResponseObject, 0, 0);
 }
 
 /**
@@ -57,14 +39,7 @@ template<typename TResponseType>
 static TResponseType ParseResponse(const FString& MessageBody)
 {
     TResponseType ResponseObject;
-    TSharedPtr<FJsonObject> JsonObject;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(MessageBody);
-
-    if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
-    {
-        FJsonObjectConverter::JsonObjectToUStruct(JsonObject.ToSharedRef(), TResponseType::StaticStruct(), &ResponseObject, 0, 0);
-    }
-
+    TryParseResponse(MessageBody, ResponseObject);
     return ResponseObject;
 }
 
@@ -125,6 +100,47 @@ static FString BlockchainTypeToString(const EBlockchainType& BlockchainType) {
     }
 }
 
+/**
+ * Convert a BlockchainType enum value to its EIP-155 chain id. This is used to compute UserOperation hashes.
+ * @param BlockchainType Enum value of EBlockchainType.
+ * @returns The chain id of the blockchain, or 0 if it is unknown.
+ */
+static uint64 BlockchainTypeToChainId(const EBlockchainType& BlockchainType) {
+    switch(BlockchainType) {
+        case EBlockchainType::ETHEREUM:
+            return 1;
+        case EBlockchainType::GOERLI:
+            return 5;
+        case EBlockchainType::POLYGON:
+            return 137;
+        case EBlockchainType::MUMBAI:
+            return 80001;
+        case EBlockchainType::DFK:
+            return 53935;
+        case EBlockchainType::DFK_TESTNET:
+            return 335;
+        case EBlockchainType::AVALANCHE_CCHAIN:
+            return 43114;
+        case EBlockchainType::ARBITRUM:
+            return 42161;
+        case EBlockchainType::ARBITRUM_GOERLI:
+            return 421613;
+        case EBlockchainType::OPTIMISM:
+            return 10;
+        case EBlockchainType::OPTIMISM_GOERLI:
+            return 420;
+        case EBlockchainType::BASE:
+            return 8453;
+        case EBlockchainType::BASE_GOERLI:
+            return 84531;
+        case EBlockchainType::KLAYTN_CYPRESS:
+            return 8217;
+        default:
+            UE_LOG(LogTemp, Error, TEXT("invalid blockchain"));
+            return 0;
+    }
+}
+
 /**
  * Convert a TransactionType enum value to its equivalent string value that is used to form a URL.
  * @param TxType Enum value of ETransactionType
@@ -150,6 +166,9 @@ static FString TransactionTypeToString(const ETransactionType& TxType) {
 AHalliday::AHalliday() {
     // Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
    PrimaryActorTick.bCanEverTick = true;
+   
+   _RequestScheduler = MakeShared<FHallidayRequestScheduler, ESPMode::ThreadSafe>();
+   _Signer = MakeShared<FHallidaySigner, ESPMode::ThreadSafe>();
 }
 
 AWeb3Auth* AHalliday::GetWeb3Auth()
@@ -187,104 +206,335 @@ void AHalliday::SetInGamePlayerId(const FString& InGamePlayerId)
     _InGamePlayerId = InGamePlayerId;
 }
 
-FString AHalliday::_GetPublicKeyFromPrivateKey()
+void AHalliday::InvalidateCachedWallet(const FString& InGamePlayerId)
+{
+    _WalletCache.Remove(InGamePlayerId);
+}
+
+void AHalliday::ClearWalletCache()
+{
+    _WalletCache.Empty();
+}
+
+void AHalliday::_CacheWallet(const FString& InGamePlayerId, const FWallet& Wallet)
 {
-    // Convert the hex string to a byte array.
-    unsigned char SecretKey[32];
-    for (int32 i = 0; i < 32; ++i) {
-        // Convert each pair of hex characters to a byte
-        // Nibbles are a half byte. Low nibble is bits 0 through 3 and high nibble is bits 4 through 7.
-        TCHAR HighNibble = _PrivateKey[i * 2];
-        TCHAR LowNibble = _PrivateKey[i * 2 + 1];
-        SecretKey[i] = (CharToHex(HighNibble) << 4) + CharToHex(LowNibble);
+    // Key the wallet by the id it was requested for, whatever the backend echoed back.
+    FWallet CachedWallet = Wallet;
+    CachedWallet.in_game_player_id = InGamePlayerId;
+    _WalletCache.Add(CachedWallet);
+}
+
+FHallidayStats AHalliday::GetStats()
+{
+    FHallidayStats Stats = _Stats;
+    const FHallidayRequestSchedulerStats SchedulerStats = _RequestScheduler->GetStats();
+    Stats.QueuedRequests = SchedulerStats.NumQueued;
+    Stats.PeakQueuedRequests = SchedulerStats.PeakQueued;
+    Stats.RequestsInFlight = SchedulerStats.NumInFlight;
+    Stats.AverageQueueWaitSeconds = SchedulerStats.NumSent > 0 ? (float)(SchedulerStats.TotalWaitSeconds / SchedulerStats.NumSent) : 0.0f;
+    Stats.MaxQueueWaitSeconds = (float)SchedulerStats.MaxWaitSeconds;
+    Stats.RateLimitBackoffs = SchedulerStats.NumBackoffs;
+    Stats.RequeuedRequests = SchedulerStats.NumRequeued;
+    Stats.HedgedRequests = SchedulerStats.NumHedged;
+    Stats.HedgeWins = SchedulerStats.NumHedgeWins;
+    Stats.CancelledRequests = SchedulerStats.NumCancelled;
+    return Stats;
+}
+
+TSharedRef<IHttpRequest, ESPMode::ThreadSafe> AHalliday::_CreateRequest()
+{
+    _LastRequestTime.store(FPlatformTime::Seconds(), std::memory_order_relaxed);
+    return FHttpModule::Get().CreateRequest();
+}
+
+void AHalliday::_ProcessRequest(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request, EHallidayRequestPriority Priority, const FString& PlayerId, const TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe>& Operation, bool bCanHedge, bool bCanRequeue)
+{
+    _RequestScheduler->Enqueue(Request, Priority, PlayerId, Operation, bCanHedge, bCanRequeue);
+}
+
+void FHallidayRequestHandle::Cancel() const
+{
+    if (AHalliday* Halliday = Owner.Get()) {
+        Halliday->CancelRequest(*this);
+    }
+}
+
+void AHalliday::CancelRequest(const FHallidayRequestHandle& Handle)
+{
+    if (Handle.Owner.Get() != this) {
+        return;
     }
     
-    secp256k1_pubkey PublicKey;
-    
-    // Create a context for the secp256k1 library using 'SECP256K1_CONTEXT_NONE'.
-    // All other contexts in the library have been deprecated. This will allow for all functionality.
-    secp256k1_context* Ctx = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
-   
-    /* Randomizing the context is recommended to protect against side-channel
-     * leakage See `secp256k1_context_randomize` in secp256k1.h for more
-     * information about it. This should never fail. */
-    unsigned char Randomize[32];
-    if (!FillRandom(Randomize, sizeof(Randomize))) {
-        UE_LOG(LogTemp, Error, TEXT("Unexpected response when getting the public address of player '%s'."), *(_InGamePlayerId));
-        return "";
+    // A read call that shares its request only detaches from it, so that closing one widget does not starve the others waiting for the same data.
+    FString RequestKey;
+    if (_ReadRequestCalls.RemoveAndCopyValue(Handle.Id, RequestKey)) {
+        FHallidayReadRequest& ReadRequest = _InFlightReadRequests.FindChecked(RequestKey);
+        ReadRequest.CallIds.RemoveSingleSwap(Handle.Id);
+        if (ReadRequest.CallIds.Num() > 0) {
+            UE_LOG(LogTemp, Verbose, TEXT("[Halliday] Detached call %lld from a request that %d other calls still wait for."), Handle.Id, ReadRequest.CallIds.Num());
+            return;
+        }
+        
+        // Nobody is left waiting. Forget the request right away so that the next call sends a fresh one instead of attaching to the cancelled one.
+        const int64 OperationId = ReadRequest.OperationId;
+        _InFlightReadRequests.Remove(RequestKey);
+        _CancelOperation(OperationId);
+        return;
     }
-    if(secp256k1_context_randomize(Ctx, Randomize) != 1) {
-        UE_LOG(LogTemp, Error, TEXT("Failed to randomize the context for player '%s'."), *(_InGamePlayerId));
-        return "";
+    
+    _CancelOperation(Handle.Id);
+}
+
+void AHalliday::_CancelOperation(int64 OperationId)
+{
+    TWeakPtr<FHallidayOperation, ESPMode::ThreadSafe> WeakOperation;
+    if (!_Operations.RemoveAndCopyValue(OperationId, WeakOperation)) {
+        return;
     }
     
-    // Get the public key.
-    if(secp256k1_ec_pubkey_create(Ctx, &PublicKey, SecretKey) != 1) {
-        UE_LOG(LogTemp, Error, TEXT("Failed to generate the public key for player '%s'."), *(_InGamePlayerId));
-        return "";
+    if (TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> Operation = WeakOperation.Pin()) {
+        UE_LOG(LogTemp, Verbose, TEXT("[Halliday] Cancelling call %lld."), OperationId);
+        _RequestScheduler->Cancel(*Operation);
+    }
+}
+
+TSharedRef<FHallidayOperation, ESPMode::ThreadSafe> AHalliday::_BeginOperation(FHallidayRequestHandle& OutHandle)
+{
+    // Operations expire once their last request completes, so sweeping now and then keeps the map as small as the number of calls in flight.
+    if (_LastOperationId % 64 == 63) {
+        for (auto It = _Operations.CreateIterator(); It; ++It) {
+            if (!It.Value().IsValid()) {
+                It.RemoveCurrent();
+            }
+        }
     }
     
-    // Serialize the public key.
-    unsigned char PublicKeySerialized[65] = {0};
-    size_t Len = sizeof(PublicKeySerialized);
-    secp256k1_ec_pubkey_serialize(Ctx, PublicKeySerialized, &Len, &PublicKey, SECP256K1_EC_UNCOMPRESSED);
+    TSharedRef<FHallidayOperation, ESPMode::ThreadSafe> Operation = MakeShared<FHallidayOperation, ESPMode::ThreadSafe>(++_LastOperationId);
+    _Operations.Add(Operation->GetId(), Operation);
+    OutHandle.Id = Operation->GetId();
+    OutHandle.Owner = this;
+    return Operation;
+}
 
-    // Convert the byte array into a hex string. This will NOT have "0x" as a prefix.
-    FString PublicKeyHexString;
-    for (size_t i = 0; i < Len; ++i) {
-        PublicKeyHexString += FString::Printf(TEXT("%02x"), PublicKeySerialized[i]);
+void AHalliday::_CancelAllOperations()
+{
+    // Cancel the calls first so that the ones between two requests, e.g. while a transaction is being signed, do not send the next one.
+    for (const TPair<int64, TWeakPtr<FHallidayOperation, ESPMode::ThreadSafe>>& Pair : _Operations) {
+        if (TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> Operation = Pair.Value.Pin()) {
+            _RequestScheduler->Cancel(*Operation);
+        }
     }
+    _Operations.Empty();
+    _InFlightReadRequests.Empty();
+    _ReadRequestCalls.Empty();
     
-    // Clean up the context.
-    secp256k1_context_destroy(Ctx);
+    // Then the requests that belong to no call, e.g. warm-ups.
+    _RequestScheduler->CancelAll();
+}
+
+void AHalliday::_PrewarmConnection()
+{
+    // The response does not matter. The request only leaves a resolved, connected and TLS-established connection in the HTTP module's pool.
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = _CreateRequest();
+    Request->SetURL(_ApiEndpoint);
+    Request->SetVerb("HEAD");
+    Request->OnProcessRequestComplete().BindLambda([](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+        UE_LOG(LogTemp, Verbose, TEXT("[Halliday] Connection warm-up %s."), bWasSuccessful ? TEXT("succeeded") : TEXT("failed"));
+    });
+    _ProcessRequest(Request, EHallidayRequestPriority::Warmup, FString(), nullptr);
     
-    return PublicKeyHexString;
+    ++_Stats.ConnectionWarmups;
 }
 
-FString AHalliday::_Secp256k1(FString TxHash) {
-    unsigned char SecKey[32];
-    for (int32 i = 0; i < 32; ++i) {
-        // Convert each pair of hex characters to a byte
-        // Nibbles are a half byte. Low nibble is bits 0 through 3 and high nibble is bits 4 through 7.
-        TCHAR HighNibble = _PrivateKey[i * 2];
-        TCHAR LowNibble = _PrivateKey[i * 2 + 1];
-        SecKey[i] = (CharToHex(HighNibble) << 4) + CharToHex(LowNibble);
+void AHalliday::_RecordSubmitAttempts(int32 NumAttempts, double RetrySeconds, bool bWasSubmitted)
+{
+    _Stats.TransactionSubmitAttempts += NumAttempts;
+    _Stats.TransactionSubmitRetries += NumAttempts - 1;
+    _Stats.TransactionSubmitRetrySeconds += (float)RetrySeconds;
+    if (!bWasSubmitted) {
+        ++_Stats.FailedTransactionSubmits;
+    }
+}
+
+void AHalliday::_BroadcastWallet(const FWallet& Wallet)
+{
+    if (_Stats.TimeToFirstWalletSeconds < 0.0f && _InitializeTime > 0.0) {
+        _Stats.TimeToFirstWalletSeconds = (float)(FPlatformTime::Seconds() - _InitializeTime);
+        UE_LOG(LogTemp, Display, TEXT("[Halliday] Received the first wallet %.3f seconds after Initialize()."), _Stats.TimeToFirstWalletSeconds);
     }
     
-    // Create a secp256k1 context variable. This will be default enable us to sign and verify.
-    secp256k1_context* Ctx = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
-    secp256k1_ecdsa_recoverable_signature Signature;
+    OnWalletReceived.Broadcast(Wallet);
+}
+
+FString AHalliday::_MakeReadRequestKey(const TCHAR* Endpoint, const FString& Id) const
+{
+    return FString::Printf(TEXT("%s|%s|%s"), Endpoint, *Id, *BlockchainTypeToString(_BlockchainType));
+}
+
+TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> AHalliday::_BeginReadRequest(const FString& RequestKey, FHallidayRequestHandle& OutHandle)
+{
+    if (FHallidayReadRequest* ReadRequest = _InFlightReadRequests.Find(RequestKey))
+    {
+        ++_Stats.ReadRequestsCoalesced;
+        
+        // The call gets a handle of its own, so that it can be cancelled without cancelling the calls it shares the request with.
+        OutHandle.Id = ++_LastOperationId;
+        OutHandle.Owner = this;
+        ReadRequest->CallIds.Add(OutHandle.Id);
+        _ReadRequestCalls.Add(OutHandle.Id, RequestKey);
+        return nullptr;
+    }
     
-    // Convert the transaction hash into a byte array.
-    unsigned char MsgHash[32];
-    for(int32 i = 0; i < 32; ++i)
+    ++_Stats.ReadRequestsSent;
+    TSharedRef<FHallidayOperation, ESPMode::ThreadSafe> Operation = _BeginOperation(OutHandle);
+    FHallidayReadRequest& ReadRequest = _InFlightReadRequests.Add(RequestKey);
+    ReadRequest.OperationId = Operation->GetId();
+    ReadRequest.CallIds.Add(OutHandle.Id);
+    _ReadRequestCalls.Add(OutHandle.Id, RequestKey);
+    return Operation;
+}
+
+void AHalliday::_EndReadRequest(const FString& RequestKey, const FHallidayOperation& Operation)
+{
+    // A cancelled request may complete after a new request for the same key was sent.
+    const FHallidayReadRequest* ReadRequest = _InFlightReadRequests.Find(RequestKey);
+    if (ReadRequest == nullptr || ReadRequest->OperationId != Operation.GetId())
     {
-        TCHAR HighNibble = TxHash[2 + i * 2];
-        TCHAR LowNibble = TxHash[2 + i * 2 + 1];
-        MsgHash[i] = (CharToHex(HighNibble) << 4) + CharToHex(LowNibble);
+        return;
     }
     
-    // Get the recoverable signature.
-    secp256k1_ecdsa_sign_recoverable(Ctx, &Signature, MsgHash, SecKey, NULL, NULL);
+    for (const int64 CallId : ReadRequest->CallIds)
+    {
+        _ReadRequestCalls.Remove(CallId);
+    }
+    _InFlightReadRequests.Remove(RequestKey);
+}
+
+FString AHalliday::_GetPublicKeyFromPrivateKey()
+{
+    FString PublicKeyHex;
+    if (!_Signer->GetPublicKeyHex(PublicKeyHex)) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Cannot get the public key of player '%s' because no player is logged in."), *(_InGamePlayerId));
+        return "";
+    }
     
-    // Serialize the recoverable signature into a compact signature.
-    unsigned char SerializedSignature[65] = {0};
-    int RecoveryId = 0;
-    secp256k1_ecdsa_recoverable_signature_serialize_compact(Ctx, SerializedSignature, &RecoveryId, &Signature);
+    return PublicKeyHex;
+}
+
+FString AHalliday::_GetSignerAddress()
+{
+    FHallidayAddress SignerAddress;
+    if (!_Signer->GetSignerAddress(SignerAddress)) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Cannot get the signer address of player '%s' because no player is logged in."), *(_InGamePlayerId));
+        return "";
+    }
     
-    // Set the v component of the signature using the recovery id given by the serialize function.
-    SerializedSignature[64] = (uint8)(27 + RecoveryId);
+    return SignerAddress.ToString();
+}
+
+bool AHalliday::_SignHash(const FHallidayHash32& Hash, FHallidaySignature& OutSignature) {
+    return _Signer->SignHash(Hash, bVerifySignatureBeforeSubmit, OutSignature);
+}
+
+TSharedRef<FHallidaySigner, ESPMode::ThreadSafe> AHalliday::_GetSigner() const {
+    return _Signer.ToSharedRef();
+}
+
+FString AHalliday::_Secp256k1(FString TxHash) {
+    // Convert the transaction hash into a byte array.
+    FHallidayHash32 Hash;
+    if (!FHallidayHash32::FromString(TxHash, Hash)) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Cannot sign '%s' because it is not a 32 byte hex hash."), *TxHash);
+        return "";
+    }
+    
+    FHallidaySignature Signature;
+    if (!_SignHash(Hash, Signature)) {
+        return "";
+    }
     
     // Convert the byte array to a hex string.
-    FString SignatureAsHexString = "0x";
-    for (int i = 0; i < 65; ++i) {
-        SignatureAsHexString += FString::Printf(TEXT("%02x"), SerializedSignature[i]);
+    return Signature.ToString();
+}
+
+int32 AHalliday::AddSigningKey(const FString& PrivateKeyHex)
+{
+    return _Signer->AddKey(PrivateKeyHex);
+}
+
+void AHalliday::RemoveSigningKey(int32 KeyHandle)
+{
+    _Signer->RemoveKey(KeyHandle);
+}
+
+bool AHalliday::SignBatch(const TArray<FHallidaySignRequest>& Requests, TArray<uint8>& OutSignatures)
+{
+    int32 NumWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    if (MaxBatchSigningWorkers > 0) {
+        NumWorkers = FMath::Min(NumWorkers, MaxBatchSigningWorkers);
+    }
+    return _Signer->SignBatch(Requests, NumWorkers, OutSignatures);
+}
+
+FString AHalliday::SignPersonalMessage(const FString& Message)
+{
+    const FTCHARToUTF8 MessageUtf8(*Message);
+    
+    FHallidayHash32 Hash;
+    FHallidayEip712::HashPersonalMessage((const uint8*)MessageUtf8.Get(), MessageUtf8.Length(), Hash);
+    
+    FHallidaySignature Signature;
+    if (!_SignHash(Hash, Signature)) {
+        return "";
+    }
+    return Signature.ToString();
+}
+
+int32 AHalliday::RegisterTypedDataType(const FString& EncodedType, const FHallidayEip712Domain& Domain)
+{
+    FHallidayEip712Schema Schema;
+    if (!FHallidayEip712Type::Parse(EncodedType, Schema.Type)) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] '%s' is not a supported EIP-712 type."), *EncodedType);
+        return INDEX_NONE;
+    }
+    if (!FHallidayEip712Type::HashDomain(Domain, Schema.DomainSeparator)) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] The EIP-712 domain '%s' has a malformed verifying contract or salt."), *Domain.Name);
+        return INDEX_NONE;
+    }
+    
+    const FString Key = Schema.Type.GetEncodedType() + TEXT("|") + Schema.DomainSeparator.ToString();
+    if (const int32* ExistingHandle = _TypedDataSchemaHandles.Find(Key)) {
+        return *ExistingHandle;
+    }
+    
+    const int32 TypeHandle = _TypedDataSchemas.Add(MoveTemp(Schema));
+    _TypedDataSchemaHandles.Add(Key, TypeHandle);
+    return TypeHandle;
+}
+
+FString AHalliday::SignTypedData(int32 TypeHandle, const TArray<FString>& Values)
+{
+    if (!_TypedDataSchemas.IsValidIndex(TypeHandle)) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] %d is not a handle returned by RegisterTypedDataType()."), TypeHandle);
+        return "";
+    }
+    
+    // The type hash and domain separator are cached, so only the values and the final digest are hashed here.
+    const FHallidayEip712Schema& Schema = _TypedDataSchemas[TypeHandle];
+    FHallidayHash32 StructHash;
+    if (!Schema.Type.HashStruct(Values, StructHash)) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] The values do not match the EIP-712 type '%s'."), *Schema.Type.GetEncodedType());
+        return "";
     }
     
-    // Clean up the context varaible.
-    secp256k1_context_destroy(Ctx);
+    FHallidayHash32 Hash;
+    FHallidayEip712::HashTypedData(Schema.DomainSeparator, StructHash, Hash);
     
-    return SignatureAsHexString;
+    FHallidaySignature Signature;
+    if (!_SignHash(Hash, Signature)) {
+        return "";
+    }
+    return Signature.ToString();
 }
 
 void AHalliday::Initialize(const FString& PublicApiKey, EBlockchainType BlockchainType, bool bIsSandbox, const FString& ClientVerifierId) {
@@ -317,6 +567,22 @@ void AHalliday::Initialize(const FString& PublicApiKey, EBlockchainType Blockcha
     {
         _ApiEndpoint = TEXT("https://api.halliday.xyz/v1/");
     }
+    
+    _RequestScheduler->SetMaxInFlight(MaxRequestsInFlight);
+    
+    // Idle time is counted from here, so a disabled warm-up is not made up for on the first Tick().
+    _InitializeTime = FPlatformTime::Seconds();
+    _LastRequestTime.store(_InitializeTime, std::memory_order_relaxed);
+    if (bPrewarmConnection) {
+        _PrewarmConnection();
+    }
+    
+    // Wallets belong to the app of the API key and differ between sandbox and production, so each key and environment has its own cache.
+    // Only a hash of the key goes into the file name, so that the key itself is not written to disk.
+    const FTCHARToUTF8 PublicApiKeyUtf8(*PublicApiKey);
+    const uint64 ApiKeyHash = CityHash64(PublicApiKeyUtf8.Get(), PublicApiKeyUtf8.Length());
+    const FString WalletCacheFileName = FString::Printf(TEXT("%sWallets-%016llx.json"), bIsSandbox ? TEXT("Sandbox") : TEXT(""), ApiKeyHash);
+    _WalletCache.Load(FPaths::ProjectSavedDir() / TEXT("Halliday") / WalletCacheFileName);
 }
 
 /**
@@ -385,19 +651,28 @@ void AHalliday::SetLogoutCompletedCallback(FOnLogoutCompleted Callback) {
 
 void AHalliday::_HandleLogin(FWeb3AuthResponse response) {
     // Store the user informaton that Web3 Auth returns.
-    _PrivateKey = response.privKey;
     _UserInfo = response.userInfo;
     
+    // Create the secp256k1 context pool once so that every signature can reuse it.
+    // Then decode the private key once so that signing never touches the hex string again.
+    _Signer->SetRandomizeInterval(Secp256k1RandomizeInterval);
+    if (_Signer->CreateContextPool()) {
+        _Signer->LoadPlayerKey(response.privKey);
+    }
+    
     // Execute the callback that was previously passed in.
     // This uses the main game thread so this must complete before moving forward.
-    AsyncTask(ENamedThreads::GameThread, [this]() {
-        OnLoginCompleted.ExecuteIfBound();
+    AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<AHalliday>(this)]() {
+        if (WeakThis.IsValid()) {
+            WeakThis->OnLoginCompleted.ExecuteIfBound();
+        }
     });
 }
 
 void AHalliday::_HandleLogout() {
     // Clear important user information.
-    _PrivateKey = TEXT(""); // IMPORTANT! DO NOT REMOVE!
+    // The context pool holds no key material so it is kept for the next login and for batch signing keys.
+    _Signer->ClearPlayerKey();
     _UserInfo.email = TEXT("");
     _UserInfo.name = TEXT("");
     _UserInfo.profileImage = TEXT("");
@@ -411,39 +686,46 @@ void AHalliday::_HandleLogout() {
     _UserInfo.oAuthAccessToken = TEXT("");
     
     // Execute the callback event that was previous set.
-    AsyncTask(ENamedThreads::GameThread, [this]() {
-        OnLogoutCompleted.ExecuteIfBound();
+    AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<AHalliday>(this)]() {
+        if (!WeakThis.IsValid()) {
+            return;
+        }
+        
+        // Cached assets and balances belong to the player that logged out.
+        WeakThis->_AssetsCache.Empty();
+        WeakThis->_BalancesCache.Empty();
+        WeakThis->OnLogoutCompleted.ExecuteIfBound();
     });
 }
 
 /**
- * This function will call GetOrCreateHallidayAAWallet() again and you will receive a response through the FOnWalletReceived delegate.
+ * This function will fetch the wallet again as part of the same call and you will receive a response through the FOnWalletReceived delegate.
  * INTERNAL FLOW:
  * 1. GetOrCreateHallidayAAWalletResponse
  * 2. _HandleGetOrCreateHallidayAAWalletResponse
  * 3. _GetSignerPublicAddress
- * 4. _HandleGetSignerPublicAddressResponse
- * 5. _CreateWallet
- * 6. _HandleCreateWalletResponse [Current Step]
- * 7. GetOrCreateHallidayAAWalletResponse
+ * 4. _CreateWallet
+ * 5. _HandleCreateWalletResponse [Current Step]
+ * 6. GetOrCreateHallidayAAWalletResponse
  *
  * @param Request Request sent from _CreateWallet().
  * @param Response Response from the request sent from _CreateWallet().
  * @param bWasSuccessful Indicates the success of the request.
  * @param Halliday Pointer to the object that called GetOrCreateHallidayAAWallet().
  * @param InGamePlayerId Id of the player to create a wallet for.
+ * @param Operation Call of GetOrCreateHallidayAAWallet() that created the wallet.
  */
-void _HandleCreateWalletResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& InGamePlayerId)
+void _HandleCreateWalletResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& InGamePlayerId, const TSharedRef<FHallidayOperation, ESPMode::ThreadSafe>& Operation)
 {
     if (bWasSuccessful && Response->GetResponseCode() == 200)
     {
-        // Now that the wallet was succssfuly created, call GetOrCreateHallidayAAWallet again.
+        // Now that the wallet was succssfuly created, fetch it again as part of the same call.
         // This time pass in bWasPreviouslyCalled = true in order to prevent an infinite loop.
-        Halliday->GetOrCreateHallidayAAWallet(InGamePlayerId, true);
+        Halliday->_GetOrCreateWallet(InGamePlayerId, true, Operation);
     }
     else
     {
-        FString ResponseError = Response->GetContentAsString();
+        FString ResponseError = Response.IsValid() ? Response->GetContentAsString() : FString();
         UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to create a wallet for player '%s' because '%s'."), *InGamePlayerId, *ResponseError);
     }
 }
@@ -454,28 +736,31 @@ void _HandleCreateWalletResponse(FHttpRequestPtr Request, FHttpResponsePtr Respo
  * 1. GetOrCreateHallidayAAWalletResponse
  * 2. _HandleGetOrCreateHallidayAAWalletResponse
  * 3. _GetSignerPublicAddress
- * 4. _HandleGetSignerPublicAddressResponse
- * 5. _CreateWallet [Current Step]
- * 6. _HandleCreateWalletResponse
- * 7. GetOrCreateHallidayAAWalletResponse
+ * 4. _CreateWallet [Current Step]
+ * 5. _HandleCreateWalletResponse
+ * 6. GetOrCreateHallidayAAWalletResponse
  *
  * @param Halliday Pointer to the object that called GetOrCreateHallidayAAWallet().
  * @param InGamePlayerId Id of the player to create a wallet for.
- * @param SignerPublicAddress Public address of the private key from Web3Auth formatted as a hexstring WITHOUT "0x" as the prefix.
+ * @param SignerPublicAddress Public address of the private key from Web3Auth formatted as an EIP-55 checksummed hex string with "0x" as the prefix.
+ * @param Operation Call of GetOrCreateHallidayAAWallet() that the wallet is created for.
  */
-void _CreateWallet(AHalliday* Halliday, const FString& InGamePlayerId, const FString& SignerPublicAddress)
+void _CreateWallet(AHalliday* Halliday, const FString& InGamePlayerId, const FString& SignerPublicAddress, const TSharedRef<FHallidayOperation, ESPMode::ThreadSafe>& Operation)
 {
     FString NewAccountUrl = Halliday->GetApiEndpoint() + TEXT("client/accounts");
 
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Halliday->_CreateRequest();
     Request->SetURL(NewAccountUrl);
     Request->SetVerb("POST");
     Request->SetHeader(TEXT("Authorization"), Halliday->GetAuthHeaderValue());
     Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
     
     // Bind a callback function to handle the response.
-    Request->OnProcessRequestComplete().BindLambda([Halliday, InGamePlayerId](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-       _HandleCreateWalletResponse(Request, Response, bWasSuccessful, Halliday, InGamePlayerId);
+    // The actor may be destroyed or the call cancelled while the request is in flight.
+    Request->OnProcessRequestComplete().BindLambda([WeakHalliday = TWeakObjectPtr<AHalliday>(Halliday), InGamePlayerId, Operation](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+       if (WeakHalliday.IsValid() && !Operation->IsCancelled()) {
+           _HandleCreateWalletResponse(Request, Response, bWasSuccessful, WeakHalliday.Get(), InGamePlayerId, Operation);
+       }
     });
 
     // Create the request body as JSON
@@ -490,77 +775,37 @@ void _CreateWallet(AHalliday* Halliday, const FString& InGamePlayerId, const FSt
     FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
 
     Request->SetContentAsString(RequestBodyAsString);
-    Request->ProcessRequest();
+    Halliday->_ProcessRequest(Request, EHallidayRequestPriority::Wallet, InGamePlayerId, Operation);
 }
 
 /**
- * This function will parse the non-custodial wallet address aka owner's public address and pass it to _CreateWallet().
- * INTERNAL FLOW:
+ * Derives the public address of the signer locally from the public key cached at login and passes it to _CreateWallet(). This function assumes that the user is logged in.
+ * This call is necessary for _CreateWallet() to work.
+ * * INTERNAL FLOW:
  * 1. GetOrCreateHallidayAAWalletResponse
  * 2. _HandleGetOrCreateHallidayAAWalletResponse
- * 3. _GetSignerPublicAddress
- * 4. _HandleGetSignerPublicAddressResponse [Current Step]
- * 5. _CreateWallet
- * 6. _HandleCreateWalletResponse
- * 7. GetOrCreateHallidayAAWalletResponse
+ * 3. _GetSignerPublicAddress [Current Step]
+ * 4. _CreateWallet
+ * 5. _HandleCreateWalletResponse
+ * 6. GetOrCreateHallidayAAWalletResponse
  *
- * @param Request Request sent from _GetSignerPublicAddress().
- * @param Response Response from the request sent from _GetSignerPublicAddress().
- * @param bWasSuccessful Indicates the success of the request.
  * @param Halliday Pointer to the object that called GetOrCreateHallidayAAWallet().
  * @param InGamePlayerId Id of the player to create a wallet for.
+ * @param Operation Call of GetOrCreateHallidayAAWallet() that the wallet is created for.
  */
-void _HandleGetSignerPublicAddressResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& InGamePlayerId)
+void _GetSignerPublicAddress(AHalliday* Halliday, const FString& InGamePlayerId, const TSharedRef<FHallidayOperation, ESPMode::ThreadSafe>& Operation)
 {
-    if (bWasSuccessful && Response->GetResponseCode() == 200)
-    {
-        FString MessageBody = Response->GetContentAsString();
-        FGetSignerPublicAddressResponse GetSignerPublicAddressResponse = ParseResponse<FGetSignerPublicAddressResponse>(MessageBody);
-
-        // Create a new wallet after obtaining the address of the public key.
-        // The wallet address created with this function will NOT by the address of the public key.
-        _CreateWallet(Halliday, InGamePlayerId, GetSignerPublicAddressResponse.address);
-    }
-    else
+    FString SignerPublicAddress = Halliday->_GetSignerAddress();
+    if (SignerPublicAddress.IsEmpty())
     {
         // Account owner means the owner or non-custodial public address. NOT the address where the user stores their assets.
         UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to get the public wallet address of the account owner."));
+        return;
     }
-}
-
-/**
- * Calls the Halliday backend to get the public address from the public key. This function assumes that the private key in Halliday* has been set and that the user is logged in.
- * This call is necessary for _CreateWallet() to work.
- * * INTERNAL FLOW:
- * 1. GetOrCreateHallidayAAWalletResponse
- * 2. _HandleGetOrCreateHallidayAAWalletResponse
- * 3. _GetSignerPublicAddress [Current Step]
- * 4. _HandleGetSignerPublicAddressResponse
- * 5. _CreateWallet
- * 6. _HandleCreateWalletResponse
- * 7. GetOrCreateHallidayAAWalletResponse
- *
- * @param Halliday Pointer to the object that called GetOrCreateHallidayAAWallet().
- * @param InGamePlayerId Id of the player to create a wallet for.
- */
-void _GetSignerPublicAddress(AHalliday* Halliday, const FString& InGamePlayerId)
-{
-    FString PublicKey = Halliday->_GetPublicKeyFromPrivateKey();
-    
-    // Call Halliday backend to retrieve the public address corresponding to this key.
-    FString GetPublicAddressUrl = Halliday->GetApiEndpoint() + TEXT("client/getAddressFromPublicKey?public_key=") + PublicKey;
-    
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(GetPublicAddressUrl);
-    Request->SetVerb("GET");
-    Request->SetHeader("Authorization", Halliday->GetAuthHeaderValue());
-    
-    // Bind a callback function to handle the response.
-    Request->OnProcessRequestComplete().BindLambda([Halliday, InGamePlayerId](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-       _HandleGetSignerPublicAddressResponse(Request, Response, bWasSuccessful, Halliday, InGamePlayerId);
-    });
     
-    Request->ProcessRequest();
+    // Create a new wallet after obtaining the address of the public key.
+    // The wallet address created with this function will NOT by the address of the public key.
+    _CreateWallet(Halliday, InGamePlayerId, SignerPublicAddress, Operation);
 }
 
 /**
@@ -569,19 +814,19 @@ void _GetSignerPublicAddress(AHalliday* Halliday, const FString& InGamePlayerId)
  * 1. GetOrCreateHallidayAAWalletResponse
  * 2. _HandleGetOrCreateHallidayAAWalletResponse [Current Step]
  * 3. _GetSignerPublicAddress
- * 4. _HandleGetSignerPublicAddressResponse
- * 5. _CreateWallet
- * 6. _HandleCreateWalletResponse
- * 7. GetOrCreateHallidayAAWalletResponse
+ * 4. _CreateWallet
+ * 5. _HandleCreateWalletResponse
+ * 6. GetOrCreateHallidayAAWalletResponse
  *
- * @param Request Request sent from _GetSignerPublicAddress().
- * @param Response Response from the request sent from _GetSignerPublicAddress().
+ * @param Request Request sent from GetOrCreateHallidayAAWallet().
+ * @param Response Response from the request sent from GetOrCreateHallidayAAWallet().
  * @param bWasSuccessful Indicates the success of the request.
  * @param Halliday Pointer to the object that called GetOrCreateHallidayAAWallet().
  * @param InGamePlayerId Id of the player to create a wallet for.
  * @param bWasPreviouslyCalled Indicates whether we should try to create a wallet again if not found.
+ * @param Operation Call of GetOrCreateHallidayAAWallet() that the request was sent for.
  */
-void _HandleGetOrCreateHallidayAAWalletResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& InGamePlayerId, bool bWasPreviouslyCalled) {
+void _HandleGetOrCreateHallidayAAWalletResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& InGamePlayerId, bool bWasPreviouslyCalled, const TSharedRef<FHallidayOperation, ESPMode::ThreadSafe>& Operation) {
     if (bWasSuccessful && Response->GetResponseCode() == 200)
     {
         FString MessageBody = Response->GetContentAsString();
@@ -594,8 +839,11 @@ void _HandleGetOrCreateHallidayAAWalletResponse(FHttpRequestPtr Request, FHttpRe
             {
                 UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Fetched wallet for player '%s': %s"), *InGamePlayerId, *(ObjectToString<FWallet>(Wallet)));
                 
+                // The address never changes, so the next call for this player does not need a request.
+                Halliday->_CacheWallet(InGamePlayerId, Wallet);
+                
                 // Broadcast the wallet data.
-                Halliday->OnWalletReceived.Broadcast(Wallet);
+                Halliday->_BroadcastWallet(Wallet);
                 bIsWalletFound = true;
                 break; // Break the loop if the desired wallet is found.
             }
@@ -604,11 +852,11 @@ void _HandleGetOrCreateHallidayAAWalletResponse(FHttpRequestPtr Request, FHttpRe
         // If there was no wallet on the blockchain you desired, we will create one.
         // The first step in wallet creation is to get the non-custodial wallet address.
         if(!bIsWalletFound) {
-            _GetSignerPublicAddress(Halliday, InGamePlayerId);
+            _GetSignerPublicAddress(Halliday, InGamePlayerId, Operation);
         }
     } else
     {
-        FString ResponseError = Response->GetContentAsString();
+        FString ResponseError = Response.IsValid() ? Response->GetContentAsString() : FString();
         if(!bWasPreviouslyCalled)
         {
             TSharedPtr<FJsonObject> JsonObject;
@@ -621,7 +869,7 @@ void _HandleGetOrCreateHallidayAAWalletResponse(FHttpRequestPtr Request, FHttpRe
                 {
                     // Create a wallet if there is no account associated with this player id.
                     // The first step in wallet creation is to get the non-custodial wallet address.
-                    _GetSignerPublicAddress(Halliday, InGamePlayerId);
+                    _GetSignerPublicAddress(Halliday, InGamePlayerId, Operation);
                 }
             }
         } else {
@@ -630,23 +878,96 @@ void _HandleGetOrCreateHallidayAAWalletResponse(FHttpRequestPtr Request, FHttpRe
     }
 }
 
-void AHalliday::GetOrCreateHallidayAAWallet(const FString& InGamePlayerId, bool bWasPreviouslyCalled) {
+FHallidayRequestHandle AHalliday::GetOrCreateHallidayAAWallet(const FString& InGamePlayerId, bool bWasPreviouslyCalled) {
     // Save the InGamePlayerId
     _InGamePlayerId = InGamePlayerId;
     
+    // Returning players get their wallet within the same frame without any network I/O.
+    FWallet CachedWallet;
+    if (_WalletCache.Find(InGamePlayerId, _BlockchainType, CachedWallet)) {
+        ++_Stats.WalletCacheHits;
+        UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Fetched cached wallet for player '%s': %s"), *InGamePlayerId, *(ObjectToString<FWallet>(CachedWallet)));
+        _BroadcastWallet(CachedWallet);
+        return FHallidayRequestHandle();
+    }
+    ++_Stats.WalletCacheMisses;
+    
+    FHallidayRequestHandle Handle;
+    _GetOrCreateWallet(InGamePlayerId, bWasPreviouslyCalled, _BeginOperation(Handle));
+    return Handle;
+}
+
+void AHalliday::_GetOrCreateWallet(const FString& InGamePlayerId, bool bWasPreviouslyCalled, const TSharedRef<FHallidayOperation, ESPMode::ThreadSafe>& Operation) {
     FString GetPlayerWalletsUrl = _ApiEndpoint + TEXT("client/accounts/") + InGamePlayerId + TEXT("/wallets");
     
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = _CreateRequest();
     Request->SetURL(GetPlayerWalletsUrl);
     Request->SetVerb("GET");
     Request->SetHeader("Authorization", _AuthHeaderValue);
     
     // Bind a callback function to handle the response from the Halliday backend server.
-    Request->OnProcessRequestComplete().BindLambda([this, InGamePlayerId, bWasPreviouslyCalled](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-       _HandleGetOrCreateHallidayAAWalletResponse(Request, Response, bWasSuccessful, this, InGamePlayerId, bWasPreviouslyCalled);
+    // The actor may be destroyed or the call cancelled while the request is in flight.
+    Request->OnProcessRequestComplete().BindLambda([WeakThis = TWeakObjectPtr<AHalliday>(this), InGamePlayerId, bWasPreviouslyCalled, Operation](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+       if (WeakThis.IsValid() && !Operation->IsCancelled()) {
+           _HandleGetOrCreateHallidayAAWalletResponse(Request, Response, bWasSuccessful, WeakThis.Get(), InGamePlayerId, bWasPreviouslyCalled, Operation);
+       }
     });
 
-    Request->ProcessRequest();
+    _ProcessRequest(Request, EHallidayRequestPriority::Wallet, InGamePlayerId, Operation);
+}
+
+/**
+ * Check the response of a cached read call against the cached response and store it if the data changed.
+ * @param Response Response from the Halliday backend.
+ * @param bWasSuccessful Indicates the success of the request.
+ * @param Cache Cache of the read call.
+ * @param RequestKey Key of the read call.
+ * @param Stats Counters to update.
+ * @returns The new response if it must be broadcast, or nullptr if the request failed or the data did not change.
+ */
+template<typename TResponseType>
+static const TResponseType* UpdateCachedResponse(FHttpResponsePtr Response, bool bWasSuccessful, THallidayResponseCache<TResponseType>& Cache, const FString& RequestKey, FHallidayStats& Stats)
+{
+    if (!bWasSuccessful || !Response.IsValid())
+    {
+        return nullptr;
+    }
+    
+    const int32 ResponseCode = Response->GetResponseCode();
+    if (ResponseCode != 200 && ResponseCode != 304)
+    {
+        return nullptr;
+    }
+    
+    // Hash the raw body so that unchanged data is neither parsed nor broadcast again.
+    // Inventories are large and compress well, so they are requested with Accept-Encoding and decoded here.
+    TArray<uint8> DecodedContent;
+    bool bWasDecoded = false;
+    const TArray<uint8>* Content = FHallidayHttpCompression::GetContent(*Response, DecodedContent, bWasDecoded);
+    Stats.ResponseBytesReceived += Response->GetContent().Num();
+    if (Content == nullptr)
+    {
+        return nullptr;
+    }
+    Stats.ResponseBytesDecoded += Content->Num();
+    if (bWasDecoded)
+    {
+        ++Stats.CompressedResponses;
+    }
+    
+    const uint64 ContentHash = CityHash64((const char*)Content->GetData(), Content->Num());
+    if (Cache.Revalidate(RequestKey, ResponseCode == 304, ContentHash))
+    {
+        ++Stats.ReadRevalidationsUnchanged;
+        return nullptr;
+    }
+    if (ResponseCode == 304)
+    {
+        // Nothing cached to fall back on, e.g. because the cache was cleared while the request was in flight.
+        return nullptr;
+    }
+    
+    return &Cache.Store(RequestKey, ParseResponse<TResponseType>(FHallidayHttpCompression::ToString(*Content)), Response->GetHeader(TEXT("ETag")), ContentHash);
 }
 
 /**
@@ -656,87 +977,169 @@ void AHalliday::GetOrCreateHallidayAAWallet(const FString& InGamePlayerId, bool
  * @param bWasSuccessful Indicates the success of the request.
  * @param Halliday Pointer to the object that called GetAssets().
  * @param InGamePlayerId Id of the player who owns the assets.
+ * @param GetAssetsResponse The new assets, or nullptr if the request failed or the assets did not change.
  */
-void _HandleGetAssetsResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& InGamePlayerId)
+void _HandleGetAssetsResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& InGamePlayerId, const FGetAssetsResponse* GetAssetsResponse)
 {
-    if (bWasSuccessful && Response->GetResponseCode() == 200)
+    if (GetAssetsResponse)
     {
-        // Convert the response body.
-        FString MessageBody = Response->GetContentAsString();
-        FGetAssetsResponse GetAssetsResponse = ParseResponse<FGetAssetsResponse>(MessageBody);
-        
         // Broadcast the wallet data.
-        Halliday->OnAssetsReceived.Broadcast(GetAssetsResponse);
+        Halliday->OnAssetsReceived.Broadcast(*GetAssetsResponse);
         
-        UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Fetched assets for player '%s': %s"), *InGamePlayerId, *(ObjectToString(GetAssetsResponse)));
+        UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Fetched assets for player '%s': %s"), *InGamePlayerId, *(ObjectToString(*GetAssetsResponse)));
+    }
+    else if (bWasSuccessful && Response.IsValid() && (Response->GetResponseCode() == 200 || Response->GetResponseCode() == 304))
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("[Halliday Response] Assets of player '%s' did not change."), *InGamePlayerId);
     }
     else
     {
-        FString ResponseError = Response->GetContentAsString();
+        FString ResponseError = Response.IsValid() ? FHallidayHttpCompression::GetContentAsString(*Response) : FString();
         UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to call GetAssets() for player '%s' because '%s'."), *InGamePlayerId, *ResponseError);
     }
 }
 
-void AHalliday::GetAssets(const FString& InGamePlayerId)
+FHallidayRequestHandle AHalliday::GetAssets(const FString& InGamePlayerId)
 {
+    // Deliver the cached assets right away and only revalidate them once they are older than AssetsCacheTtlSeconds.
+    FString RequestKey = _MakeReadRequestKey(TEXT("assets"), InGamePlayerId);
+    if (const FGetAssetsResponse* CachedAssets = _AssetsCache.Find(RequestKey))
+    {
+        ++_Stats.ReadCacheHits;
+        OnAssetsReceived.Broadcast(*CachedAssets);
+        if (_AssetsCache.IsFresh(RequestKey, AssetsCacheTtlSeconds))
+        {
+            return FHallidayRequestHandle();
+        }
+    }
+    
+    // Widgets that ask for the same player in the same frame share one request, but each gets a handle of its own.
+    FHallidayRequestHandle Handle;
+    TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> Operation = _BeginReadRequest(RequestKey, Handle);
+    if (!Operation.IsValid())
+    {
+        return Handle;
+    }
+    
     FString GetPlayerAssetsUrl = _ApiEndpoint + TEXT("client/accounts/") + InGamePlayerId + TEXT("/assets");
     
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = _CreateRequest();
     Request->SetURL(GetPlayerAssetsUrl);
     Request->SetVerb("GET");
     Request->SetHeader("Authorization", _AuthHeaderValue);
+    Request->SetHeader(TEXT("Accept-Encoding"), FHallidayHttpCompression::AcceptEncoding);
+    
+    FString ETag = _AssetsCache.GetETag(RequestKey);
+    if (!ETag.IsEmpty())
+    {
+        Request->SetHeader(TEXT("If-None-Match"), ETag);
+    }
     
     // Bind a callback to process the HTTP response
-    Request->OnProcessRequestComplete().BindLambda([this, InGamePlayerId](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-       _HandleGetAssetsResponse(Request, Response, bWasSuccessful, this, InGamePlayerId);
+    // The actor may be destroyed or the call cancelled while the request is in flight.
+    Request->OnProcessRequestComplete().BindLambda([WeakThis = TWeakObjectPtr<AHalliday>(this), InGamePlayerId, RequestKey, Operation](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+       if (!WeakThis.IsValid()) {
+           return;
+       }
+       
+       AHalliday* Halliday = WeakThis.Get();
+       Halliday->_EndReadRequest(RequestKey, *Operation);
+       if (Operation->IsCancelled()) {
+           return;
+       }
+       
+       const FGetAssetsResponse* GetAssetsResponse = UpdateCachedResponse(Response, bWasSuccessful, Halliday->_AssetsCache, RequestKey, Halliday->_Stats);
+       _HandleGetAssetsResponse(Request, Response, bWasSuccessful, Halliday, InGamePlayerId, GetAssetsResponse);
     });
     
-    Request->ProcessRequest();
+    _ProcessRequest(Request, EHallidayRequestPriority::Assets, InGamePlayerId, Operation, true);
+    return Handle;
 }
 
 /**
  * Asynchronous callback function to trigger a delegate broadcast once the HTTP request in GetBalances() is complete.
- * @param Request Request sent from GetAssets().
- * @param Response Response from the request sent from GetAssets().
+ * @param Request Request sent from GetBalances().
+ * @param Response Response from the request sent from GetBalances().
  * @param bWasSuccessful Indicates the success of the request.
- * @param Halliday Pointer to the object that called GetAssets().
- * @param InGamePlayerId Id of the player who owns the assets.
+ * @param Halliday Pointer to the object that called GetBalances().
+ * @param InGamePlayerId Id of the player who owns the balances.
+ * @param GetBalancesResponse The new balances, or nullptr if the request failed or the balances did not change.
  */
-void _HandleGetBalancesResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& InGamePlayerId)
+void _HandleGetBalancesResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& InGamePlayerId, const FGetBalancesResponse* GetBalancesResponse)
 {
-    if (bWasSuccessful && Response->GetResponseCode() == 200)
+    if (GetBalancesResponse)
     {
-        // Convert the response body.
-        FString MessageBody = Response->GetContentAsString();
-        FGetBalancesResponse GetBalancesResponse = ParseResponse<FGetBalancesResponse>(MessageBody);
-        
         // Broadcast the wallet data. The client should bind a callback to the delegate to receive this response.
-        Halliday->OnBalancesReceived.Broadcast(GetBalancesResponse);
+        Halliday->OnBalancesReceived.Broadcast(*GetBalancesResponse);
         
-        UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Fetched balances for player '%s': %s"), *InGamePlayerId, *(ObjectToString(GetBalancesResponse)));
+        UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Fetched balances for player '%s': %s"), *InGamePlayerId, *(ObjectToString(*GetBalancesResponse)));
+    }
+    else if (bWasSuccessful && Response.IsValid() && (Response->GetResponseCode() == 200 || Response->GetResponseCode() == 304))
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("[Halliday Response] Balances of player '%s' did not change."), *InGamePlayerId);
     }
     else
     {
-        FString ResponseError = Response->GetContentAsString();
+        FString ResponseError = Response.IsValid() ? FHallidayHttpCompression::GetContentAsString(*Response) : FString();
         UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to call GetBalances() for player '%s' because '%s'."), *InGamePlayerId, *ResponseError);
     }
 }
 
-void AHalliday::GetBalances(const FString& InGamePlayerId)
+FHallidayRequestHandle AHalliday::GetBalances(const FString& InGamePlayerId)
 {
+    // Deliver the cached balances right away and only revalidate them once they are older than BalancesCacheTtlSeconds.
+    FString RequestKey = _MakeReadRequestKey(TEXT("balances"), InGamePlayerId);
+    if (const FGetBalancesResponse* CachedBalances = _BalancesCache.Find(RequestKey))
+    {
+        ++_Stats.ReadCacheHits;
+        OnBalancesReceived.Broadcast(*CachedBalances);
+        if (_BalancesCache.IsFresh(RequestKey, BalancesCacheTtlSeconds))
+        {
+            return FHallidayRequestHandle();
+        }
+    }
+    
+    // Widgets that ask for the same player in the same frame share one request, but each gets a handle of its own.
+    FHallidayRequestHandle Handle;
+    TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> Operation = _BeginReadRequest(RequestKey, Handle);
+    if (!Operation.IsValid())
+    {
+        return Handle;
+    }
+    
     FString GetPlayerBalancesUrl = _ApiEndpoint + TEXT("client/accounts/") + InGamePlayerId + TEXT("/balances");
     
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = _CreateRequest();
     Request->SetURL(GetPlayerBalancesUrl);
     Request->SetVerb("GET");
     Request->SetHeader("Authorization", _AuthHeaderValue);
+    Request->SetHeader(TEXT("Accept-Encoding"), FHallidayHttpCompression::AcceptEncoding);
+    
+    FString ETag = _BalancesCache.GetETag(RequestKey);
+    if (!ETag.IsEmpty())
+    {
+        Request->SetHeader(TEXT("If-None-Match"), ETag);
+    }
     
     // Bind a callback to process the HTTP response
-    Request->OnProcessRequestComplete().BindLambda([this, InGamePlayerId](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-       _HandleGetBalancesResponse(Request, Response, bWasSuccessful, this, InGamePlayerId);
+    // The actor may be destroyed or the call cancelled while the request is in flight.
+    Request->OnProcessRequestComplete().BindLambda([WeakThis = TWeakObjectPtr<AHalliday>(this), InGamePlayerId, RequestKey, Operation](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+       if (!WeakThis.IsValid()) {
+           return;
+       }
+       
+       AHalliday* Halliday = WeakThis.Get();
+       Halliday->_EndReadRequest(RequestKey, *Operation);
+       if (Operation->IsCancelled()) {
+           return;
+       }
+       
+       const FGetBalancesResponse* GetBalancesResponse = UpdateCachedResponse(Response, bWasSuccessful, Halliday->_BalancesCache, RequestKey, Halliday->_Stats);
+       _HandleGetBalancesResponse(Request, Response, bWasSuccessful, Halliday, InGamePlayerId, GetBalancesResponse);
     });
     
-    Request->ProcessRequest();
+    _ProcessRequest(Request, EHallidayRequestPriority::Balances, InGamePlayerId, Operation, true);
+    return Handle;
 }
 
 /**
@@ -762,277 +1165,531 @@ void _HandleGetTransactionResponse(FHttpRequestPtr Request, FHttpResponsePtr Res
     }
     else
     {
-        FString ResponseError = Response->GetContentAsString();
+        FString ResponseError = Response.IsValid() ? Response->GetContentAsString() : FString();
         UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to call GetTransaction() for transaction id '%s' because '%s'."), *TxId, *ResponseError);
     }
 }
 
-void AHalliday::GetTransaction(const FString& TxId)
+FHallidayRequestHandle AHalliday::GetTransaction(const FString& TxId)
 {
+    FString RequestKey = _MakeReadRequestKey(TEXT("transactions"), TxId);
+    FHallidayRequestHandle Handle;
+    TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> Operation = _BeginReadRequest(RequestKey, Handle);
+    if (!Operation.IsValid())
+    {
+        return Handle;
+    }
+    
     FString GetTransactionUrl = _ApiEndpoint + TEXT("client/transactions/") + TxId;
     
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = _CreateRequest();
     Request->SetURL(GetTransactionUrl);
     Request->SetVerb("GET");
     Request->SetHeader("Authorization", _AuthHeaderValue);
     
     // Bind a callback to process the HTTP response
-    Request->OnProcessRequestComplete().BindLambda([this, TxId](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-       _HandleGetTransactionResponse(Request, Response, bWasSuccessful, this, TxId);
+    // The actor may be destroyed or the call cancelled while the request is in flight.
+    Request->OnProcessRequestComplete().BindLambda([WeakThis = TWeakObjectPtr<AHalliday>(this), TxId, RequestKey, Operation](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+       if (!WeakThis.IsValid()) {
+           return;
+       }
+       
+       WeakThis->_EndReadRequest(RequestKey, *Operation);
+       if (!Operation->IsCancelled()) {
+           _HandleGetTransactionResponse(Request, Response, bWasSuccessful, WeakThis.Get(), TxId);
+       }
     });
     
-    Request->ProcessRequest();
+    _ProcessRequest(Request, EHallidayRequestPriority::TransactionStatus, FString(), Operation);
+    return Handle;
 }
 
 /**
- * Asynchronous callback function to trigger a delegate broadcast once the transaction is submitted.
+ * Stages of a transaction in the order they are executed by FHallidayTransactionPipeline.
  * INTERNAL FLOW:
  * 1.  TransferAsset(), TransferBalance(), or ContractCall()
- * 2. _BuildTransaction()
- * 3. _HandleBuildTransactionResponse()
- * 4. _Keccak256()
- * 5. _HandleKaccek256Response()
- * 6. _SignAndSubmitTransaction()
- * 7. _HandleSignAndSubmitTransaction() [Current Step]
- *
- * @param Request Request sent from _Keccak256().
- * @param Response Response from the request sent from _Keccak256().
- * @param bWasSuccessful Indicates the success of the request.
- * @param Halliday Pointer to the object that called TransferAsset(), TransferBalance(), or ContractCall().
- * @param FromInGamePlayerId Id of the player to create a wallet for.
- * @param TxType Type of transaction that is being called.
+ * 2. Build: the backend builds a UserOperation from the request body.
+ * 3. VerifyUserOperation: the UserOperation is hashed locally and compared with tx_hash [Only if bVerifyUserOperationHash]
+ * 4. Hash: tx_hash is hashed with Keccak256 locally, or cross-checked with the backend [Only if bCrossCheckKeccak256WithServer]
+ * 5. Sign: the hash is signed and the submit body is serialized on a background thread.
+ * 6. Submit: the signed transaction is sent to the backend and the Submitted delegate is broadcast.
  */
-void _HandleSignAndSubmitTransactionResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& FromInGamePlayerId, ETransactionType TxType)
-{
-    if (bWasSuccessful && Response->GetResponseCode() == 202)
-    {
-        FString MessageBody = Response->GetContentAsString();
-        FSubmitTransactionResponse SubmitTransactionResponse = ParseResponse<FSubmitTransactionResponse>(MessageBody);
+enum class EHallidayTransactionStage : uint8 {
+    Build,
+    VerifyUserOperation,
+    Hash,
+    Sign,
+    Submit,
+    Completed,
+    Failed,
+    
+    /** Returned by a stage that started an HTTP request or a task which advances the pipeline once it is done. */
+    Pending,
+};
+
+/** Number of stages that get a timestamp, i.e. every stage up to and including Failed. */
+static constexpr int32 NumTransactionStages = (int32)EHallidayTransactionStage::Failed + 1;
+
+/**
+ * Name of a transaction stage for logging.
+ * @param Stage Stage to name.
+ * @returns The name of the stage.
+ */
+static const TCHAR* TransactionStageToString(EHallidayTransactionStage Stage) {
+    switch(Stage) {
+        case EHallidayTransactionStage::Build:
+            return TEXT("build");
+        case EHallidayTransactionStage::VerifyUserOperation:
+            return TEXT("verify");
+        case EHallidayTransactionStage::Hash:
+            return TEXT("hash");
+        case EHallidayTransactionStage::Sign:
+            return TEXT("sign");
+        case EHallidayTransactionStage::Submit:
+            return TEXT("submit");
+        case EHallidayTransactionStage::Completed:
+            return TEXT("completed");
+        case EHallidayTransactionStage::Failed:
+            return TEXT("failed");
+        default:
+            return TEXT("pending");
+    }
+}
+
+/**
+ * Everything a transaction produces on its way through the pipeline. It is owned by exactly one pipeline and is moved, never copied, between stages.
+ */
+struct FHallidayTransactionPayload {
+    FHallidayTransactionPayload() = default;
+    FHallidayTransactionPayload(FHallidayTransactionPayload&&) = default;
+    FHallidayTransactionPayload& operator=(FHallidayTransactionPayload&&) = default;
+    FHallidayTransactionPayload(const FHallidayTransactionPayload&) = delete;
+    FHallidayTransactionPayload& operator=(const FHallidayTransactionPayload&) = delete;
+    
+    /** Body of the build request from TransferAsset(), TransferBalance(), or ContractCall(). */
+    FString BuildRequestBody;
+    
+    /** UserOperation and tx_hash built by the backend. */
+    FBuildTransactionResponse BuildTransactionResponse;
+    
+    /** Keccak256 of tx_hash, which is what gets signed. */
+    FHallidayHash32 SigningHash;
+    
+    /** Serialized body of the submit request including the signature. */
+    FString SubmitRequestBody;
+};
+
+/**
+ * One transaction from the build request to the broadcast of its Submitted delegate.
+ * Every stage either completes synchronously and the pipeline moves straight on to the next one, or starts an HTTP request or a background task that calls _Advance() when it is done.
+ * Callbacks only capture a reference to the pipeline, so the payload is never copied between stages.
+ * Stages run on the game thread except for signing. The background task only touches the payload and the shared signer and hands the next stage back to the game thread.
+ */
+class FHallidayTransactionPipeline : public TSharedFromThis<FHallidayTransactionPipeline, ESPMode::ThreadSafe> {
+public:
+    /**
+     * Build, sign and submit a transaction. Must be called on the game thread.
+     * @param Halliday Pointer to the object that called TransferAsset(), TransferBalance(), or ContractCall().
+     * @param Operation Call that the transaction is cancelled with.
+     * @param TxType Type of transaction that is being called.
+     * @param FromInGamePlayerId Player to build a transaction for.
+     * @param BuildRequestBody Stringified request body to send to our backend.
+     */
+    static void Start(AHalliday* Halliday, const TSharedRef<FHallidayOperation, ESPMode::ThreadSafe>& Operation, ETransactionType TxType, const FString& FromInGamePlayerId, FString&& BuildRequestBody) {
+        TSharedRef<FHallidayTransactionPipeline, ESPMode::ThreadSafe> Pipeline = MakeShared<FHallidayTransactionPipeline, ESPMode::ThreadSafe>(Halliday, Operation, TxType, FromInGamePlayerId);
+        Pipeline->_Payload.BuildRequestBody = MoveTemp(BuildRequestBody);
+        Pipeline->_Advance(EHallidayTransactionStage::Build);
+    }
+    
+    FHallidayTransactionPipeline(AHalliday* Halliday, const TSharedRef<FHallidayOperation, ESPMode::ThreadSafe>& Operation, ETransactionType TxType, const FString& FromInGamePlayerId)
+        : _Halliday(Halliday)
+        , _Operation(Operation)
+        , _TxType(TxType)
+        , _FromInGamePlayerId(FromInGamePlayerId)
+        // Read everything the background stages need from the actor while we are still on the game thread.
+        , _ApiEndpoint(Halliday->GetApiEndpoint())
+        , _AuthHeaderValue(Halliday->GetAuthHeaderValue())
+        , _BlockchainType(Halliday->GetBlockchainType())
+        , _Signer(Halliday->_GetSigner())
+        , _bVerifySignature(Halliday->bVerifySignatureBeforeSubmit)
+        , _MaxSubmitAttempts(FMath::Max(Halliday->MaxSubmitAttempts, 1))
+        , _SubmitRetryBaseDelaySeconds(Halliday->SubmitRetryBaseDelaySeconds)
+        , _SubmitRetryMaxDelaySeconds(Halliday->SubmitRetryMaxDelaySeconds) {
+        for (double& StageTime : _StageTimes) {
+            StageTime = 0.0;
+        }
+    }
+    
+private:
+    /**
+     * Run stages until one of them is asynchronous or the transaction is finished.
+     * @param Stage Stage to run first.
+     */
+    void _Advance(EHallidayTransactionStage Stage) {
+        while (Stage != EHallidayTransactionStage::Pending) {
+            if (_Operation->IsCancelled()) {
+                UE_LOG(LogTemp, Verbose, TEXT("[Halliday] Cancelled a transaction for player '%s' before the %s stage."), *_FromInGamePlayerId, TransactionStageToString(Stage));
+                return;
+            }
+            
+            _Stage = Stage;
+            if (_StageTimes[(int32)Stage] == 0.0) {
+                // A retried stage keeps the time of its first attempt.
+                _StageTimes[(int32)Stage] = FPlatformTime::Seconds();
+            }
+            
+            switch(Stage) {
+                case EHallidayTransactionStage::Build:
+                    Stage = _Build();
+                    break;
+                case EHallidayTransactionStage::VerifyUserOperation:
+                    Stage = _VerifyUserOperation();
+                    break;
+                case EHallidayTransactionStage::Hash:
+                    Stage = _Hash();
+                    break;
+                case EHallidayTransactionStage::Sign:
+                    Stage = _Sign();
+                    break;
+                case EHallidayTransactionStage::Submit:
+                    Stage = _Submit();
+                    break;
+                default:
+                    _LogStageTimes();
+                    return;
+            }
+        }
+    }
+    
+    /**
+     * Send the request body to the backend to build a UserOperation.
+     */
+    EHallidayTransactionStage _Build() {
+        FString BuildTransactionUrl = _ApiEndpoint + TEXT("client/transactions/") + TransactionTypeToString(_TxType);
+        
+        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = _Halliday->_CreateRequest();
+        Request->SetURL(BuildTransactionUrl);
+        Request->SetVerb("POST");
+        Request->SetHeader(TEXT("Authorization"), _AuthHeaderValue);
+        Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+        Request->SetContentAsString(_Payload.BuildRequestBody);
+        
+        // Bind a callback to handle the response.
+        Request->OnProcessRequestComplete().BindLambda([Pipeline = AsShared()](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+            if (!Pipeline->_IsCancelled()) {
+                Pipeline->_Advance(Pipeline->_HandleBuildResponse(Response, bWasSuccessful));
+            }
+        });
+        
+        _Halliday->_ProcessRequest(Request, EHallidayRequestPriority::Transaction, _FromInGamePlayerId, _Operation);
+        return EHallidayTransactionStage::Pending;
+    }
+    
+    EHallidayTransactionStage _HandleBuildResponse(FHttpResponsePtr Response, bool bWasSuccessful) {
+        if (!bWasSuccessful || !Response.IsValid() || Response->GetResponseCode() != 200) {
+            FString ResponseError = Response.IsValid() ? Response->GetContentAsString() : FString();
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to build a transaction of type '%s' for player '%s' because '%s'."), *(TransactionTypeToString(_TxType)), *_FromInGamePlayerId, *ResponseError);
+            return EHallidayTransactionStage::Failed;
+        }
+        
+        // Everything after this signs tx_hash or a hash of it, so a malformed or missing one must not get that far.
+        const FString ResponseBody = Response->GetContentAsString();
+        if (!TryParseResponse(ResponseBody, _Payload.BuildTransactionResponse) || _Payload.BuildTransactionResponse.tx_hash.IsZero()) {
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to build a transaction of type '%s' for player '%s' because the response is malformed or has no tx_hash: %s"), *(TransactionTypeToString(_TxType)), *_FromInGamePlayerId, *ResponseBody);
+            return EHallidayTransactionStage::Failed;
+        }
+        return EHallidayTransactionStage::VerifyUserOperation;
+    }
+    
+    /**
+     * Hash the UserOperation locally so a tampered or mismatched tx_hash is caught before signing.
+     */
+    EHallidayTransactionStage _VerifyUserOperation() {
+        if (!_Halliday->bVerifyUserOperationHash) {
+            return EHallidayTransactionStage::Hash;
+        }
+        
+        FBuildTransactionResponse& BuildTransactionResponse = _Payload.BuildTransactionResponse;
+        FHallidayAddress EntryPoint;
+        FHallidayHash32 UserOperationHash;
+        if (!FHallidayAddress::FromString(_Halliday->EntryPointAddress, EntryPoint)) {
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] EntryPointAddress '%s' is not a valid address."), *_Halliday->EntryPointAddress);
+            return EHallidayTransactionStage::Failed;
+        }
+        
+        // The chain id is part of the hash, so without it every hash would mismatch.
+        const uint64 ChainId = BlockchainTypeToChainId(_BlockchainType);
+        if (ChainId == 0) {
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Cannot verify the UserOperation hash for player '%s' because the chain id of '%s' is unknown. Turn off bVerifyUserOperationHash for this blockchain."), *_FromInGamePlayerId, *BlockchainTypeToString(_BlockchainType));
+            return EHallidayTransactionStage::Failed;
+        }
+        if (!FHallidayUserOperation::ComputeHash(BuildTransactionResponse.transaction, EntryPoint, ChainId, UserOperationHash)) {
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to hash the UserOperation for player '%s' because the built transaction is malformed: %s"), *_FromInGamePlayerId, *(ObjectToString(BuildTransactionResponse.transaction)));
+            return EHallidayTransactionStage::Failed;
+        }
+        // A zero tx_hash never matches, so a response without one fails here instead of being signed with the local hash.
+        if (UserOperationHash != BuildTransactionResponse.tx_hash) {
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] UserOperation hash mismatch for player '%s': local '%s' but server '%s'."), *_FromInGamePlayerId, *UserOperationHash.ToString(), *BuildTransactionResponse.tx_hash.ToString());
+            return EHallidayTransactionStage::Failed;
+        }
+        return EHallidayTransactionStage::Hash;
+    }
+    
+    /**
+     * Hash the tx_hash with Keccak256. This is local and synchronous unless bCrossCheckKeccak256WithServer asks the backend to hash it as well.
+     */
+    EHallidayTransactionStage _Hash() {
+        const FHallidayHash32& TxHash = _Payload.BuildTransactionResponse.tx_hash;
+        FHallidayKeccak256::Hash(TxHash.Bytes, FHallidayHash32::Size, _Payload.SigningHash.Bytes);
+        if (!_Halliday->bCrossCheckKeccak256WithServer) {
+            return EHallidayTransactionStage::Sign;
+        }
+        
+        FString GetKeccak256HashUrl = _ApiEndpoint + TEXT("client/getKeccak256Hash?message=") + TxHash.ToString();
+        
+        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = _Halliday->_CreateRequest();
+        Request->SetURL(GetKeccak256HashUrl);
+        Request->SetVerb("GET");
+        Request->SetHeader("Authorization", _AuthHeaderValue);
+        
+        // Bind a callback to handle the response.
+        Request->OnProcessRequestComplete().BindLambda([Pipeline = AsShared()](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+            if (!Pipeline->_IsCancelled()) {
+                Pipeline->_Advance(Pipeline->_HandleKeccak256Response(Response, bWasSuccessful));
+            }
+        });
+        
+        _Halliday->_ProcessRequest(Request, EHallidayRequestPriority::Transaction, _FromInGamePlayerId, _Operation);
+        return EHallidayTransactionStage::Pending;
+    }
+    
+    EHallidayTransactionStage _HandleKeccak256Response(FHttpResponsePtr Response, bool bWasSuccessful) {
+        if (!bWasSuccessful || !Response.IsValid() || Response->GetResponseCode() != 200) {
+            FString ResponseError = Response.IsValid() ? Response->GetContentAsString() : FString();
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to hash the transaction for player '%s' because '%s'."), *_FromInGamePlayerId, *ResponseError);
+            return EHallidayTransactionStage::Failed;
+        }
+        
+        // Refuse to sign if the server and the local Keccak256 disagree.
+        FKeccak256Response Keccak256Response = ParseResponse<FKeccak256Response>(Response->GetContentAsString());
+        if (_Payload.SigningHash != Keccak256Response.hashed_message) {
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Keccak256 mismatch for player '%s': local '%s' but server '%s'."), *_FromInGamePlayerId, *_Payload.SigningHash.ToString(), *Keccak256Response.hashed_message.ToString());
+            return EHallidayTransactionStage::Failed;
+        }
+        return EHallidayTransactionStage::Sign;
+    }
+    
+    /**
+     * Sign the hash and serialize the submit body.
+     * Signing and serializing the whole transaction can cause frame hitches under bursty trading, so do both on a background thread.
+     * The actor must not be resolved off the game thread, so the next stage is run back on the game thread where _IsCancelled() can check it.
+     */
+    EHallidayTransactionStage _Sign() {
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Pipeline = AsShared()]() {
+            if (Pipeline->_Operation->IsCancelled()) {
+                return;
+            }
+            
+            const EHallidayTransactionStage NextStage = Pipeline->_SignOnBackgroundThread();
+            AsyncTask(ENamedThreads::GameThread, [Pipeline, NextStage]() {
+                if (!Pipeline->_IsCancelled()) {
+                    Pipeline->_Advance(NextStage);
+                }
+            });
+        });
+        return EHallidayTransactionStage::Pending;
+    }
+    
+    /**
+     * Only touches _Payload and _Signer, which are safe to use off the game thread.
+     */
+    EHallidayTransactionStage _SignOnBackgroundThread() {
+        FAATransaction& Transaction = _Payload.BuildTransactionResponse.transaction;
+        if (!_Signer->SignHash(_Payload.SigningHash, _bVerifySignature, Transaction.signature)) {
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to sign a transaction for player '%s'."), *_FromInGamePlayerId);
+            return EHallidayTransactionStage::Failed;
+        }
+        
+        // Convert the transaction object into a general JSON object.
+        TSharedPtr<FJsonObject> TransactionJsonObject = MakeShared<FJsonObject>();
+        FJsonObjectConverter::UStructToJsonObject(FAATransaction::StaticStruct(), &Transaction, TransactionJsonObject.ToSharedRef(), 0, 0);
+        
+        // Create a the request body.
+        TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
+        RequestBody->SetStringField(TEXT("from_in_game_player_id"), _FromInGamePlayerId);
+        RequestBody->SetObjectField(TEXT("signed_tx"), TransactionJsonObject);
+        RequestBody->SetStringField(TEXT("blockchain_type"), BlockchainTypeToString(_BlockchainType));
+        RequestBody->SetStringField(TEXT("tx_id"), _Payload.BuildTransactionResponse.tx_id);
+        
+        // Convert the request body from JSON to string.
+        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&_Payload.SubmitRequestBody);
+        FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
+        return EHallidayTransactionStage::Submit;
+    }
+    
+    /**
+     * Submit the signed transaction to the Halliday backend for onchain execution.
+     */
+    EHallidayTransactionStage _Submit() {
+        ++_NumSubmitAttempts;
+        
+        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = _Halliday->_CreateRequest();
+        Request->SetURL(_ApiEndpoint + TEXT("client/transactions/"));
+        Request->SetVerb("POST");
+        Request->SetHeader(TEXT("Authorization"), _AuthHeaderValue);
+        Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+        
+        // Every attempt sends the same signed body under the same key, so the backend runs the UserOperation at most once.
+        Request->SetHeader(TEXT("Idempotency-Key"), _Payload.BuildTransactionResponse.tx_id);
+        Request->SetContentAsString(_Payload.SubmitRequestBody);
+        
+        // Bind a callback to handle the response. The HTTP module executes it and the delegate broadcast on the game thread.
+        Request->OnProcessRequestComplete().BindLambda([Pipeline = AsShared()](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+            if (!Pipeline->_IsCancelled()) {
+                Pipeline->_Advance(Pipeline->_HandleSubmitResponse(Response, bWasSuccessful));
+            }
+        });
+        
+        // _RetrySubmit() owns the retries of a submit, so the scheduler must not requeue it as well. Each attempt is then counted once.
+        _Halliday->_ProcessRequest(Request, EHallidayRequestPriority::Transaction, _FromInGamePlayerId, _Operation, false, false);
+        return EHallidayTransactionStage::Pending;
+    }
+    
+    EHallidayTransactionStage _HandleSubmitResponse(FHttpResponsePtr Response, bool bWasSuccessful) {
+        const int32 ResponseCode = bWasSuccessful && Response.IsValid() ? Response->GetResponseCode() : 0;
+        if (ResponseCode != 202) {
+            FString ResponseError = Response.IsValid() ? Response->GetContentAsString() : FString();
+            
+            // A signed UserOperation took several round trips to get, so transient failures are retried with the same payload instead of being dropped.
+            const bool bIsTransient = ResponseCode == 0 || ResponseCode == 408 || ResponseCode == 429 || ResponseCode >= 500;
+            if (bIsTransient && _NumSubmitAttempts < _MaxSubmitAttempts) {
+                return _RetrySubmit(ResponseCode, ResponseError);
+            }
+            
+            _Halliday->_RecordSubmitAttempts(_NumSubmitAttempts, _GetSubmitRetrySeconds(), false);
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to sign and submit a transaction for player '%s' after %d attempts because '%s'."), *_FromInGamePlayerId, _NumSubmitAttempts, *(ResponseError));
+            return EHallidayTransactionStage::Failed;
+        }
         
-        switch(TxType) {
+        _Halliday->_RecordSubmitAttempts(_NumSubmitAttempts, _GetSubmitRetrySeconds(), true);
+        
+        FSubmitTransactionResponse SubmitTransactionResponse = ParseResponse<FSubmitTransactionResponse>(Response->GetContentAsString());
+        switch(_TxType) {
             case ETransactionType::TRANSFER_ASSET:
-                UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Submitted a transaction '%s' to transfer an asset for player '%s': %s"), *SubmitTransactionResponse.tx_id, *FromInGamePlayerId, *(ObjectToString(SubmitTransactionResponse)));
-                Halliday->OnTransferAssetSubmitted.Broadcast(SubmitTransactionResponse);
+                UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Submitted a transaction '%s' to transfer an asset for player '%s': %s"), *SubmitTransactionResponse.tx_id, *_FromInGamePlayerId, *(ObjectToString(SubmitTransactionResponse)));
+                _Halliday->OnTransferAssetSubmitted.Broadcast(SubmitTransactionResponse);
                 break;
             case ETransactionType::TRANSFER_BALANCE:
-                UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Submitted a transaction '%s' to transfer a balance for player '%s': %s"), *SubmitTransactionResponse.tx_id, *FromInGamePlayerId, *(ObjectToString(SubmitTransactionResponse)));
-                Halliday->OnTransferBalanceSubmitted.Broadcast(SubmitTransactionResponse);
+                UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Submitted a transaction '%s' to transfer a balance for player '%s': %s"), *SubmitTransactionResponse.tx_id, *_FromInGamePlayerId, *(ObjectToString(SubmitTransactionResponse)));
+                _Halliday->OnTransferBalanceSubmitted.Broadcast(SubmitTransactionResponse);
                 break;
             case ETransactionType::CALL_CONTRACT:
-                UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Submitted a transaction '%s' to call a contract for player '%s': %s"), *SubmitTransactionResponse.tx_id, *FromInGamePlayerId, *(ObjectToString(SubmitTransactionResponse)));
-                Halliday->OnCallContractSubmitted.Broadcast(SubmitTransactionResponse);
+                UE_LOG(LogTemp, Display, TEXT("[Halliday Response] Submitted a transaction '%s' to call a contract for player '%s': %s"), *SubmitTransactionResponse.tx_id, *_FromInGamePlayerId, *(ObjectToString(SubmitTransactionResponse)));
+                _Halliday->OnCallContractSubmitted.Broadcast(SubmitTransactionResponse);
                 break;
             default:
                 // Should never happen.
                 UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Invalid TxType in when signing and submitting a transaction."));
-                break;
+                return EHallidayTransactionStage::Failed;
         }
+        return EHallidayTransactionStage::Completed;
+    }
+    
+    /**
+     * Check whether the transaction must stop because its call was cancelled or the actor is gone. Only call this on the game thread.
+     */
+    bool _IsCancelled() const {
+        return _Operation->IsCancelled() || !_Halliday.IsValid();
+    }
+    
+    /**
+     * Submit the signed payload again after an exponential backoff with full jitter, so that many clients failing at once do not retry in lockstep.
+     * @param ResponseCode Status code of the failed attempt, or 0 if there was no response.
+     * @param ResponseError Body of the failed attempt.
+     */
+    EHallidayTransactionStage _RetrySubmit(int32 ResponseCode, const FString& ResponseError) {
+        if (_FirstSubmitFailureTime == 0.0) {
+            _FirstSubmitFailureTime = FPlatformTime::Seconds();
+        }
+        
+        const float MaxDelaySeconds = FMath::Min(_SubmitRetryBaseDelaySeconds * FMath::Pow(2.0f, (float)(_NumSubmitAttempts - 1)), _SubmitRetryMaxDelaySeconds);
+        const float DelaySeconds = FMath::FRandRange(0.0f, FMath::Max(MaxDelaySeconds, 0.0f));
+        UE_LOG(LogTemp, Warning, TEXT("[Halliday] Submitting transaction '%s' for player '%s' failed with %d ('%s'). Retrying in %.2f seconds (attempt %d of %d)."), *_Payload.BuildTransactionResponse.tx_id, *_FromInGamePlayerId, ResponseCode, *ResponseError, DelaySeconds, _NumSubmitAttempts + 1, _MaxSubmitAttempts);
         
-        // TODO add retry logic in case of failures.
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Pipeline = AsShared()](float DeltaTime) {
+            if (!Pipeline->_IsCancelled()) {
+                Pipeline->_Advance(EHallidayTransactionStage::Submit);
+            }
+            return false;
+        }), DelaySeconds);
+        return EHallidayTransactionStage::Pending;
     }
-    else
-    {
-        FString ResponseError = Response->GetContentAsString();
-        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to sign and submit a transaction for player '%s' because '%s'."), *FromInGamePlayerId, *(ResponseError));
+    
+    /** Seconds from the first failed submit to now, or 0 if no submit has failed. */
+    double _GetSubmitRetrySeconds() const {
+        return _FirstSubmitFailureTime > 0.0 ? FPlatformTime::Seconds() - _FirstSubmitFailureTime : 0.0;
     }
-}
-
-/**
- * Signs a Keccak256 hashed TxHash and submit a transaction to the Halliday backend for onchain execution.
- * INTERNAL FLOW:
- * 1.  TransferAsset(), TransferBalance(), or ContractCall()
- * 2. _BuildTransaction()
- * 3. _HandleBuildTransactionResponse()
- * 4. _Keccak256()
- * 5. _HandleKaccek256Response()
- * 6. _SignAndSubmitTransaction() [Current Step]
- * 7. _HandleSignAndSubmitTransaction()
- *
- * @param Halliday Pointer to the object that called Pointer to the object that called TransferAsset(), TransferBalance(), or ContractCall().
- * @param BuildTransactionResponse Response object from _BuildTransaction().
- * @param FromInGamePlayerId Player to build a transaction for.
- * @param Keccak256HashedTransactionHash Hashed tx hash that is going to be signed.
- * @param TxType Type of transaction that is being called.
- */
-void _SignAndSubmitTransaction(AHalliday* Halliday, const FBuildTransactionResponse& BuildTransactionResponse, const FString& FromInGamePlayerId, const FString& Keccak256HashedTransactionHash, ETransactionType TxType)
-{
-    FAATransaction Transaction = BuildTransactionResponse.transaction;
-    FString SignatureString = Halliday->_Secp256k1(Keccak256HashedTransactionHash);
-    Transaction.signature = SignatureString;
-
-    FString SubmitUrl = Halliday->GetApiEndpoint() + TEXT("client/transactions/");
     
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(SubmitUrl);
-    Request->SetVerb("POST");
-    Request->SetHeader(TEXT("Authorization"), Halliday->GetAuthHeaderValue());
-    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+    /**
+     * Log how long each stage that was reached took.
+     */
+    void _LogStageTimes() const {
+        FString StageTimes;
+        for (int32 Stage = 0; Stage < (int32)EHallidayTransactionStage::Completed; ++Stage) {
+            if (_StageTimes[Stage] == 0.0) {
+                continue;
+            }
+            
+            // A stage ends when the next stage that was reached begins.
+            int32 NextStage = Stage + 1;
+            while (_StageTimes[NextStage] == 0.0 && NextStage < (int32)_Stage) {
+                ++NextStage;
+            }
+            StageTimes += FString::Printf(TEXT(" %s=%.1fms"), TransactionStageToString((EHallidayTransactionStage)Stage), (_StageTimes[NextStage] - _StageTimes[Stage]) * 1000.0);
+        }
+        UE_LOG(LogTemp, Verbose, TEXT("[Halliday] Transaction '%s' for player '%s' %s in %.1fms:%s"), *_Payload.BuildTransactionResponse.tx_id, *_FromInGamePlayerId, TransactionStageToString(_Stage), (_StageTimes[(int32)_Stage] - _StageTimes[(int32)EHallidayTransactionStage::Build]) * 1000.0, *StageTimes);
+    }
     
-    // Bind a callback to handle the response.
-    Request->OnProcessRequestComplete().BindLambda([Halliday, FromInGamePlayerId, TxType](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-       _HandleSignAndSubmitTransactionResponse(Request, Response, bWasSuccessful, Halliday, FromInGamePlayerId, TxType);
-    });
+    /** Weak so that a transaction in flight does not outlive the actor's memory. Only dereferenced on the game thread after _IsCancelled() returned false. */
+    TWeakObjectPtr<AHalliday> _Halliday;
     
-    // Convert the transaction object into a general JSON object.
-    TSharedPtr<FJsonObject> TransactionJsonObject = MakeShared<FJsonObject>();
-    FJsonObjectConverter::UStructToJsonObject(FAATransaction::StaticStruct(), &Transaction, TransactionJsonObject.ToSharedRef(), 0, 0);
+    /** Call of TransferAsset(), TransferBalance(), or ContractCall() that the transaction is cancelled with. */
+    TSharedRef<FHallidayOperation, ESPMode::ThreadSafe> _Operation;
     
-    // Create a the request body.
-    TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
-    RequestBody->SetStringField(TEXT("from_in_game_player_id"), FromInGamePlayerId);
-    RequestBody->SetObjectField(TEXT("signed_tx"), TransactionJsonObject);
-    RequestBody->SetStringField(TEXT("blockchain_type"), BlockchainTypeToString(Halliday->GetBlockchainType()));
-    RequestBody->SetStringField(TEXT("tx_id"), BuildTransactionResponse.tx_id);
-
-    // Convert the request body from JSON to string.
-    FString RequestBodyAsString;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBodyAsString);
-    FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
+    ETransactionType _TxType;
+    FString _FromInGamePlayerId;
+    FString _ApiEndpoint;
+    FString _AuthHeaderValue;
+    EBlockchainType _BlockchainType;
     
-    Request->SetContentAsString(RequestBodyAsString);
-    Request->ProcessRequest();
-}
-
-/**
- *
- * Asynchronous callback function to send the hashed message to _SignAndSubmitTransaction().
- * INTERNAL FLOW:
- * 1.  TransferAsset(), TransferBalance(), or ContractCall()
- * 2. _BuildTransaction()
- * 3. _HandleBuildTransactionResponse()
- * 4. _Keccak256()
- * 5. _HandleKaccek256Response() [Current Step]
- * 6. _SignAndSubmitTransaction()
- * 7. _HandleSignAndSubmitTransaction()
- *
- * @param Request Request sent from _Keccak256().
- * @param Response Response from the request sent from _Keccak256().
- * @param bWasSuccessful Indicates the success of the request.
- * @param Halliday Pointer to the object that called TransferAsset(), TransferBalance(), or ContractCall().
- * @param FromInGamePlayerId Id of the player to create a wallet for.
- * @param TxType Type of transaction that is being called.
- */
-void _HandleKeccak256Response(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, const FBuildTransactionResponse& BuildTransactionResponse, AHalliday* Halliday, const FString& FromInGamePlayerId, ETransactionType TxType)
-{
-    if (bWasSuccessful && Response->GetResponseCode() == 200)
-    {
-        FString MessageBody = Response->GetContentAsString();
-        FKeccak256Response Keccak256Response = ParseResponse<FKeccak256Response>(MessageBody);
+    /** Signer of the actor, taken on the game thread so that the background stage can sign without resolving _Halliday. */
+    TSharedRef<FHallidaySigner, ESPMode::ThreadSafe> _Signer;
     
-        _SignAndSubmitTransaction(Halliday, BuildTransactionResponse, FromInGamePlayerId, Keccak256Response.hashed_message, TxType);
-    }
-    else
-    {
-        FString ResponseError = Response->GetContentAsString();
-        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to hash the transaction for player '%s' because '%s'."), *FromInGamePlayerId, *ResponseError);
-    }
-}
-
-/**
- * Helper function that calls our backend to hash the transaction hash using Keccak256. This is to avoid using an unreliable library in C++.
- * INTERNAL FLOW:
- * 1.  TransferAsset(), TransferBalance(), or ContractCall()
- * 2. _BuildTransaction()
- * 3. _HandleBuildTransactionResponse()
- * 4. _Keccak256() [Current Step]
- * 5. _HandleKaccek256Response()
- * 6. _SignAndSubmitTransaction()
- * 7. _HandleSignAndSubmitTransaction()
- *
- * @param Halliday Pointer to the object that called Pointer to the object that called TransferAsset(), TransferBalance(), or ContractCall().
- * @param BuildTransactionResponse Response object from _BuildTransaction().
- * @param FromInGamePlayerId Player to build a transaction for.
- * @param TxType Type of transaction that is being called.
- */
-void _Keccak256(AHalliday* Halliday, const FBuildTransactionResponse& BuildTransactionResponse, const FString& FromInGamePlayerId, ETransactionType TxType)
-{
-    FString TxHash = BuildTransactionResponse.tx_hash;
-    FString GetPlayerWalletsUrl = Halliday->GetApiEndpoint() + TEXT("client/getKeccak256Hash?message=") + TxHash;
-        
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(GetPlayerWalletsUrl);
-    Request->SetVerb("GET");
-    Request->SetHeader("Authorization", Halliday->GetAuthHeaderValue());
+    /** bVerifySignatureBeforeSubmit when the transaction started. */
+    bool _bVerifySignature;
     
-    // Bind a callback to handle the response.
-    Request->OnProcessRequestComplete().BindLambda([Halliday, BuildTransactionResponse, FromInGamePlayerId, TxType](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-       _HandleKeccak256Response(Request, Response, bWasSuccessful, BuildTransactionResponse, Halliday, FromInGamePlayerId, TxType);
-    });
+    /** Retry settings read from the actor when the transaction started. */
+    int32 _MaxSubmitAttempts;
+    float _SubmitRetryBaseDelaySeconds;
+    float _SubmitRetryMaxDelaySeconds;
     
-    Request->ProcessRequest();
-}
-
-/**
- * Asynchronous callback function to handle the response of _BuildTransaction() and calls the Halliday backend to apply a Keccak256 hash to that transaction hash before signing it with the private key.
- * INTERNAL FLOW:
- * 1.  TransferAsset(), TransferBalance(), or ContractCall()
- * 2. _BuildTransaction()
- * 3. _HandleBuildTransactionResponse() [Current Step]
- * 4. _Keccak256()
- * 5. _HandleKaccek256Response()
- * 6. _SignAndSubmitTransaction()
- * 7. _HandleSignAndSubmitTransaction()
- *
- * @param Request Request sent from _BuildTransaction().
- * @param Response Response from the request sent from _BuildTransaction().
- * @param bWasSuccessful Indicates the success of the request.
- * @param Halliday Pointer to the object that called TransferAsset(), TransferBalance(), or ContractCall().
- * @param FromInGamePlayerId Id of the player to create a wallet for.
- * @param TxType  Type of transaction that is being called.
- */
-void _HandleBuildTransactionResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, AHalliday* Halliday, const FString& FromInGamePlayerId, ETransactionType TxType)
-{
-    if (bWasSuccessful && Response->GetResponseCode() == 200)
-    {
-        FString MessageBody = Response->GetContentAsString();
-        FBuildTransactionResponse BuildTransactionResponse = ParseResponse<FBuildTransactionResponse>(MessageBody);
-        
-        // Use the server to hash the tx_hash
-        _Keccak256(Halliday, BuildTransactionResponse, FromInGamePlayerId, TxType);
-    }
-    else
-    {
-        FString ResponseError = Response->GetContentAsString();
-        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to build a transaction of type '%s' for player '%s' because '%s'."), *(TransactionTypeToString(TxType)), *FromInGamePlayerId, *ResponseError);
-    }
-}
-
-/**
- * Helper function that is used for TransferAsset(), TransferBalance(), and ContractCall(). Those high level functions only create the necessary body parameters.
- * INTERNAL FLOW:
- * 1.  TransferAsset(), TransferBalance(), or ContractCall()
- * 2. _BuildTransaction() [Current Step]
- * 3. _HandleBuildTransactionResponse()
- * 4. _Keccak256()
- * 5. _HandleKaccek256Response()
- * 6. _SignAndSubmitTransaction()
- * 7. _HandleSignAndSubmitTransaction()
- *
- * @param Halliday Pointer to the object that called GetOrCreateHallidayAAWallet().
- * @param TxType Type of transaction that is being called.
- * @param RequestBodyAsString Stringified request body to send to our backend.
- * @param FromInGamePlayerId Player to build a transaction for.
- */
-void _BuildTransaction(AHalliday* Halliday, ETransactionType TxType, FString RequestBodyAsString, FString FromInGamePlayerId)
-{
-    FString BuildTransactionUrl = Halliday->GetApiEndpoint() + TEXT("client/transactions/") + TransactionTypeToString(TxType);
+    /** Number of times the signed payload was submitted. */
+    int32 _NumSubmitAttempts = 0;
     
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(BuildTransactionUrl);
-    Request->SetVerb("POST");
-    Request->SetHeader(TEXT("Authorization"), Halliday->GetAuthHeaderValue());
-    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-    Request->SetContentAsString(RequestBodyAsString);
+    /** FPlatformTime::Seconds() at which the first submit failed, or 0 if none has. */
+    double _FirstSubmitFailureTime = 0.0;
     
-    // Bind a callback to handle the response.
-    Request->OnProcessRequestComplete().BindLambda([Halliday, FromInGamePlayerId, TxType](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
-       _HandleBuildTransactionResponse(Request, Response, bWasSuccessful, Halliday, FromInGamePlayerId, TxType);
-    });
-
-    Request->ProcessRequest();
-}
+    /** Data owned by the transaction. Only the stage that is currently running touches it. */
+    FHallidayTransactionPayload _Payload;
+    
+    /** Stage that is currently running, or Completed or Failed once the transaction is finished. */
+    EHallidayTransactionStage _Stage = EHallidayTransactionStage::Build;
+    
+    /** FPlatformTime::Seconds() at which each stage began, or 0 if it was not reached. */
+    double _StageTimes[NumTransactionStages];
+};
 
-void AHalliday::TransferAsset(const FString& FromInGamePlayerId, const FString& ToInGamePlayerId, const FString& CollectionAddress, const FString& TokenId, EBlockchainType BlockchainType, bool bSponsorGas)
+FHallidayRequestHandle AHalliday::TransferAsset(const FString& FromInGamePlayerId, const FString& ToInGamePlayerId, const FString& CollectionAddress, const FString& TokenId, EBlockchainType BlockchainType, bool bSponsorGas)
 {
     TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
     RequestBody->SetStringField(TEXT("from_in_game_player_id"), FromInGamePlayerId);
@@ -1046,10 +1703,12 @@ void AHalliday::TransferAsset(const FString& FromInGamePlayerId, const FString&
     TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBodyAsString);
     FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
     
-    _BuildTransaction(this, ETransactionType::TRANSFER_ASSET, RequestBodyAsString, FromInGamePlayerId);
+    FHallidayRequestHandle Handle;
+    FHallidayTransactionPipeline::Start(this, _BeginOperation(Handle), ETransactionType::TRANSFER_ASSET, FromInGamePlayerId, MoveTemp(RequestBodyAsString));
+    return Handle;
 }
 
-void AHalliday::TransferBalance(const FString& FromInGamePlayerId, const FString& ToInGamePlayerId, EBlockchainType BlockchainType, bool bSponsorGas, const FString& Value, const FString& TokenAddress)
+FHallidayRequestHandle AHalliday::TransferBalance(const FString& FromInGamePlayerId, const FString& ToInGamePlayerId, EBlockchainType BlockchainType, bool bSponsorGas, const FString& Value, const FString& TokenAddress)
 {
     TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
     RequestBody->SetStringField(TEXT("from_in_game_player_id"), FromInGamePlayerId);
@@ -1067,10 +1726,12 @@ void AHalliday::TransferBalance(const FString& FromInGamePlayerId, const FString
     TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBodyAsString);
     FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
     
-    _BuildTransaction(this, ETransactionType::TRANSFER_BALANCE, RequestBodyAsString, FromInGamePlayerId);
+    FHallidayRequestHandle Handle;
+    FHallidayTransactionPipeline::Start(this, _BeginOperation(Handle), ETransactionType::TRANSFER_BALANCE, FromInGamePlayerId, MoveTemp(RequestBodyAsString));
+    return Handle;
 }
 
-void AHalliday::ContractCall(const FString& FromInGamePlayerId, const FString& TargetAddress, const FString& Calldata, EBlockchainType BlockchainType, bool bSponsorGas, const FString& Value)
+FHallidayRequestHandle AHalliday::ContractCall(const FString& FromInGamePlayerId, const FString& TargetAddress, const FString& Calldata, EBlockchainType BlockchainType, bool bSponsorGas, const FString& Value)
 {
     TSharedPtr<FJsonObject> RequestBody = MakeShared<FJsonObject>();
     RequestBody->SetStringField(TEXT("from_in_game_player_id"), FromInGamePlayerId);
@@ -1084,10 +1745,25 @@ void AHalliday::ContractCall(const FString& FromInGamePlayerId, const FString& T
     TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBodyAsString);
     FJsonSerializer::Serialize(RequestBody.ToSharedRef(), Writer);
     
-    _BuildTransaction(this, ETransactionType::CALL_CONTRACT, RequestBodyAsString, FromInGamePlayerId);
+    FHallidayRequestHandle Handle;
+    FHallidayTransactionPipeline::Start(this, _BeginOperation(Handle), ETransactionType::CALL_CONTRACT, FromInGamePlayerId, MoveTemp(RequestBodyAsString));
+    return Handle;
+}
+
+// Encode the call with the reusable encoder and broadcast it as a hex string
+void AHalliday::BuildCalldata(const FString& FunctionSignature, const TArray<FString>& Arguments)
+{
+    if (!_CalldataEncoder.EncodeCall(FunctionSignature, Arguments)) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to build calldata because the arguments do not match '%s'."), *FunctionSignature);
+        return;
+    }
+    
+    const TArray<uint8>& Calldata = _CalldataEncoder.GetEncoded();
+    FBuildCalldataResponse BuildCalldataResponse;
+    BuildCalldataResponse.calldata = FHallidayHex::Encode(Calldata.GetData(), Calldata.Num(), true);
+    OnCalldataBuilt.Broadcast(BuildCalldataResponse);
 }
 
-// Called when the game starts or when spawned
 void AHalliday::BeginPlay()
 {
 	Super::BeginPlay();
@@ -1105,8 +1781,35 @@ void AHalliday::BeginPlay()
     AWeb3Auth::setLogoutEvent(LogoutDelegate);
 }
 
+// Called when the actor is removed from the level or the game ends
+void AHalliday::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // Nobody is left to consume the responses, and their callbacks must not run on a destroyed actor.
+    _CancelAllOperations();
+    
+    // Transactions that are still signing hold on to the signer, so zero the keys now instead of when it is destroyed.
+    _Signer->Reset();
+    
+    Super::EndPlay(EndPlayReason);
+}
+
 // Called every frame
 void AHalliday::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+    
+    // Pick up changes to the settings, e.g. from Blueprints, and send the hedges that are due and the requests the rate limiters held back.
+    _RequestScheduler->SetMaxInFlight(MaxRequestsInFlight);
+    _RequestScheduler->SetHedging(bHedgeReadRequests, HedgeDelaySeconds, HedgeBudgetPercent / 100.0f);
+    _RequestScheduler->SetRequestTimeout(RequestTimeoutSeconds);
+    _RequestScheduler->Tick();
+    _Signer->SetRandomizeInterval(Secp256k1RandomizeInterval);
+    
+    // Keep the connection warm so that the next call after a quiet period does not pay for a new handshake.
+    if (ConnectionRewarmIdleSeconds > 0.0f && !_ApiEndpoint.IsEmpty()) {
+        const double IdleSeconds = FPlatformTime::Seconds() - _LastRequestTime.load(std::memory_order_relaxed);
+        if (IdleSeconds >= ConnectionRewarmIdleSeconds) {
+            _PrewarmConnection();
+        }
+    }
 }
@@ -0,0 +1,664 @@
+#include "HallidayAbi.h"
+#include "HallidayHex.h"
+#include "HallidayKeccak.h"
+
+/**
+ * Write a 64 bit number into the low bytes of a zeroed 32 byte word.
+ */
+static void WriteUint64(uint8* Word, uint64 Value)
+{
+    for (int32 i = 0; i < 8; ++i)
+    {
+        Word[31 - i] = (uint8)(Value >> (i * 8));
+    }
+}
+
+/**
+ * Check that the bytes of a word above the lowest Bits bits all equal Fill.
+ */
+static bool HasHighBytes(const uint8* Word, int32 Bits, uint8 Fill)
+{
+    for (int32 i = 0; i < 32 - Bits / 8; ++i)
+    {
+        if (Word[i] != Fill)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+FHallidayUint256::FHallidayUint256(uint64 Value)
+{
+    WriteUint64(Bytes, Value);
+}
+
+bool FHallidayUint256::FromString(const FString& Value, FHallidayUint256& OutValue)
+{
+    return FHallidayAbiEncoder::ParseUint(Value, 256, OutValue.Bytes);
+}
+
+uint32 FHallidayAbiEncoder::ComputeSelector(const FString& FunctionSignature)
+{
+    const FTCHARToUTF8 SignatureUtf8(*FunctionSignature);
+    uint8 Hash[FHallidayKeccak256::DigestSize];
+    FHallidayKeccak256::Hash((const uint8*)SignatureUtf8.Get(), SignatureUtf8.Length(), Hash);
+    return ((uint32)Hash[0] << 24) | ((uint32)Hash[1] << 16) | ((uint32)Hash[2] << 8) | (uint32)Hash[3];
+}
+
+bool FHallidayAbiEncoder::ParseUint(const FString& Value, int32 Bits, uint8* OutWord)
+{
+    if (Value.StartsWith(TEXT("0x")))
+    {
+        return Value.Len() > 2 && FHallidayHex::DecodeNumber(Value, OutWord, WordSize) && HasHighBytes(OutWord, Bits, 0);
+    }
+    if (Value.IsEmpty())
+    {
+        return false;
+    }
+
+    // Multiply the word by ten and add each digit.
+    FMemory::Memzero(OutWord, WordSize);
+    for (const TCHAR Char : Value)
+    {
+        if (!FChar::IsDigit(Char))
+        {
+            return false;
+        }
+        uint32 Carry = Char - '0';
+        for (int32 i = WordSize - 1; i >= 0; --i)
+        {
+            const uint32 Product = OutWord[i] * 10u + Carry;
+            OutWord[i] = (uint8)Product;
+            Carry = Product >> 8;
+        }
+        if (Carry != 0)
+        {
+            return false;
+        }
+    }
+    return HasHighBytes(OutWord, Bits, 0);
+}
+
+bool FHallidayAbiEncoder::ParseInt(const FString& Value, int32 Bits, uint8* OutWord)
+{
+    const bool bIsNegative = Value.StartsWith(TEXT("-"));
+    if (!ParseUint(bIsNegative ? Value.Mid(1) : Value, 256, OutWord))
+    {
+        return false;
+    }
+
+    // Negate into two's complement.
+    bool bIsZero = true;
+    if (bIsNegative)
+    {
+        uint32 Carry = 1;
+        for (int32 i = WordSize - 1; i >= 0; --i)
+        {
+            bIsZero &= OutWord[i] == 0;
+            const uint32 Sum = (uint8)~OutWord[i] + Carry;
+            OutWord[i] = (uint8)Sum;
+            Carry = Sum >> 8;
+        }
+    }
+
+    // The value fits if every byte above the type size is a copy of its sign bit.
+    const bool bSignBit = (OutWord[WordSize - Bits / 8] & 0x80) != 0;
+    return bSignBit == (bIsNegative && !bIsZero) && HasHighBytes(OutWord, Bits, bSignBit ? 0xff : 0x00);
+}
+
+FHallidayAbiEncoder::FHallidayAbiEncoder()
+{
+    Frames.AddDefaulted(1);
+}
+
+void FHallidayAbiEncoder::Begin(uint32 InSelector)
+{
+    Begin();
+    Selector = InSelector;
+    bHasSelector = true;
+}
+
+void FHallidayAbiEncoder::Begin()
+{
+    Depth = -1;
+    PushFrame(false);
+    bHasSelector = false;
+    Data.Reset();
+}
+
+void FHallidayAbiEncoder::PushFrame(bool bIsArray)
+{
+    ++Depth;
+    if (Depth == Frames.Num())
+    {
+        Frames.AddDefaulted();
+    }
+
+    // Reset() keeps the capacity of the buffers so that frames at this depth stop allocating once warm.
+    FFrame& Frame = Frames[Depth];
+    Frame.Head.Reset();
+    Frame.Tail.Reset();
+    Frame.Offsets.Reset();
+    Frame.NumValues = 0;
+    Frame.bHasDynamicValue = false;
+    Frame.bIsArray = bIsArray;
+}
+
+void FHallidayAbiEncoder::PatchOffsets(FFrame& Frame)
+{
+    // Offsets are relative to the start of the head, which ends where the tail starts.
+    for (const TPair<int32, int32>& Offset : Frame.Offsets)
+    {
+        WriteUint64(Frame.Head.GetData() + Offset.Key, (uint64)(Frame.Head.Num() + Offset.Value));
+    }
+}
+
+void FHallidayAbiEncoder::PopFrame()
+{
+    check(Depth > 0);
+    FFrame& Child = Frames[Depth];
+    --Depth;
+    PatchOffsets(Child);
+
+    if (Child.bIsArray || Child.bHasDynamicValue)
+    {
+        TArray<uint8>& Tail = AddDynamicValue();
+        if (Child.bIsArray)
+        {
+            const int32 LengthPosition = Tail.AddZeroed(WordSize);
+            WriteUint64(Tail.GetData() + LengthPosition, (uint64)Child.NumValues);
+        }
+        Tail.Append(Child.Head);
+        Tail.Append(Child.Tail);
+    }
+    else
+    {
+        // A tuple of static values is written in place like the values themselves.
+        FFrame& Parent = Frames[Depth];
+        Parent.Head.Append(Child.Head);
+        ++Parent.NumValues;
+    }
+}
+
+uint8* FHallidayAbiEncoder::AddStaticWord()
+{
+    FFrame& Frame = Frames[Depth];
+    ++Frame.NumValues;
+    const int32 Position = Frame.Head.AddZeroed(WordSize);
+    return Frame.Head.GetData() + Position;
+}
+
+TArray<uint8>& FHallidayAbiEncoder::AddDynamicValue()
+{
+    FFrame& Frame = Frames[Depth];
+    ++Frame.NumValues;
+    Frame.bHasDynamicValue = true;
+    Frame.Offsets.Emplace(Frame.Head.AddZeroed(WordSize), Frame.Tail.Num());
+    return Frame.Tail;
+}
+
+void FHallidayAbiEncoder::AddUint(uint64 Value)
+{
+    WriteUint64(AddStaticWord(), Value);
+}
+
+void FHallidayAbiEncoder::AddUint(const FHallidayUint256& Value)
+{
+    FMemory::Memcpy(AddStaticWord(), Value.Bytes, WordSize);
+}
+
+void FHallidayAbiEncoder::AddInt(int64 Value)
+{
+    uint8* Word = AddStaticWord();
+    if (Value < 0)
+    {
+        FMemory::Memset(Word, 0xff, WordSize);
+    }
+    WriteUint64(Word, (uint64)Value);
+}
+
+void FHallidayAbiEncoder::AddBool(bool bValue)
+{
+    AddStaticWord()[WordSize - 1] = bValue ? 1 : 0;
+}
+
+void FHallidayAbiEncoder::AddAddress(const FHallidayAddress& Address)
+{
+    FMemory::Memcpy(AddStaticWord() + WordSize - FHallidayAddress::Size, Address.Bytes, FHallidayAddress::Size);
+}
+
+void FHallidayAbiEncoder::AddFixedBytes(const uint8* Bytes, int32 Size)
+{
+    check(Size > 0 && Size <= WordSize);
+    FMemory::Memcpy(AddStaticWord(), Bytes, Size);
+}
+
+void FHallidayAbiEncoder::AddBytes(const uint8* Bytes, int32 Size)
+{
+    // Dynamic bytes are their length followed by the bytes padded with zeros to a whole number of words.
+    TArray<uint8>& Tail = AddDynamicValue();
+    const int32 Position = Tail.AddZeroed(WordSize + Align(Size, WordSize));
+    WriteUint64(Tail.GetData() + Position, (uint64)Size);
+    if (Size > 0)
+    {
+        FMemory::Memcpy(Tail.GetData() + Position + WordSize, Bytes, Size);
+    }
+}
+
+void FHallidayAbiEncoder::AddString(const FString& Value)
+{
+    const FTCHARToUTF8 ValueUtf8(*Value);
+    AddBytes((const uint8*)ValueUtf8.Get(), ValueUtf8.Length());
+}
+
+void FHallidayAbiEncoder::BeginTuple()
+{
+    PushFrame(false);
+}
+
+void FHallidayAbiEncoder::EndTuple()
+{
+    check(!Frames[Depth].bIsArray);
+    PopFrame();
+}
+
+void FHallidayAbiEncoder::BeginArray()
+{
+    PushFrame(true);
+}
+
+void FHallidayAbiEncoder::EndArray()
+{
+    check(Frames[Depth].bIsArray);
+    PopFrame();
+}
+
+const TArray<uint8>& FHallidayAbiEncoder::Finish()
+{
+    check(Depth == 0);
+    FFrame& Root = Frames[0];
+    PatchOffsets(Root);
+
+    Data.Reset(4 + Root.Head.Num() + Root.Tail.Num());
+    if (bHasSelector)
+    {
+        Data.Add((uint8)(Selector >> 24));
+        Data.Add((uint8)(Selector >> 16));
+        Data.Add((uint8)(Selector >> 8));
+        Data.Add((uint8)Selector);
+    }
+    Data.Append(Root.Head);
+    Data.Append(Root.Tail);
+    return Data;
+}
+
+/**
+ * An ABI type parsed from a function signature. Only used by the string based EncodeCall().
+ */
+struct FHallidayAbiType
+{
+    enum class EKind : uint8
+    {
+        Address,
+        Bool,
+        String,
+        Bytes,
+        FixedBytes,
+        Uint,
+        Int,
+        Tuple,
+        Array,
+    };
+
+    EKind Kind = EKind::Tuple;
+
+    /** Bytes of a FixedBytes type or bits of an Uint or Int type. */
+    int32 Size = 0;
+
+    /** Length of a fixed-size array, or INDEX_NONE for T[]. */
+    int32 Length = INDEX_NONE;
+
+    /** Members of a tuple, or the element type of an array. */
+    TArray<FHallidayAbiType> Components;
+};
+
+/**
+ * Parse a decimal number that ends at a non-digit character.
+ * @returns False if there are no digits or the number has a leading zero.
+ */
+static bool ParseSize(const TCHAR*& Chars, int32& OutSize)
+{
+    const TCHAR* Start = Chars;
+    OutSize = 0;
+    while (FChar::IsDigit(*Chars) && Chars - Start < 6)
+    {
+        OutSize = OutSize * 10 + (*Chars - '0');
+        ++Chars;
+    }
+    return Chars != Start && !(*Start == '0' && Chars - Start > 1);
+}
+
+/**
+ * Parse one type of a function signature and append its canonical form.
+ * @param Chars Characters of the signature. Advanced past the type.
+ * @param OutType Receives the type.
+ * @param OutCanonical Receives the canonical form of the type, e.g. "uint256" for "uint".
+ * @returns False if the type is malformed.
+ */
+static bool ParseAbiType(const TCHAR*& Chars, FHallidayAbiType& OutType, FString& OutCanonical)
+{
+    while (*Chars == ' ')
+    {
+        ++Chars;
+    }
+
+    if (*Chars == '(')
+    {
+        ++Chars;
+        OutType.Kind = FHallidayAbiType::EKind::Tuple;
+        OutCanonical += TEXT("(");
+        while (*Chars == ' ')
+        {
+            ++Chars;
+        }
+        if (*Chars != ')')
+        {
+            for (;;)
+            {
+                if (!ParseAbiType(Chars, OutType.Components.AddDefaulted_GetRef(), OutCanonical))
+                {
+                    return false;
+                }
+                while (*Chars == ' ')
+                {
+                    ++Chars;
+                }
+                if (*Chars == ')')
+                {
+                    break;
+                }
+                if (*Chars != ',')
+                {
+                    return false;
+                }
+                OutCanonical += TEXT(",");
+                ++Chars;
+            }
+        }
+        ++Chars;
+        OutCanonical += TEXT(")");
+    }
+    else
+    {
+        const TCHAR* Start = Chars;
+        while (FChar::IsLower(*Chars))
+        {
+            ++Chars;
+        }
+        const FString Name(Chars - Start, Start);
+
+        if (Name == TEXT("address") || Name == TEXT("bool") || Name == TEXT("string"))
+        {
+            OutType.Kind = Name[0] == 'a' ? FHallidayAbiType::EKind::Address : Name[0] == 'b' ? FHallidayAbiType::EKind::Bool : FHallidayAbiType::EKind::String;
+            OutCanonical += Name;
+        }
+        else if (Name == TEXT("bytes"))
+        {
+            OutType.Kind = FChar::IsDigit(*Chars) ? FHallidayAbiType::EKind::FixedBytes : FHallidayAbiType::EKind::Bytes;
+            if (OutType.Kind == FHallidayAbiType::EKind::FixedBytes && (!ParseSize(Chars, OutType.Size) || OutType.Size < 1 || OutType.Size > 32))
+            {
+                return false;
+            }
+            OutCanonical += OutType.Kind == FHallidayAbiType::EKind::FixedBytes ? FString::Printf(TEXT("bytes%d"), OutType.Size) : Name;
+        }
+        else if (Name == TEXT("uint") || Name == TEXT("int"))
+        {
+            OutType.Kind = Name[0] == 'u' ? FHallidayAbiType::EKind::Uint : FHallidayAbiType::EKind::Int;
+            OutType.Size = 256;
+            if (FChar::IsDigit(*Chars) && (!ParseSize(Chars, OutType.Size) || OutType.Size < 8 || OutType.Size > 256 || OutType.Size % 8 != 0))
+            {
+                return false;
+            }
+            OutCanonical += FString::Printf(TEXT("%s%d"), *Name, OutType.Size);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // Wrap the type in one array per suffix, e.g. "uint256[2][]" is a T[] of uint256[2].
+    while (*Chars == '[')
+    {
+        ++Chars;
+        FHallidayAbiType ElementType = MoveTemp(OutType);
+        OutType = FHallidayAbiType();
+        OutType.Kind = FHallidayAbiType::EKind::Array;
+        OutType.Components.Add(MoveTemp(ElementType));
+        if (*Chars != ']')
+        {
+            if (!ParseSize(Chars, OutType.Length) || OutType.Length == 0 || *Chars != ']')
+            {
+                return false;
+            }
+            OutCanonical += FString::Printf(TEXT("[%d]"), OutType.Length);
+        }
+        else
+        {
+            OutCanonical += TEXT("[]");
+        }
+        ++Chars;
+    }
+    return true;
+}
+
+/**
+ * Split the inside of an array or tuple value at the commas that are not nested in brackets, parentheses or quotes.
+ * @param Value Value including its enclosing brackets or parentheses.
+ * @param OutElements Receives the trimmed elements.
+ */
+static void SplitCompositeValue(const FString& Value, TArray<FString>& OutElements)
+{
+    OutElements.Reset();
+    const FString Inner = Value.Mid(1, Value.Len() - 2);
+    if (Inner.TrimStartAndEnd().IsEmpty())
+    {
+        return;
+    }
+
+    int32 Nesting = 0;
+    bool bInQuotes = false;
+    int32 Start = 0;
+    for (int32 i = 0; i < Inner.Len(); ++i)
+    {
+        const TCHAR Char = Inner[i];
+        if (bInQuotes)
+        {
+            if (Char == '\\')
+            {
+                ++i;
+            }
+            else if (Char == '"')
+            {
+                bInQuotes = false;
+            }
+        }
+        else if (Char == '"')
+        {
+            bInQuotes = true;
+        }
+        else if (Char == '[' || Char == '(')
+        {
+            ++Nesting;
+        }
+        else if (Char == ']' || Char == ')')
+        {
+            --Nesting;
+        }
+        else if (Char == ',' && Nesting == 0)
+        {
+            OutElements.Add(Inner.Mid(Start, i - Start).TrimStartAndEnd());
+            Start = i + 1;
+        }
+    }
+    OutElements.Add(Inner.Mid(Start).TrimStartAndEnd());
+}
+
+/**
+ * Encode a value given as a string.
+ * @param Encoder Encoder to add the value to.
+ * @param Type Type of the value.
+ * @param Value Value to encode. Strings nested in arrays or tuples must be in double quotes.
+ * @param bIsNested Whether the value is an element of an array or tuple value.
+ * @returns False if the value does not match its type.
+ */
+static bool EncodeAbiValue(FHallidayAbiEncoder& Encoder, const FHallidayAbiType& Type, const FString& Value, bool bIsNested)
+{
+    switch (Type.Kind)
+    {
+    case FHallidayAbiType::EKind::Address:
+    {
+        FHallidayAddress Address;
+        if (!FHallidayAddress::FromString(Value, Address))
+        {
+            return false;
+        }
+        Encoder.AddAddress(Address);
+        return true;
+    }
+    case FHallidayAbiType::EKind::Bool:
+        if (Value != TEXT("true") && Value != TEXT("false") && Value != TEXT("1") && Value != TEXT("0"))
+        {
+            return false;
+        }
+        Encoder.AddBool(Value == TEXT("true") || Value == TEXT("1"));
+        return true;
+    case FHallidayAbiType::EKind::String:
+        if (bIsNested)
+        {
+            if (Value.Len() < 2 || !Value.StartsWith(TEXT("\"")) || !Value.EndsWith(TEXT("\"")))
+            {
+                return false;
+            }
+            Encoder.AddString(Value.Mid(1, Value.Len() - 2).ReplaceEscapedCharWithChar());
+        }
+        else
+        {
+            Encoder.AddString(Value);
+        }
+        return true;
+    case FHallidayAbiType::EKind::Bytes:
+    {
+        TArray<uint8> Bytes;
+        if (!FHallidayHex::Decode(Value, Bytes))
+        {
+            return false;
+        }
+        Encoder.AddBytes(Bytes.GetData(), Bytes.Num());
+        return true;
+    }
+    case FHallidayAbiType::EKind::FixedBytes:
+    {
+        uint8 Bytes[FHallidayAbiEncoder::WordSize];
+        if (!FHallidayHex::Decode(Value, Bytes, Type.Size))
+        {
+            return false;
+        }
+        Encoder.AddFixedBytes(Bytes, Type.Size);
+        return true;
+    }
+    case FHallidayAbiType::EKind::Uint:
+    case FHallidayAbiType::EKind::Int:
+    {
+        FHallidayUint256 Word;
+        const bool bIsValid = Type.Kind == FHallidayAbiType::EKind::Uint ? FHallidayAbiEncoder::ParseUint(Value, Type.Size, Word.Bytes) : FHallidayAbiEncoder::ParseInt(Value, Type.Size, Word.Bytes);
+        if (!bIsValid)
+        {
+            return false;
+        }
+        Encoder.AddUint(Word);
+        return true;
+    }
+    case FHallidayAbiType::EKind::Tuple:
+    case FHallidayAbiType::EKind::Array:
+    {
+        const bool bIsTuple = Type.Kind == FHallidayAbiType::EKind::Tuple;
+        if (Value.Len() < 2 || Value[0] != (bIsTuple ? '(' : '[') || Value[Value.Len() - 1] != (bIsTuple ? ')' : ']'))
+        {
+            return false;
+        }
+
+        TArray<FString> Elements;
+        SplitCompositeValue(Value, Elements);
+        const int32 ExpectedNum = bIsTuple ? Type.Components.Num() : Type.Length;
+        if (ExpectedNum != INDEX_NONE && Elements.Num() != ExpectedNum)
+        {
+            return false;
+        }
+
+        // Only T[] carries a length. Tuples and T[k] are encoded the same way.
+        const bool bIsDynamicArray = !bIsTuple && Type.Length == INDEX_NONE;
+        if (bIsDynamicArray)
+        {
+            Encoder.BeginArray();
+        }
+        else
+        {
+            Encoder.BeginTuple();
+        }
+        for (int32 i = 0; i < Elements.Num(); ++i)
+        {
+            if (!EncodeAbiValue(Encoder, bIsTuple ? Type.Components[i] : Type.Components[0], Elements[i], true))
+            {
+                return false;
+            }
+        }
+        if (bIsDynamicArray)
+        {
+            Encoder.EndArray();
+        }
+        else
+        {
+            Encoder.EndTuple();
+        }
+        return true;
+    }
+    }
+    return false;
+}
+
+bool FHallidayAbiEncoder::EncodeCall(const FString& FunctionSignature, const TArray<FString>& Arguments)
+{
+    int32 OpenIndex = INDEX_NONE;
+    if (!FunctionSignature.FindChar('(', OpenIndex))
+    {
+        return false;
+    }
+
+    // Parse the parameters as one tuple and rebuild the canonical signature that the selector is computed from.
+    FString Canonical = FunctionSignature.Left(OpenIndex).TrimStartAndEnd();
+    FHallidayAbiType Parameters;
+    const TCHAR* Chars = *FunctionSignature + OpenIndex;
+    if (Canonical.IsEmpty() || !ParseAbiType(Chars, Parameters, Canonical) || Parameters.Kind != FHallidayAbiType::EKind::Tuple || *Chars != '\0')
+    {
+        return false;
+    }
+    if (Arguments.Num() != Parameters.Components.Num())
+    {
+        return false;
+    }
+
+    Begin(ComputeSelector(Canonical));
+    for (int32 i = 0; i < Arguments.Num(); ++i)
+    {
+        // Top level strings are taken verbatim, so only trim the other arguments.
+        const FHallidayAbiType& Type = Parameters.Components[i];
+        if (!EncodeAbiValue(*this, Type, Type.Kind == FHallidayAbiType::EKind::String ? Arguments[i] : Arguments[i].TrimStartAndEnd(), false))
+        {
+            return false;
+        }
+    }
+    Finish();
+    return true;
+}
@@ -0,0 +1,277 @@
+#include "HallidayEip712.h"
+#include "HallidayAbi.h"
+#include "HallidayHex.h"
+#include "HallidayKeccak.h"
+
+/**
+ * Check whether a character may appear in a type or member name.
+ */
+static bool IsIdentifierChar(TCHAR Char)
+{
+    return FChar::IsAlnum(Char) || Char == '_' || Char == '$';
+}
+
+/**
+ * Parse the size suffix of a type such as "uint64" or "bytes4".
+ * @param Suffix Characters after the type prefix.
+ * @param OutSize Receives the size.
+ * @returns False if the suffix is empty or not a number.
+ */
+static bool ParseTypeSize(const FString& Suffix, int32& OutSize)
+{
+    if (Suffix.IsEmpty() || Suffix.Len() > 3 || Suffix[0] == '0')
+    {
+        return false;
+    }
+    for (const TCHAR Char : Suffix)
+    {
+        if (!FChar::IsDigit(Char))
+        {
+            return false;
+        }
+    }
+    OutSize = FCString::Atoi(*Suffix);
+    return true;
+}
+
+void FHallidayEip712::HashPersonalMessage(const uint8* Message, int32 Size, FHallidayHash32& OutHash)
+{
+    const FTCHARToUTF8 Prefix(*FString::Printf(TEXT("\x19" "Ethereum Signed Message:\n%d"), Size));
+
+    FHallidayKeccak256 Hasher;
+    Hasher.Update((const uint8*)Prefix.Get(), Prefix.Length());
+    Hasher.Update(Message, Size);
+    Hasher.Final(OutHash.Bytes);
+}
+
+void FHallidayEip712::HashTypedData(const FHallidayHash32& DomainSeparator, const FHallidayHash32& StructHash, FHallidayHash32& OutHash)
+{
+    uint8 Encoded[2 + 2 * FHallidayHash32::Size];
+    Encoded[0] = 0x19;
+    Encoded[1] = 0x01;
+    FMemory::Memcpy(Encoded + 2, DomainSeparator.Bytes, FHallidayHash32::Size);
+    FMemory::Memcpy(Encoded + 2 + FHallidayHash32::Size, StructHash.Bytes, FHallidayHash32::Size);
+    FHallidayKeccak256::Hash(Encoded, sizeof(Encoded), OutHash.Bytes);
+}
+
+bool FHallidayEip712Type::Parse(const FString& EncodedType, FHallidayEip712Type& OutType)
+{
+    OutType.Members.Reset();
+
+    int32 OpenIndex = INDEX_NONE;
+    if (!EncodedType.FindChar('(', OpenIndex) || !EncodedType.TrimEnd().EndsWith(TEXT(")")))
+    {
+        return false;
+    }
+
+    const FString Name = EncodedType.Left(OpenIndex).TrimStartAndEnd();
+    if (Name.IsEmpty() || FChar::IsDigit(Name[0]) || Name.Contains(TEXT(" ")))
+    {
+        return false;
+    }
+
+    FString Body = EncodedType.Mid(OpenIndex + 1).TrimEnd();
+    Body.LeftChopInline(1);
+
+    TArray<FString> Declarations;
+    Body.ParseIntoArray(Declarations, TEXT(","), false);
+    if (Body.TrimStartAndEnd().IsEmpty())
+    {
+        Declarations.Reset();
+    }
+
+    FString Canonical = Name + TEXT("(");
+    for (int32 i = 0; i < Declarations.Num(); ++i)
+    {
+        FString MemberType;
+        FString MemberName;
+        if (!Declarations[i].TrimStartAndEnd().Split(TEXT(" "), &MemberType, &MemberName))
+        {
+            return false;
+        }
+        MemberName.TrimStartInline();
+        if (MemberName.IsEmpty() || FChar::IsDigit(MemberName[0]))
+        {
+            return false;
+        }
+        for (const TCHAR Char : MemberName)
+        {
+            if (!IsIdentifierChar(Char))
+            {
+                return false;
+            }
+        }
+
+        FMember Member;
+        Member.Size = 0;
+        if (MemberType == TEXT("address"))
+        {
+            Member.Kind = EMemberKind::Address;
+        }
+        else if (MemberType == TEXT("bool"))
+        {
+            Member.Kind = EMemberKind::Bool;
+        }
+        else if (MemberType == TEXT("string"))
+        {
+            Member.Kind = EMemberKind::String;
+        }
+        else if (MemberType == TEXT("bytes"))
+        {
+            Member.Kind = EMemberKind::Bytes;
+        }
+        else if (MemberType.StartsWith(TEXT("bytes"), ESearchCase::CaseSensitive))
+        {
+            Member.Kind = EMemberKind::FixedBytes;
+            if (!ParseTypeSize(MemberType.Mid(5), Member.Size) || Member.Size > 32)
+            {
+                return false;
+            }
+        }
+        else if (MemberType.StartsWith(TEXT("uint"), ESearchCase::CaseSensitive) || MemberType.StartsWith(TEXT("int"), ESearchCase::CaseSensitive))
+        {
+            const bool bIsSigned = MemberType[0] == 'i';
+            Member.Kind = bIsSigned ? EMemberKind::Int : EMemberKind::Uint;
+            if (!ParseTypeSize(MemberType.Mid(bIsSigned ? 3 : 4), Member.Size) || Member.Size > 256 || Member.Size % 8 != 0)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // Arrays and references to other struct types would need the referenced types to be encoded as well.
+            return false;
+        }
+
+        OutType.Members.Add(Member);
+        if (i > 0)
+        {
+            Canonical += TEXT(",");
+        }
+        Canonical += MemberType + TEXT(" ") + MemberName;
+    }
+    Canonical += TEXT(")");
+
+    const FTCHARToUTF8 CanonicalUtf8(*Canonical);
+    FHallidayKeccak256::Hash((const uint8*)CanonicalUtf8.Get(), CanonicalUtf8.Length(), OutType.TypeHash.Bytes);
+    OutType.EncodedType = MoveTemp(Canonical);
+    return true;
+}
+
+bool FHallidayEip712Type::HashDomain(const FHallidayEip712Domain& Domain, FHallidayHash32& OutDomainSeparator)
+{
+    TArray<FString> Declarations;
+    TArray<FString> Values;
+    if (!Domain.Name.IsEmpty())
+    {
+        Declarations.Add(TEXT("string name"));
+        Values.Add(Domain.Name);
+    }
+    if (!Domain.Version.IsEmpty())
+    {
+        Declarations.Add(TEXT("string version"));
+        Values.Add(Domain.Version);
+    }
+    if (Domain.ChainId != 0)
+    {
+        Declarations.Add(TEXT("uint256 chainId"));
+        Values.Add(FString::Printf(TEXT("%lld"), Domain.ChainId));
+    }
+    if (!Domain.VerifyingContract.IsEmpty())
+    {
+        Declarations.Add(TEXT("address verifyingContract"));
+        Values.Add(Domain.VerifyingContract);
+    }
+    if (!Domain.Salt.IsEmpty())
+    {
+        Declarations.Add(TEXT("bytes32 salt"));
+        Values.Add(Domain.Salt);
+    }
+
+    FHallidayEip712Type DomainType;
+    return Parse(TEXT("EIP712Domain(") + FString::Join(Declarations, TEXT(",")) + TEXT(")"), DomainType) &&
+        DomainType.HashStruct(Values, OutDomainSeparator);
+}
+
+bool FHallidayEip712Type::HashStruct(const TArray<FString>& Values, FHallidayHash32& OutStructHash) const
+{
+    if (Values.Num() != Members.Num())
+    {
+        return false;
+    }
+
+    // encodeData is the type hash followed by one 32 byte word per member.
+    TArray<uint8, TInlineAllocator<32 * 9>> Encoded;
+    Encoded.SetNumZeroed((Members.Num() + 1) * 32);
+    FMemory::Memcpy(Encoded.GetData(), TypeHash.Bytes, FHallidayHash32::Size);
+
+    for (int32 i = 0; i < Members.Num(); ++i)
+    {
+        const FMember& Member = Members[i];
+        const FString& Value = Values[i];
+        uint8* Word = Encoded.GetData() + (i + 1) * 32;
+
+        switch (Member.Kind)
+        {
+        case EMemberKind::Address:
+        {
+            FHallidayAddress Address;
+            if (!FHallidayAddress::FromString(Value, Address))
+            {
+                return false;
+            }
+            FMemory::Memcpy(Word + 12, Address.Bytes, FHallidayAddress::Size);
+            break;
+        }
+        case EMemberKind::Bool:
+            if (Value == TEXT("true") || Value == TEXT("1"))
+            {
+                Word[31] = 1;
+            }
+            else if (Value != TEXT("false") && Value != TEXT("0"))
+            {
+                return false;
+            }
+            break;
+        case EMemberKind::String:
+        {
+            // Dynamic values are encoded as the hash of their UTF-8 bytes.
+            const FTCHARToUTF8 Utf8(*Value);
+            FHallidayKeccak256::Hash((const uint8*)Utf8.Get(), Utf8.Length(), Word);
+            break;
+        }
+        case EMemberKind::Bytes:
+        {
+            TArray<uint8> Bytes;
+            if (!FHallidayHex::Decode(Value, Bytes))
+            {
+                return false;
+            }
+            FHallidayKeccak256::Hash(Bytes.GetData(), Bytes.Num(), Word);
+            break;
+        }
+        case EMemberKind::FixedBytes:
+            // Fixed bytes are left-aligned and padded with zeros on the right.
+            if (!FHallidayHex::Decode(Value, Word, Member.Size))
+            {
+                return false;
+            }
+            break;
+        case EMemberKind::Uint:
+            if (!FHallidayAbiEncoder::ParseUint(Value, Member.Size, Word))
+            {
+                return false;
+            }
+            break;
+        case EMemberKind::Int:
+            if (!FHallidayAbiEncoder::ParseInt(Value, Member.Size, Word))
+            {
+                return false;
+            }
+            break;
+        }
+    }
+
+    FHallidayKeccak256::Hash(Encoded.GetData(), Encoded.Num(), OutStructHash.Bytes);
+    return true;
+}
@@ -0,0 +1,264 @@
+#include "HallidayHex.h"
+
+// The vector kernels widen and narrow between bytes and 16 bit characters, so they are only used where TCHAR is 2 bytes.
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON && !PLATFORM_TCHAR_IS_4_BYTES
+#include <arm_neon.h>
+#define HALLIDAY_HEX_NEON 1
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY && !PLATFORM_TCHAR_IS_4_BYTES
+#include <emmintrin.h>
+#define HALLIDAY_HEX_SSE2 1
+#endif
+
+#ifndef HALLIDAY_HEX_NEON
+#define HALLIDAY_HEX_NEON 0
+#endif
+#ifndef HALLIDAY_HEX_SSE2
+#define HALLIDAY_HEX_SSE2 0
+#endif
+
+/** Lowercase hex digits indexed by nibble. */
+static const TCHAR HexDigits[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+};
+
+/**
+ * Convert a character into its nibble value.
+ * @param Char Character to convert
+ * @returns The nibble value of the character, or -1 if it is not a hex digit.
+ */
+static FORCEINLINE int32 CharToNibble(TCHAR Char)
+{
+    if (Char >= '0' && Char <= '9') return Char - '0';
+    if (Char >= 'a' && Char <= 'f') return 10 + Char - 'a';
+    if (Char >= 'A' && Char <= 'F') return 10 + Char - 'A';
+    return -1;
+}
+
+#if HALLIDAY_HEX_SSE2
+/** Convert 16 nibbles into their lowercase hex digits. */
+static FORCEINLINE __m128i NibblesToAscii(__m128i Nibbles)
+{
+    const __m128i IsLetter = _mm_cmpgt_epi8(Nibbles, _mm_set1_epi8(9));
+    const __m128i Digits = _mm_add_epi8(Nibbles, _mm_set1_epi8('0'));
+    return _mm_add_epi8(Digits, _mm_and_si128(IsLetter, _mm_set1_epi8('a' - '0' - 10)));
+}
+
+/** Encode 16 bytes into 32 characters. */
+static FORCEINLINE void Encode16(const uint8* Bytes, TCHAR* OutChars)
+{
+    const __m128i Input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Bytes));
+    const __m128i LowMask = _mm_set1_epi8(0x0f);
+    const __m128i High = NibblesToAscii(_mm_and_si128(_mm_srli_epi16(Input, 4), LowMask));
+    const __m128i Low = NibblesToAscii(_mm_and_si128(Input, LowMask));
+    
+    // Interleave the high and low digits of every byte and widen them to 16 bit characters.
+    const __m128i First = _mm_unpacklo_epi8(High, Low);
+    const __m128i Second = _mm_unpackhi_epi8(High, Low);
+    const __m128i Zero = _mm_setzero_si128();
+    __m128i* Out = reinterpret_cast<__m128i*>(OutChars);
+    _mm_storeu_si128(Out + 0, _mm_unpacklo_epi8(First, Zero));
+    _mm_storeu_si128(Out + 1, _mm_unpackhi_epi8(First, Zero));
+    _mm_storeu_si128(Out + 2, _mm_unpacklo_epi8(Second, Zero));
+    _mm_storeu_si128(Out + 3, _mm_unpackhi_epi8(Second, Zero));
+}
+
+/** Convert 16 characters into nibbles. Sets bOutValid to false if any character is not a hex digit. */
+static FORCEINLINE __m128i AsciiToNibbles(__m128i Chars, bool& bOutValid)
+{
+    // An unsigned "x < n" is done as a saturating "x - (n - 1) == 0" because SSE2 only has signed byte compares.
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i Digit = _mm_sub_epi8(Chars, _mm_set1_epi8('0'));
+    const __m128i IsDigit = _mm_cmpeq_epi8(_mm_subs_epu8(Digit, _mm_set1_epi8(9)), Zero);
+    const __m128i Letter = _mm_sub_epi8(_mm_or_si128(Chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i IsLetter = _mm_cmpeq_epi8(_mm_subs_epu8(Letter, _mm_set1_epi8(5)), Zero);
+    
+    bOutValid &= _mm_movemask_epi8(_mm_or_si128(IsDigit, IsLetter)) == 0xffff;
+    return _mm_or_si128(_mm_and_si128(IsDigit, Digit), _mm_and_si128(IsLetter, _mm_add_epi8(Letter, _mm_set1_epi8(10))));
+}
+
+/** Combine pairs of nibbles held in the two bytes of each 16 bit lane into one byte per lane. */
+static FORCEINLINE __m128i CombineNibblePairs(__m128i Nibbles)
+{
+    const __m128i High = _mm_slli_epi16(_mm_and_si128(Nibbles, _mm_set1_epi16(0x00ff)), 4);
+    return _mm_or_si128(High, _mm_srli_epi16(Nibbles, 8));
+}
+
+/** Decode 32 characters into 16 bytes. */
+static FORCEINLINE bool Decode16(const TCHAR* Chars, uint8* OutBytes)
+{
+    // Narrow the characters to bytes. Anything above 0xff saturates to 0xff which is rejected below.
+    const __m128i* In = reinterpret_cast<const __m128i*>(Chars);
+    const __m128i First = _mm_packus_epi16(_mm_loadu_si128(In + 0), _mm_loadu_si128(In + 1));
+    const __m128i Second = _mm_packus_epi16(_mm_loadu_si128(In + 2), _mm_loadu_si128(In + 3));
+    
+    bool bIsValid = true;
+    const __m128i FirstBytes = CombineNibblePairs(AsciiToNibbles(First, bIsValid));
+    const __m128i SecondBytes = CombineNibblePairs(AsciiToNibbles(Second, bIsValid));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(OutBytes), _mm_packus_epi16(FirstBytes, SecondBytes));
+    return bIsValid;
+}
+#endif
+
+#if HALLIDAY_HEX_NEON
+/** Convert 16 nibbles into their lowercase hex digits. */
+static FORCEINLINE uint8x16_t NibblesToAscii(uint8x16_t Nibbles)
+{
+    const uint8x16_t IsLetter = vcgtq_u8(Nibbles, vdupq_n_u8(9));
+    const uint8x16_t Digits = vaddq_u8(Nibbles, vdupq_n_u8('0'));
+    return vaddq_u8(Digits, vandq_u8(IsLetter, vdupq_n_u8('a' - '0' - 10)));
+}
+
+/** Encode 16 bytes into 32 characters. */
+static FORCEINLINE void Encode16(const uint8* Bytes, TCHAR* OutChars)
+{
+    const uint8x16_t Input = vld1q_u8(Bytes);
+    const uint8x16_t High = NibblesToAscii(vshrq_n_u8(Input, 4));
+    const uint8x16_t Low = NibblesToAscii(vandq_u8(Input, vdupq_n_u8(0x0f)));
+    
+    // Interleave the high and low digits of every byte and widen them to 16 bit characters.
+    const uint8x16x2_t Interleaved = vzipq_u8(High, Low);
+    uint16_t* Out = reinterpret_cast<uint16_t*>(OutChars);
+    vst1q_u16(Out + 0, vmovl_u8(vget_low_u8(Interleaved.val[0])));
+    vst1q_u16(Out + 8, vmovl_u8(vget_high_u8(Interleaved.val[0])));
+    vst1q_u16(Out + 16, vmovl_u8(vget_low_u8(Interleaved.val[1])));
+    vst1q_u16(Out + 24, vmovl_u8(vget_high_u8(Interleaved.val[1])));
+}
+
+/** Convert 16 characters into nibbles. Sets bOutValid to false if any character is not a hex digit. */
+static FORCEINLINE uint8x16_t AsciiToNibbles(uint8x16_t Chars, bool& bOutValid)
+{
+    const uint8x16_t Digit = vsubq_u8(Chars, vdupq_n_u8('0'));
+    const uint8x16_t IsDigit = vcltq_u8(Digit, vdupq_n_u8(10));
+    const uint8x16_t Letter = vsubq_u8(vorrq_u8(Chars, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    const uint8x16_t IsLetter = vcltq_u8(Letter, vdupq_n_u8(6));
+    
+    const uint8x16_t IsValid = vorrq_u8(IsDigit, IsLetter);
+    const uint8x8_t BothHalves = vand_u8(vget_low_u8(IsValid), vget_high_u8(IsValid));
+    bOutValid &= vget_lane_u64(vreinterpret_u64_u8(BothHalves), 0) == ~(uint64_t)0;
+    return vorrq_u8(vandq_u8(IsDigit, Digit), vandq_u8(IsLetter, vaddq_u8(Letter, vdupq_n_u8(10))));
+}
+
+/** Decode 32 characters into 16 bytes. */
+static FORCEINLINE bool Decode16(const TCHAR* Chars, uint8* OutBytes)
+{
+    // Narrow the characters to bytes. Anything above 0xff saturates to 0xff which is rejected below.
+    const uint16_t* In = reinterpret_cast<const uint16_t*>(Chars);
+    const uint8x16_t First = vcombine_u8(vqmovn_u16(vld1q_u16(In + 0)), vqmovn_u16(vld1q_u16(In + 8)));
+    const uint8x16_t Second = vcombine_u8(vqmovn_u16(vld1q_u16(In + 16)), vqmovn_u16(vld1q_u16(In + 24)));
+    
+    bool bIsValid = true;
+    const uint8x16x2_t Nibbles = vuzpq_u8(AsciiToNibbles(First, bIsValid), AsciiToNibbles(Second, bIsValid));
+    vst1q_u8(OutBytes, vorrq_u8(vshlq_n_u8(Nibbles.val[0], 4), Nibbles.val[1]));
+    return bIsValid;
+}
+#endif
+
+void FHallidayHex::EncodeChars(const uint8* Bytes, int32 Size, TCHAR* OutChars)
+{
+    int32 i = 0;
+#if HALLIDAY_HEX_SSE2 || HALLIDAY_HEX_NEON
+    for (; i + 16 <= Size; i += 16)
+    {
+        Encode16(Bytes + i, OutChars + i * 2);
+    }
+#endif
+    for (; i < Size; ++i)
+    {
+        OutChars[i * 2] = HexDigits[Bytes[i] >> 4];
+        OutChars[i * 2 + 1] = HexDigits[Bytes[i] & 0x0f];
+    }
+}
+
+bool FHallidayHex::DecodeChars(const TCHAR* Chars, int32 Size, uint8* OutBytes)
+{
+    bool bIsValid = true;
+    int32 i = 0;
+#if HALLIDAY_HEX_SSE2 || HALLIDAY_HEX_NEON
+    for (; i + 16 <= Size; i += 16)
+    {
+        bIsValid &= Decode16(Chars + i * 2, OutBytes + i);
+    }
+#endif
+    for (; i < Size; ++i)
+    {
+        const int32 HighNibble = CharToNibble(Chars[i * 2]);
+        const int32 LowNibble = CharToNibble(Chars[i * 2 + 1]);
+        bIsValid &= (HighNibble | LowNibble) >= 0;
+        OutBytes[i] = (uint8)((HighNibble << 4) | (LowNibble & 0x0f));
+    }
+    return bIsValid;
+}
+
+FString FHallidayHex::Encode(const uint8* Bytes, int32 Size, bool bWithPrefix)
+{
+    const int32 PrefixLen = bWithPrefix ? 2 : 0;
+    const int32 Len = PrefixLen + Size * 2;
+    
+    FString HexString;
+    TArray<TCHAR>& CharArray = HexString.GetCharArray();
+    CharArray.SetNumUninitialized(Len + 1);
+    TCHAR* Chars = CharArray.GetData();
+    if (bWithPrefix)
+    {
+        Chars[0] = '0';
+        Chars[1] = 'x';
+    }
+    EncodeChars(Bytes, Size, Chars + PrefixLen);
+    Chars[Len] = '\0';
+    return HexString;
+}
+
+bool FHallidayHex::Decode(const FString& HexString, uint8* OutBytes, int32 Size)
+{
+    const int32 Start = HexString.StartsWith(TEXT("0x")) ? 2 : 0;
+    if (HexString.Len() - Start != Size * 2)
+    {
+        return false;
+    }
+    return DecodeChars(*HexString + Start, Size, OutBytes);
+}
+
+bool FHallidayHex::Decode(const FString& HexString, TArray<uint8>& OutBytes)
+{
+    const int32 Start = HexString.StartsWith(TEXT("0x")) ? 2 : 0;
+    const int32 NumChars = HexString.Len() - Start;
+    if (NumChars % 2 != 0)
+    {
+        OutBytes.Reset();
+        return false;
+    }
+    
+    OutBytes.SetNumUninitialized(NumChars / 2);
+    if (!DecodeChars(*HexString + Start, OutBytes.Num(), OutBytes.GetData()))
+    {
+        OutBytes.Reset();
+        return false;
+    }
+    return true;
+}
+
+bool FHallidayHex::DecodeNumber(const FString& HexString, uint8* OutBytes, int32 Size)
+{
+    const int32 Start = HexString.StartsWith(TEXT("0x")) ? 2 : 0;
+    const int32 NumChars = HexString.Len() - Start;
+    if (NumChars > Size * 2)
+    {
+        return false;
+    }
+    
+    // Right-align the value and decode a leading odd nibble on its own.
+    const TCHAR* Chars = *HexString + Start;
+    uint8* Out = OutBytes + Size - (NumChars + 1) / 2;
+    FMemory::Memzero(OutBytes, Size);
+    if (NumChars % 2 != 0)
+    {
+        const TCHAR PaddedNibble[2] = { '0', Chars[0] };
+        if (!DecodeChars(PaddedNibble, 1, Out))
+        {
+            return false;
+        }
+        ++Chars;
+        ++Out;
+    }
+    return DecodeChars(Chars, NumChars / 2, Out);
+}
@@ -0,0 +1,131 @@
+#include "HallidayHttpCompression.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+const TCHAR* const FHallidayHttpCompression::AcceptEncoding = TEXT("gzip, deflate");
+
+/**
+ * Check whether a body starts like the JSON the backend sends, i.e. it was already decoded.
+ */
+static bool LooksLikeJson(const TArray<uint8>& Content)
+{
+    for (const uint8 Byte : Content)
+    {
+        if (Byte != ' ' && Byte != '\t' && Byte != '\r' && Byte != '\n')
+        {
+            return Byte == '{' || Byte == '[' || Byte == '"';
+        }
+    }
+    return true;
+}
+
+/**
+ * Check whether data starts with a zlib header, which is what RFC 9110 means by deflate. Some servers send raw deflate data without it.
+ */
+static bool HasZlibHeader(const TArray<uint8>& Content)
+{
+    return Content.Num() >= 2 && (Content[0] & 0x0f) == Z_DEFLATED && ((Content[0] << 8) | Content[1]) % 31 == 0;
+}
+
+const TArray<uint8>* FHallidayHttpCompression::GetContent(const IHttpResponse& Response, TArray<uint8>& Buffer, bool& bOutWasDecoded)
+{
+    bOutWasDecoded = false;
+    const TArray<uint8>& Content = Response.GetContent();
+
+    const FString Encoding = Response.GetHeader(TEXT("Content-Encoding")).TrimStartAndEnd();
+    bool bIsRawDeflate = false;
+    if (Encoding.Equals(TEXT("gzip"), ESearchCase::IgnoreCase) || Encoding.Equals(TEXT("x-gzip"), ESearchCase::IgnoreCase))
+    {
+        // Every gzip member starts with the magic bytes 1f 8b.
+        if (Content.Num() < 2 || Content[0] != 0x1f || Content[1] != 0x8b)
+        {
+            return &Content;
+        }
+    }
+    else if (Encoding.Equals(TEXT("deflate"), ESearchCase::IgnoreCase))
+    {
+        if (!HasZlibHeader(Content))
+        {
+            if (LooksLikeJson(Content))
+            {
+                return &Content;
+            }
+            bIsRawDeflate = true;
+        }
+    }
+    else
+    {
+        return &Content;
+    }
+
+    if (!Inflate(Content.GetData(), Content.Num(), bIsRawDeflate, Buffer))
+    {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to decode a %d byte '%s' response from '%s'."), Content.Num(), *Encoding, *Response.GetURL());
+        return nullptr;
+    }
+    bOutWasDecoded = true;
+    return &Buffer;
+}
+
+FString FHallidayHttpCompression::GetContentAsString(const IHttpResponse& Response)
+{
+    TArray<uint8> Buffer;
+    bool bWasDecoded = false;
+    const TArray<uint8>* Content = GetContent(Response, Buffer, bWasDecoded);
+    return Content ? ToString(*Content) : FString();
+}
+
+FString FHallidayHttpCompression::ToString(const TArray<uint8>& Content)
+{
+    const FUTF8ToTCHAR Converter((const ANSICHAR*)Content.GetData(), Content.Num());
+    return FString(Converter.Length(), Converter.Get());
+}
+
+bool FHallidayHttpCompression::Inflate(const uint8* Data, int32 Size, bool bIsRawDeflate, TArray<uint8>& OutData)
+{
+    OutData.Reset();
+
+    z_stream Stream;
+    FMemory::Memzero(Stream);
+    Stream.next_in = (Bytef*)Data;
+    Stream.avail_in = (uInt)Size;
+
+    // 15 + 32 accepts both gzip and zlib headers. -15 reads deflate data without a header.
+    if (inflateInit2(&Stream, bIsRawDeflate ? -MAX_WBITS : MAX_WBITS + 32) != Z_OK)
+    {
+        return false;
+    }
+
+    // JSON with repetitive rows usually shrinks by 5-10x, so start there and grow as needed.
+    OutData.SetNumUninitialized(FMath::Min(FMath::Max(Size * 8, 4096), MaxDecodedSize), false);
+
+    int Result = Z_OK;
+    while (Result == Z_OK)
+    {
+        if (Stream.total_out == (uLong)OutData.Num())
+        {
+            if (OutData.Num() >= MaxDecodedSize)
+            {
+                break;
+            }
+            OutData.SetNumUninitialized(FMath::Min(OutData.Num() * 2, MaxDecodedSize), false);
+        }
+
+        Stream.next_out = OutData.GetData() + Stream.total_out;
+        Stream.avail_out = (uInt)(OutData.Num() - Stream.total_out);
+        Result = inflate(&Stream, Z_NO_FLUSH);
+    }
+
+    const int32 DecodedSize = (int32)Stream.total_out;
+    inflateEnd(&Stream);
+    if (Result != Z_STREAM_END)
+    {
+        OutData.Reset();
+        return false;
+    }
+
+    OutData.SetNum(DecodedSize, false);
+    return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpResponse.h"
+
+/**
+ * Decoding of compressed response bodies.
+ * Requests that may return large bodies advertise AcceptEncoding. Some platforms' HTTP stacks decode such bodies themselves while others pass them on as received,
+ * and the Content-Encoding header is kept either way, so the body itself is checked before it is decoded.
+ */
+class FHallidayHttpCompression
+{
+public:
+    /** Value of the Accept-Encoding header for the encodings that can be decoded. */
+    static const TCHAR* const AcceptEncoding;
+
+    /** Largest decoded body that is accepted, so that a corrupt or malicious body cannot exhaust memory. */
+    static constexpr int32 MaxDecodedSize = 64 * 1024 * 1024;
+
+    /**
+     * Get the body of a response, decoding it if it is still compressed.
+     * @param Response Response to read.
+     * @param Buffer Receives the decoded body if the body had to be decoded.
+     * @param bOutWasDecoded Set to whether the body was decoded.
+     * @returns Either the content of the response or Buffer, or nullptr if the body is compressed but corrupt.
+     */
+    static const TArray<uint8>* GetContent(const IHttpResponse& Response, TArray<uint8>& Buffer, bool& bOutWasDecoded);
+
+    /**
+     * Get the body of a response as a string, decoding it if it is still compressed.
+     * @param Response Response to read.
+     * @returns The body, or an empty string if it is compressed but corrupt.
+     */
+    static FString GetContentAsString(const IHttpResponse& Response);
+
+    /**
+     * Convert a UTF-8 body to a string.
+     * @param Content Body to convert.
+     * @returns The body as a string.
+     */
+    static FString ToString(const TArray<uint8>& Content);
+
+    /**
+     * Inflate gzip, zlib or raw deflate data.
+     * @param Data Compressed bytes.
+     * @param Size Number of compressed bytes.
+     * @param bIsRawDeflate Whether the data has no gzip or zlib header.
+     * @param OutData Receives the inflated bytes.
+     * @returns False if the data is corrupt, truncated or inflates to more than MaxDecodedSize bytes.
+     */
+    static bool Inflate(const uint8* Data, int32 Size, bool bIsRawDeflate, TArray<uint8>& OutData);
+};
@@ -0,0 +1,80 @@
+#include "HallidayKeccak.h"
+
+/**
+ * Apply the 24 round Keccak-f[1600] permutation to the state.
+ * @param State 25 lanes of the Keccak state.
+ */
+static FORCEINLINE void KeccakF1600(uint64* State)
+{
+    FHallidayConstexprKeccak256::Permute(State);
+}
+
+FHallidayKeccak256::FHallidayKeccak256()
+{
+    Reset();
+}
+
+void FHallidayKeccak256::Reset()
+{
+    FMemory::Memzero(State, sizeof(State));
+    BlockOffset = 0;
+}
+
+void FHallidayKeccak256::Update(const uint8* Data, int64 Size)
+{
+    // Absorb byte by byte until the current block is lane aligned.
+    while (Size > 0 && (BlockOffset & 7) != 0)
+    {
+        State[BlockOffset >> 3] ^= (uint64)(*Data++) << ((BlockOffset & 7) * 8);
+        --Size;
+        if (++BlockOffset == Rate)
+        {
+            KeccakF1600(State);
+            BlockOffset = 0;
+        }
+    }
+    
+    // Absorb whole lanes. Every platform Unreal Engine ships on is little-endian so lanes can be loaded directly.
+    while (Size >= 8)
+    {
+        uint64 Lane;
+        FMemory::Memcpy(&Lane, Data, sizeof(Lane));
+        State[BlockOffset >> 3] ^= Lane;
+        Data += 8;
+        Size -= 8;
+        BlockOffset += 8;
+        if (BlockOffset == Rate)
+        {
+            KeccakF1600(State);
+            BlockOffset = 0;
+        }
+    }
+    
+    // Absorb the remaining tail.
+    while (Size > 0)
+    {
+        State[BlockOffset >> 3] ^= (uint64)(*Data++) << ((BlockOffset & 7) * 8);
+        --Size;
+        ++BlockOffset;
+    }
+}
+
+void FHallidayKeccak256::Final(uint8* OutDigest)
+{
+    // Keccak padding: a 0x01 after the message and 0x80 in the last byte of the block.
+    State[BlockOffset >> 3] ^= (uint64)0x01 << ((BlockOffset & 7) * 8);
+    State[(Rate - 1) >> 3] ^= (uint64)0x80 << (((Rate - 1) & 7) * 8);
+    KeccakF1600(State);
+    
+    for (int32 i = 0; i < DigestSize; ++i)
+    {
+        OutDigest[i] = (uint8)(State[i >> 3] >> ((i & 7) * 8));
+    }
+}
+
+void FHallidayKeccak256::Hash(const uint8* Data, int64 Size, uint8* OutDigest)
+{
+    FHallidayKeccak256 Hasher;
+    Hasher.Update(Data, Size);
+    Hasher.Final(OutDigest);
+}
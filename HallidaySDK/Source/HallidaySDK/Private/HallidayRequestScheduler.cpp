@@ -0,0 +1,611 @@
+#include "HallidayRequestScheduler.h"
+#include "HttpModule.h"
+#include "Misc/ScopeLock.h"
+
+/** Refill rate of a token bucket before the backend has pushed back. */
+static constexpr double InitialTokensPerSecond = 20.0;
+
+static constexpr double MinTokensPerSecond = 0.5;
+
+static constexpr double MaxTokensPerSecond = 200.0;
+
+/** Factor the concurrency limit and the refill rate are multiplied with on a 429 or 5xx. */
+static constexpr double BackoffFactor = 0.5;
+
+/** Number of times a throttled request is sent before its failure is passed on to the caller. */
+static constexpr int32 MaxAttempts = 4;
+
+/** Upper bound of a Retry-After header that is honoured, so a misconfigured proxy cannot stall a class for long. */
+static constexpr double MaxRetryAfterSeconds = 30.0;
+
+/** Number of response times each class keeps to estimate its hedge delay. */
+static constexpr int32 NumResponseTimes = 64;
+
+/** Number of response times a class needs before its requests are hedged with the percentile delay. */
+static constexpr int32 MinResponseTimes = 20;
+
+/** Largest number of hedges the budget saves up, so that a burst of slow responses cannot spend much more than the ratio. */
+static constexpr double MaxHedgeTokens = 3.0;
+
+/**
+ * Check whether a throttled request can be sent again without risking that the backend runs it twice.
+ * 429 and 503 mean the request was not processed. Other 5xx responses are only retried for requests without side effects.
+ */
+static bool IsRetryable(const FString& Verb, int32 ResponseCode)
+{
+    return ResponseCode == 429 || ResponseCode == 503 || Verb == TEXT("GET") || Verb == TEXT("HEAD");
+}
+
+FHallidayRequestScheduler::FHallidayRequestScheduler()
+{
+    const double Now = FPlatformTime::Seconds();
+    for (FPriorityQueue& Queue : Queues)
+    {
+        Queue.ConcurrencyLimit = MaxInFlight;
+        Queue.Tokens = MaxInFlight;
+        Queue.TokensPerSecond = InitialTokensPerSecond;
+        Queue.RefillTime = Now;
+    }
+}
+
+void FHallidayRequestScheduler::SetMaxInFlight(int32 InMaxInFlight)
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+        if (MaxInFlight == FMath::Max(InMaxInFlight, 1))
+        {
+            return;
+        }
+        MaxInFlight = FMath::Max(InMaxInFlight, 1);
+        for (FPriorityQueue& Queue : Queues)
+        {
+            Queue.ConcurrencyLimit = FMath::Min(Queue.ConcurrencyLimit, (double)MaxInFlight);
+        }
+    }
+    Dispatch();
+}
+
+void FHallidayRequestScheduler::SetHedging(bool bInIsEnabled, double InDelaySeconds, double InBudgetRatio)
+{
+    FScopeLock Lock(&CriticalSection);
+    bIsHedgingEnabled = bInIsEnabled;
+    HedgeDelaySeconds = FMath::Max(InDelaySeconds, 0.0);
+    HedgeBudgetRatio = FMath::Clamp(InBudgetRatio, 0.0, 1.0);
+}
+
+void FHallidayRequestScheduler::SetRequestTimeout(float InTimeoutSeconds)
+{
+    FScopeLock Lock(&CriticalSection);
+    RequestTimeoutSeconds = FMath::Max(InTimeoutSeconds, 0.0f);
+}
+
+void FHallidayRequestScheduler::SetRequestFactory(TFunction<TSharedRef<IHttpRequest, ESPMode::ThreadSafe>()> InRequestFactory)
+{
+    RequestFactory = MoveTemp(InRequestFactory);
+}
+
+void FHallidayRequestScheduler::Enqueue(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request, EHallidayRequestPriority Priority, const FString& PlayerId, const TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe>& Operation, bool bCanHedge, bool bCanRequeue)
+{
+    TSharedRef<FRequestState, ESPMode::ThreadSafe> State = MakeShared<FRequestState, ESPMode::ThreadSafe>();
+    State->OnComplete = Request->OnProcessRequestComplete();
+    State->PlayerId = PlayerId;
+    State->Priority = Priority;
+    State->Operation = Operation;
+    State->bCanRequeue = bCanRequeue;
+    if (bCanHedge)
+    {
+        State->Hedge = MakeShared<FHedgeGroup, ESPMode::ThreadSafe>();
+    }
+    BindCompletion(Request, State);
+
+    FQueuedRequest Queued;
+    Queued.Request = Request;
+    Queued.State = State;
+    Queued.EnqueueTime = FPlatformTime::Seconds();
+
+    bool bIsCancelled = false;
+    {
+        FScopeLock Lock(&CriticalSection);
+        bIsCancelled = IsCancelled(*State);
+        if (bIsCancelled)
+        {
+            ++Stats.NumCancelled;
+        }
+        else
+        {
+            Push(MoveTemp(Queued), false);
+        }
+    }
+
+    if (bIsCancelled)
+    {
+        // The operation was cancelled while this request was being built, e.g. on a background thread.
+        State->OnComplete.ExecuteIfBound(Request, nullptr, false);
+        return;
+    }
+    Dispatch();
+}
+
+void FHallidayRequestScheduler::Cancel(FHallidayOperation& Operation)
+{
+    TArray<FQueuedRequest> Queued;
+    TArray<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>> InFlight;
+    {
+        FScopeLock Lock(&CriticalSection);
+        Operation.bIsCancelled.store(true, std::memory_order_release);
+        RemoveLocked([&Operation](const FRequestState& State) { return State.Operation.Get() == &Operation; }, Queued, InFlight);
+    }
+    CancelRequests(Queued, InFlight);
+}
+
+void FHallidayRequestScheduler::CancelAll()
+{
+    TArray<FQueuedRequest> Queued;
+    TArray<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>> InFlight;
+    {
+        FScopeLock Lock(&CriticalSection);
+        RemoveLocked([](const FRequestState& State) {
+            // Mark the operations as well, so that they do not go on with their next request.
+            if (State.Operation.IsValid())
+            {
+                State.Operation->bIsCancelled.store(true, std::memory_order_release);
+            }
+            return true;
+        }, Queued, InFlight);
+    }
+    CancelRequests(Queued, InFlight);
+}
+
+void FHallidayRequestScheduler::Tick()
+{
+    SendHedges();
+    Dispatch();
+}
+
+FHallidayRequestSchedulerStats FHallidayRequestScheduler::GetStats() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return Stats;
+}
+
+void FHallidayRequestScheduler::Push(FQueuedRequest&& Queued, bool bAtFront)
+{
+    FPriorityQueue& Queue = Queues[(int32)Queued.State->Priority];
+    const FString& PlayerId = Queued.State->PlayerId;
+    FPlayerQueue* PlayerQueue = Queue.Players.FindByPredicate([&PlayerId](const FPlayerQueue& Candidate) { return Candidate.PlayerId == PlayerId; });
+    if (PlayerQueue == nullptr)
+    {
+        PlayerQueue = &Queue.Players.AddDefaulted_GetRef();
+        PlayerQueue->PlayerId = PlayerId;
+    }
+
+    if (bAtFront)
+    {
+        PlayerQueue->Requests.Insert(MoveTemp(Queued), 0);
+    }
+    else
+    {
+        PlayerQueue->Requests.Add(MoveTemp(Queued));
+    }
+
+    ++Stats.NumQueued;
+    Stats.PeakQueued = FMath::Max(Stats.PeakQueued, Stats.NumQueued);
+}
+
+void FHallidayRequestScheduler::Dispatch()
+{
+    TArray<FQueuedRequest, TInlineAllocator<8>> ToSend;
+    float TimeoutSeconds = 0.0f;
+    {
+        FScopeLock Lock(&CriticalSection);
+        TimeoutSeconds = RequestTimeoutSeconds;
+        const double Now = FPlatformTime::Seconds();
+        FQueuedRequest Next;
+        while (Stats.NumInFlight < MaxInFlight && PopNext(Now, Next))
+        {
+            const double WaitSeconds = Now - Next.EnqueueTime;
+            Stats.TotalWaitSeconds += WaitSeconds;
+            Stats.MaxWaitSeconds = FMath::Max(Stats.MaxWaitSeconds, WaitSeconds);
+            ++Stats.NumInFlight;
+            ++Stats.NumSent;
+            --Stats.NumQueued;
+
+            Next.State->bIsInFlight = true;
+            Next.State->SendTime = Now;
+            ++Next.State->NumAttempts;
+
+            if (Next.State->Hedge.IsValid())
+            {
+                Next.State->Hedge->Requests[0] = Next.Request;
+                Next.State->Hedge->NumInFlight = 1;
+                HedgeTokens = FMath::Min(HedgeTokens + HedgeBudgetRatio, MaxHedgeTokens);
+                HedgeCandidates.Add(Next.State);
+            }
+            InFlightRequests.Add(Next);
+            ToSend.Add(MoveTemp(Next));
+        }
+    }
+
+    // Start the requests outside the lock because a request that fails right away may complete inside ProcessRequest().
+    for (FQueuedRequest& Queued : ToSend)
+    {
+        if (TimeoutSeconds > 0.0f)
+        {
+            Queued.Request->SetTimeout(TimeoutSeconds);
+        }
+        if (!Queued.Request->ProcessRequest())
+        {
+            {
+                FScopeLock Lock(&CriticalSection);
+                ReleaseLocked(*Queued.State);
+                HedgeCandidates.Remove(Queued.State);
+            }
+            Dispatch();
+        }
+    }
+}
+
+TSharedRef<IHttpRequest, ESPMode::ThreadSafe> FHallidayRequestScheduler::CloneRequest(const IHttpRequest& Request) const
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Clone = RequestFactory ? RequestFactory() : FHttpModule::Get().CreateRequest();
+    Clone->SetURL(Request.GetURL());
+    Clone->SetVerb(Request.GetVerb());
+    for (const FString& Header : Request.GetAllHeaders())
+    {
+        FString Name;
+        FString Value;
+        if (Header.Split(TEXT(": "), &Name, &Value))
+        {
+            Clone->SetHeader(Name, Value);
+        }
+    }
+    Clone->SetContent(Request.GetContent());
+    return Clone;
+}
+
+void FHallidayRequestScheduler::BindCompletion(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request, const TSharedRef<FRequestState, ESPMode::ThreadSafe>& State)
+{
+    Request->OnProcessRequestComplete().BindLambda([WeakScheduler = TWeakPtr<FHallidayRequestScheduler, ESPMode::ThreadSafe>(AsShared()), State](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful) {
+        if (TSharedPtr<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = WeakScheduler.Pin())
+        {
+            Scheduler->Complete(*State, Request, Response, bWasSuccessful);
+        }
+        else
+        {
+            State->OnComplete.ExecuteIfBound(Request, Response, bWasSuccessful);
+        }
+    });
+}
+
+void FHallidayRequestScheduler::Complete(FRequestState& State, FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+    const int32 ResponseCode = Response.IsValid() ? Response->GetResponseCode() : 0;
+    const bool bIsThrottled = ResponseCode == 429 || ResponseCode >= 500;
+    const bool bIsUsable = bWasSuccessful && ResponseCode != 0 && !bIsThrottled;
+    bool bRequeue = bIsThrottled && State.bCanRequeue && Request.IsValid() && State.NumAttempts < MaxAttempts && IsRetryable(Request->GetVerb(), ResponseCode) && !IsCancelled(State);
+
+    // Copy the request before taking the lock because creating a request may take the HTTP module's own lock.
+    TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Retry;
+    if (bRequeue)
+    {
+        Retry = CloneRequest(*Request);
+    }
+
+    bool bIsSuperseded = false;
+    TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Loser;
+    {
+        FScopeLock Lock(&CriticalSection);
+        const double Now = FPlatformTime::Seconds();
+        FPriorityQueue& Queue = Queues[(int32)State.Priority];
+
+        if (bIsThrottled)
+        {
+            // Every response to the requests that were already in flight reports the same overload, so only back off once per round.
+            if (State.SendTime >= Queue.BackoffTime)
+            {
+                Queue.ConcurrencyLimit = FMath::Max(Queue.ConcurrencyLimit * BackoffFactor, 1.0);
+                Queue.TokensPerSecond = FMath::Max(Queue.TokensPerSecond * BackoffFactor, MinTokensPerSecond);
+                Queue.Tokens = 0.0;
+                Queue.BackoffTime = Now;
+                ++Stats.NumBackoffs;
+            }
+
+            const double RetryAfterSeconds = FCString::Atod(*Response->GetHeader(TEXT("Retry-After")));
+            if (RetryAfterSeconds > 0.0)
+            {
+                Queue.PausedUntil = FMath::Max(Queue.PausedUntil, Now + FMath::Min(RetryAfterSeconds, MaxRetryAfterSeconds));
+            }
+        }
+        else if (bWasSuccessful && ResponseCode != 0)
+        {
+            // Grow by about one request per round of responses.
+            Queue.ConcurrencyLimit = FMath::Min(Queue.ConcurrencyLimit + 1.0 / Queue.ConcurrencyLimit, (double)MaxInFlight);
+            Queue.TokensPerSecond = FMath::Min(Queue.TokensPerSecond + 1.0 / Queue.TokensPerSecond, MaxTokensPerSecond);
+        }
+
+        ReleaseLocked(State);
+        InFlightRequests.RemoveAllSwap([&State](const FQueuedRequest& InFlight) { return InFlight.State.Get() == &State; });
+
+        if (State.Hedge.IsValid())
+        {
+            if (bIsUsable)
+            {
+                AddResponseTimeLocked(Queue, Now - State.SendTime);
+            }
+            bIsSuperseded = SettleHedgeLocked(State, bIsUsable, Loser);
+            bRequeue = bRequeue && !bIsSuperseded;
+        }
+
+        if (bRequeue)
+        {
+            // The copy keeps its place at the front of the player's queue.
+            TSharedRef<FRequestState, ESPMode::ThreadSafe> RetryState = MakeShared<FRequestState, ESPMode::ThreadSafe>(State);
+            if (State.Hedge.IsValid())
+            {
+                // The copy may be hedged again once it is sent.
+                RetryState->Hedge = MakeShared<FHedgeGroup, ESPMode::ThreadSafe>();
+                RetryState->bIsHedge = false;
+            }
+            FQueuedRequest Queued;
+            Queued.Request = Retry;
+            Queued.State = RetryState;
+            Queued.EnqueueTime = Now;
+            BindCompletion(Retry.ToSharedRef(), RetryState);
+            Push(MoveTemp(Queued), true);
+            ++Stats.NumRequeued;
+        }
+    }
+    Dispatch();
+
+    if (Loser.IsValid())
+    {
+        // The loser completes right away and its response is dropped because the group is done.
+        Loser->CancelRequest();
+    }
+
+    if (!bRequeue && !bIsSuperseded)
+    {
+        State.OnComplete.ExecuteIfBound(Request, Response, bWasSuccessful);
+    }
+}
+
+void FHallidayRequestScheduler::ReleaseLocked(FRequestState& State)
+{
+    if (!State.bIsInFlight)
+    {
+        return;
+    }
+
+    State.bIsInFlight = false;
+    --Stats.NumInFlight;
+    --Queues[(int32)State.Priority].NumInFlight;
+}
+
+bool FHallidayRequestScheduler::PopNext(double Now, FQueuedRequest& OutRequest)
+{
+    for (FPriorityQueue& Queue : Queues)
+    {
+        // Refill the bucket. It holds at most one round of requests so that a refilled bucket does not burst past the concurrency limit.
+        Queue.Tokens = FMath::Min(Queue.Tokens + (Now - Queue.RefillTime) * Queue.TokensPerSecond, FMath::Max(Queue.ConcurrencyLimit, 1.0));
+        Queue.RefillTime = Now;
+
+        if (Queue.Players.Num() == 0 || Now < Queue.PausedUntil || Queue.NumInFlight >= FMath::FloorToInt(Queue.ConcurrencyLimit) || Queue.Tokens < 1.0)
+        {
+            // A class that is held back does not block the classes below it, which use other endpoints.
+            continue;
+        }
+
+        // Players take turns within a class.
+        if (Queue.NextPlayer >= Queue.Players.Num())
+        {
+            Queue.NextPlayer = 0;
+        }
+        FPlayerQueue& PlayerQueue = Queue.Players[Queue.NextPlayer];
+        OutRequest = MoveTemp(PlayerQueue.Requests[0]);
+        PlayerQueue.Requests.RemoveAt(0, 1, false);
+
+        if (PlayerQueue.Requests.Num() == 0)
+        {
+            // The next player moves into this index, so NextPlayer already points at them.
+            Queue.Players.RemoveAt(Queue.NextPlayer);
+        }
+        else
+        {
+            ++Queue.NextPlayer;
+        }
+
+        Queue.Tokens -= 1.0;
+        ++Queue.NumInFlight;
+        return true;
+    }
+    return false;
+}
+
+void FHallidayRequestScheduler::SendHedges()
+{
+    TArray<TPair<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>, TSharedPtr<FRequestState, ESPMode::ThreadSafe>>, TInlineAllocator<4>> ToHedge;
+    float TimeoutSeconds = 0.0f;
+    {
+        FScopeLock Lock(&CriticalSection);
+        if (!bIsHedgingEnabled)
+        {
+            return;
+        }
+        TimeoutSeconds = RequestTimeoutSeconds;
+
+        const double Now = FPlatformTime::Seconds();
+        for (int32 i = HedgeCandidates.Num() - 1; i >= 0 && HedgeTokens >= 1.0 && Stats.NumInFlight < MaxInFlight; --i)
+        {
+            TSharedPtr<FRequestState, ESPMode::ThreadSafe> State = HedgeCandidates[i];
+            if (IsCancelled(*State))
+            {
+                continue;
+            }
+
+            const double DelaySeconds = HedgeDelaySeconds > 0.0 ? HedgeDelaySeconds : Queues[(int32)State->Priority].ResponseTimeP95;
+            if (DelaySeconds <= 0.0 || Now - State->SendTime < DelaySeconds)
+            {
+                continue;
+            }
+
+            HedgeCandidates.RemoveAtSwap(i, 1, false);
+            if (TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request = State->Hedge->Requests[0].Pin())
+            {
+                HedgeTokens -= 1.0;
+                ToHedge.Emplace(MoveTemp(Request), MoveTemp(State));
+            }
+        }
+    }
+
+    for (TPair<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>, TSharedPtr<FRequestState, ESPMode::ThreadSafe>>& Pair : ToHedge)
+    {
+        // Copy the request outside the lock because creating a request may take the HTTP module's own lock.
+        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Hedge = CloneRequest(*Pair.Key);
+        TSharedRef<FRequestState, ESPMode::ThreadSafe> HedgeState = MakeShared<FRequestState, ESPMode::ThreadSafe>(*Pair.Value);
+        HedgeState->bIsHedge = true;
+        BindCompletion(Hedge, HedgeState);
+
+        {
+            FScopeLock Lock(&CriticalSection);
+            FHedgeGroup& Group = *HedgeState->Hedge;
+            if (Group.bIsDone)
+            {
+                // The request answered while the hedge was being copied.
+                continue;
+            }
+
+            Group.Requests[1] = Hedge;
+            Group.bIsHedged = true;
+            ++Group.NumInFlight;
+
+            HedgeState->bIsInFlight = true;
+            HedgeState->SendTime = FPlatformTime::Seconds();
+            ++Stats.NumInFlight;
+            ++Stats.NumSent;
+            ++Stats.NumHedged;
+            ++Queues[(int32)HedgeState->Priority].NumInFlight;
+
+            FQueuedRequest InFlight;
+            InFlight.Request = Hedge;
+            InFlight.State = HedgeState;
+            InFlightRequests.Add(MoveTemp(InFlight));
+        }
+
+        if (TimeoutSeconds > 0.0f)
+        {
+            Hedge->SetTimeout(TimeoutSeconds);
+        }
+        if (!Hedge->ProcessRequest())
+        {
+            // The failed hedge still completes, which settles it with its group.
+            FScopeLock Lock(&CriticalSection);
+            ReleaseLocked(*HedgeState);
+        }
+    }
+}
+
+bool FHallidayRequestScheduler::SettleHedgeLocked(FRequestState& State, bool bIsUsable, TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& OutLoser)
+{
+    FHedgeGroup& Group = *State.Hedge;
+    --Group.NumInFlight;
+    HedgeCandidates.RemoveAll([&State](const TSharedPtr<FRequestState, ESPMode::ThreadSafe>& Candidate) { return Candidate.Get() == &State; });
+
+    if (Group.bIsDone || (!bIsUsable && Group.NumInFlight > 0))
+    {
+        // Either the other request already answered or it may still answer where this one failed.
+        return true;
+    }
+
+    Group.bIsDone = true;
+    if (State.bIsHedge && bIsUsable)
+    {
+        ++Stats.NumHedgeWins;
+    }
+    if (Group.NumInFlight > 0)
+    {
+        OutLoser = Group.Requests[State.bIsHedge ? 0 : 1].Pin();
+    }
+    return false;
+}
+
+void FHallidayRequestScheduler::AddResponseTimeLocked(FPriorityQueue& Queue, double ResponseSeconds)
+{
+    if (Queue.ResponseTimes.Num() < NumResponseTimes)
+    {
+        Queue.ResponseTimes.Add((float)ResponseSeconds);
+    }
+    else
+    {
+        Queue.ResponseTimes[Queue.NextResponseTime] = (float)ResponseSeconds;
+    }
+    Queue.NextResponseTime = (Queue.NextResponseTime + 1) % NumResponseTimes;
+
+    if (Queue.ResponseTimes.Num() < MinResponseTimes)
+    {
+        return;
+    }
+
+    TArray<float, TInlineAllocator<NumResponseTimes>> Sorted(Queue.ResponseTimes);
+    Sorted.Sort();
+    Queue.ResponseTimeP95 = Sorted[FMath::Min(FMath::CeilToInt(Sorted.Num() * 0.95f), Sorted.Num()) - 1];
+}
+
+bool FHallidayRequestScheduler::IsCancelled(const FRequestState& State)
+{
+    return State.Operation.IsValid() && State.Operation->IsCancelled();
+}
+
+template<typename PredicateType>
+void FHallidayRequestScheduler::RemoveLocked(PredicateType Predicate, TArray<FQueuedRequest>& OutQueued, TArray<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>>& OutInFlight)
+{
+    for (FPriorityQueue& Queue : Queues)
+    {
+        for (int32 PlayerIndex = Queue.Players.Num() - 1; PlayerIndex >= 0; --PlayerIndex)
+        {
+            TArray<FQueuedRequest>& Requests = Queue.Players[PlayerIndex].Requests;
+            for (int32 i = Requests.Num() - 1; i >= 0; --i)
+            {
+                if (Predicate(*Requests[i].State))
+                {
+                    OutQueued.Add(MoveTemp(Requests[i]));
+                    Requests.RemoveAt(i, 1, false);
+                    --Stats.NumQueued;
+                }
+            }
+
+            if (Requests.Num() == 0)
+            {
+                // Keep the turn with the player it belongs to.
+                Queue.Players.RemoveAt(PlayerIndex);
+                if (PlayerIndex < Queue.NextPlayer)
+                {
+                    --Queue.NextPlayer;
+                }
+            }
+        }
+    }
+
+    for (const FQueuedRequest& InFlight : InFlightRequests)
+    {
+        if (Predicate(*InFlight.State))
+        {
+            OutInFlight.Add(InFlight.Request);
+        }
+    }
+    Stats.NumCancelled += OutQueued.Num() + OutInFlight.Num();
+}
+
+void FHallidayRequestScheduler::CancelRequests(TArray<FQueuedRequest>& Queued, TArray<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>>& InFlight)
+{
+    // Requests in flight complete through the usual handler, which sees that they were cancelled.
+    for (const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request : InFlight)
+    {
+        Request->CancelRequest();
+    }
+
+    // Queued requests were never sent, so complete them here.
+    for (FQueuedRequest& Request : Queued)
+    {
+        Request.State->OnComplete.ExecuteIfBound(Request.Request, nullptr, false);
+    }
+}
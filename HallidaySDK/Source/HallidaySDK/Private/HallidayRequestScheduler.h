@@ -0,0 +1,350 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include <atomic>
+
+/**
+ * Priority classes of Halliday requests from the most to the least urgent. A queued request of a higher class is sent before one of a lower class whenever both may be sent.
+ * Each class also stands for one class of backend endpoints and has its own rate limiter.
+ */
+enum class EHallidayRequestPriority : uint8
+{
+    /** Building, hashing and submitting a transaction the player is waiting for, e.g. a purchase. */
+    Transaction,
+
+    /** Fetching or creating the player's wallet. */
+    Wallet,
+
+    /** Looking up a transaction that was submitted. */
+    TransactionStatus,
+
+    Balances,
+
+    Assets,
+
+    /** Connection warm-ups that nobody waits for. */
+    Warmup,
+
+    Num,
+};
+
+/**
+ * One call of the public API, e.g. GetAssets() or TransferAsset(), that all of its requests are enqueued for so that they can be cancelled together.
+ * Stages that run off the game thread check IsCancelled() before they go on.
+ */
+class FHallidayOperation
+{
+public:
+    explicit FHallidayOperation(int64 InId)
+        : Id(InId)
+    {
+    }
+
+    int64 GetId() const { return Id; }
+
+    /** Whether the operation was cancelled. This is safe to call from any thread. */
+    bool IsCancelled() const { return bIsCancelled.load(std::memory_order_acquire); }
+
+private:
+    friend class FHallidayRequestScheduler;
+
+    const int64 Id;
+
+    /** Only set under the lock of the scheduler, so that no request of the operation is enqueued after it was cancelled. */
+    std::atomic<bool> bIsCancelled{false};
+};
+
+/** Queue, wait-time and rate limiting metrics of FHallidayRequestScheduler. */
+struct FHallidayRequestSchedulerStats
+{
+    /** Number of requests waiting for a free slot. */
+    int32 NumQueued = 0;
+
+    /** Highest NumQueued so far. */
+    int32 PeakQueued = 0;
+
+    /** Number of requests sent that have not completed yet. */
+    int32 NumInFlight = 0;
+
+    /** Number of requests sent so far, including requeued ones. */
+    int64 NumSent = 0;
+
+    /** Seconds the sent requests spent in the queue in total. */
+    double TotalWaitSeconds = 0.0;
+
+    /** Longest time a request spent in the queue. */
+    double MaxWaitSeconds = 0.0;
+
+    /** Number of 429 and 5xx responses that made a rate limiter back off. */
+    int64 NumBackoffs = 0;
+
+    /** Number of throttled requests that were put back in the queue instead of failing. */
+    int64 NumRequeued = 0;
+
+    /** Number of hedges sent for slow requests. */
+    int64 NumHedged = 0;
+
+    /** Number of hedges that answered before the request they were sent for. */
+    int64 NumHedgeWins = 0;
+
+    /** Number of requests that were cancelled while queued or in flight. */
+    int64 NumCancelled = 0;
+};
+
+/**
+ * Single gate that every Halliday request goes through instead of calling ProcessRequest() directly.
+ * At most MaxInFlight requests are sent at once. The rest wait by priority class, and within a class players take turns so that one player's burst of refreshes does not starve another's.
+ *
+ * Each class has a token bucket and a concurrency limit that adapt to the backend with AIMD: both grow additively with every successful response and are halved on a 429 or 5xx.
+ * A throttled request is put back at the front of its queue, so queued work drains at the highest rate the backend sustains instead of failing, unless its caller retries it itself.
+ * Requests may be enqueued from any thread. Tick() must be called regularly so that requests held back by an empty bucket are sent once it refills.
+ *
+ * Requests without side effects may be hedged: once one has been in flight for longer than the hedge delay, an identical copy is sent and whichever answers first completes the request while the other is cancelled.
+ * Hedges are paid from a budget that grows with every hedgeable request sent, so they add at most a fixed share of load on top.
+ *
+ * Every enqueued request completes exactly once, also when it is cancelled or times out, so that its owner can clean up. A cancelled request completes as failed without a response.
+ */
+class FHallidayRequestScheduler : public TSharedFromThis<FHallidayRequestScheduler, ESPMode::ThreadSafe>
+{
+public:
+    FHallidayRequestScheduler();
+
+    /**
+     * Change the number of requests that may be in flight at once across all classes. Raising it sends queued requests right away.
+     * @param InMaxInFlight Maximum number of requests in flight. Values below 1 are treated as 1.
+     */
+    void SetMaxInFlight(int32 InMaxInFlight);
+
+    /**
+     * Configure hedging of the requests enqueued with bCanHedge.
+     * @param bInIsEnabled Whether slow requests are hedged.
+     * @param InDelaySeconds Seconds a request is in flight before it is hedged. 0 uses the 95th percentile of the recent response times of its class, once enough are known.
+     * @param InBudgetRatio Hedges allowed per hedgeable request sent, e.g. 0.05 for at most 5% extra requests.
+     */
+    void SetHedging(bool bInIsEnabled, double InDelaySeconds, double InBudgetRatio);
+
+    /**
+     * Change the time each request may take once it is sent. Time spent in the queue does not count.
+     * @param InTimeoutSeconds Timeout of a request, or 0 to use the default of the HTTP module.
+     */
+    void SetRequestTimeout(float InTimeoutSeconds);
+
+    /**
+     * Change how the copies that are sent when a request is requeued or hedged are created, e.g. to answer them with a fake in tests.
+     * Only call it before the first request is enqueued.
+     * @param InRequestFactory Creates an empty request. An unbound function restores FHttpModule::CreateRequest().
+     */
+    void SetRequestFactory(TFunction<TSharedRef<IHttpRequest, ESPMode::ThreadSafe>()> InRequestFactory);
+
+    /**
+     * Send a request as soon as a slot is free. The completion delegate must already be bound; it is executed as usual once the request completes.
+     * @param Request Request to send.
+     * @param Priority Priority class of the request.
+     * @param PlayerId Player the request is made for. Requests without a player share one turn.
+     * @param Operation Operation the request is made for, if it can be cancelled. If the operation was already cancelled, the request completes right away.
+     * @param bCanHedge Whether the request may be sent twice to cut its latency. Only pass true for requests without side effects.
+     * @param bCanRequeue Whether a throttled request is sent again by the scheduler. Pass false if the caller retries the request itself, so that it is not retried by both.
+     */
+    void Enqueue(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request, EHallidayRequestPriority Priority, const FString& PlayerId, const TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe>& Operation, bool bCanHedge = false, bool bCanRequeue = true);
+
+    /**
+     * Cancel an operation. Its queued requests complete right away and its requests in flight are cancelled. Requests enqueued for it later complete right away as well.
+     * @param Operation Operation to cancel.
+     */
+    void Cancel(FHallidayOperation& Operation);
+
+    /** Cancel every queued request and every request in flight, e.g. because the owner is going away. */
+    void CancelAll();
+
+    /** Send the hedges that are due and the requests that the rate limiters allow by now. */
+    void Tick();
+
+    /** A snapshot of the metrics. */
+    FHallidayRequestSchedulerStats GetStats() const;
+
+private:
+    /**
+     * A hedgeable request and its hedge, of which only the first usable response is passed on.
+     * It only references the requests weakly because each of them owns a completion handler that holds it.
+     */
+    struct FHedgeGroup
+    {
+        /** The request as it was sent and its hedge, if one was sent. */
+        TWeakPtr<IHttpRequest, ESPMode::ThreadSafe> Requests[2];
+
+        /** Number of requests of the group that have not completed. */
+        int32 NumInFlight = 0;
+
+        bool bIsHedged = false;
+
+        /** Whether a response was passed on. Responses that arrive later are dropped. */
+        bool bIsDone = false;
+    };
+
+    /** State of a request that is kept across the copies sent when it is requeued. It never references the request itself, which owns the completion handler that holds it. */
+    struct FRequestState
+    {
+        /** Completion delegate of the caller, executed once the request completes for good. */
+        FHttpRequestCompleteDelegate OnComplete;
+
+        FString PlayerId;
+
+        EHallidayRequestPriority Priority = EHallidayRequestPriority::Warmup;
+
+        /** Number of times the request was sent. */
+        int32 NumAttempts = 0;
+
+        /** Whether the request is put back in the queue when it is throttled. */
+        bool bCanRequeue = true;
+
+        /** FPlatformTime::Seconds() at which the request was last sent. */
+        double SendTime = 0.0;
+
+        /** Whether the request holds a slot. Cleared when it gives the slot back, so that it is never given back twice. */
+        bool bIsInFlight = false;
+
+        /** Group of the request if it may be hedged. */
+        TSharedPtr<FHedgeGroup, ESPMode::ThreadSafe> Hedge;
+
+        /** Whether this is the hedge of another request. */
+        bool bIsHedge = false;
+
+        /** Operation the request is made for, if any. */
+        TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> Operation;
+    };
+
+    struct FQueuedRequest
+    {
+        TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request;
+
+        TSharedPtr<FRequestState, ESPMode::ThreadSafe> State;
+
+        /** FPlatformTime::Seconds() at which the request was enqueued. */
+        double EnqueueTime = 0.0;
+    };
+
+    /** Requests of one player in one priority class in the order they were enqueued. */
+    struct FPlayerQueue
+    {
+        FString PlayerId;
+        TArray<FQueuedRequest> Requests;
+    };
+
+    /** Queued requests and the rate limiter of one priority class. */
+    struct FPriorityQueue
+    {
+        TArray<FPlayerQueue> Players;
+
+        /** Index of the player whose turn is next. */
+        int32 NextPlayer = 0;
+
+        /** Number of requests of the class in flight. */
+        int32 NumInFlight = 0;
+
+        /** AIMD limit of NumInFlight. */
+        double ConcurrencyLimit = 0.0;
+
+        /** Tokens in the bucket. Sending a request takes one. */
+        double Tokens = 0.0;
+
+        /** AIMD refill rate of the bucket. */
+        double TokensPerSecond = 0.0;
+
+        /** FPlatformTime::Seconds() at which the bucket was last refilled. */
+        double RefillTime = 0.0;
+
+        /** FPlatformTime::Seconds() of the last backoff. Responses to requests sent before it do not back off again. */
+        double BackoffTime = 0.0;
+
+        /** No request of the class is sent before this time, e.g. because of a Retry-After header. */
+        double PausedUntil = 0.0;
+
+        /** Recent response times of hedgeable requests in seconds, used as a ring buffer. */
+        TArray<float> ResponseTimes;
+
+        /** Index in ResponseTimes that the next response time is written to. */
+        int32 NextResponseTime = 0;
+
+        /** 95th percentile of ResponseTimes, or 0 while there are too few of them. */
+        double ResponseTimeP95 = 0.0;
+    };
+
+    /** Put a request in the queue of its class and player. The lock must be held. */
+    void Push(FQueuedRequest&& Queued, bool bAtFront);
+
+    /** Send queued requests until every slot is taken, the limiters hold the rest back or the queue is empty. */
+    void Dispatch();
+
+    /** Copy a request so that it can be sent again. A completed request cannot be processed a second time. */
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> CloneRequest(const IHttpRequest& Request) const;
+
+    /** Bind the completion handler of the scheduler to a request. */
+    void BindCompletion(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request, const TSharedRef<FRequestState, ESPMode::ThreadSafe>& State);
+
+    /** Handle a completed request: adapt the limiter, give the slot back and either requeue the request or execute the caller's delegate. */
+    void Complete(FRequestState& State, FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+
+    /** Give back the slot of a request. The lock must be held. */
+    void ReleaseLocked(FRequestState& State);
+
+    /** Take the next request the limiters allow by priority and then by player. The lock must be held. */
+    bool PopNext(double Now, FQueuedRequest& OutRequest);
+
+    /** Check whether a request belongs to a cancelled operation. */
+    static bool IsCancelled(const FRequestState& State);
+
+    /** Remove the queued requests that match a predicate and collect the requests in flight that match it. The lock must be held. */
+    template<typename PredicateType>
+    void RemoveLocked(PredicateType Predicate, TArray<FQueuedRequest>& OutQueued, TArray<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>>& OutInFlight);
+
+    /** Complete removed queued requests and cancel requests in flight. The lock must not be held. */
+    void CancelRequests(TArray<FQueuedRequest>& Queued, TArray<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>>& InFlight);
+
+    /** Send a hedge for each hedgeable request that has been in flight for longer than the hedge delay, as far as the budget allows. */
+    void SendHedges();
+
+    /**
+     * Settle the hedge group of a completed request. The lock must be held.
+     * @param State State of the completed request.
+     * @param bIsUsable Whether the response may be passed on, i.e. it is neither a failure nor throttled.
+     * @param OutLoser Receives the other request of the group if it has to be cancelled.
+     * @returns True if the response must be dropped because the other request of the group answered or may still answer.
+     */
+    bool SettleHedgeLocked(FRequestState& State, bool bIsUsable, TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& OutLoser);
+
+    /** Add the response time of a hedgeable request to its class and update the percentile. The lock must be held. */
+    void AddResponseTimeLocked(FPriorityQueue& Queue, double ResponseSeconds);
+
+    FPriorityQueue Queues[(int32)EHallidayRequestPriority::Num];
+
+    int32 MaxInFlight = 6;
+
+    /** Timeout set on each request before it is sent, or 0 for the default of the HTTP module. */
+    float RequestTimeoutSeconds = 0.0f;
+
+    /** Requests that were sent and have not completed, so that they can be cancelled. */
+    TArray<FQueuedRequest> InFlightRequests;
+
+    bool bIsHedgingEnabled = false;
+
+    /** Fixed hedge delay, or 0 to use the percentile of each class. */
+    double HedgeDelaySeconds = 0.0;
+
+    double HedgeBudgetRatio = 0.05;
+
+    /** Hedges that may be sent right now. Sending a hedgeable request adds HedgeBudgetRatio and sending a hedge takes one. */
+    double HedgeTokens = 0.0;
+
+    /** States of the hedgeable requests in flight that have not been hedged yet. */
+    TArray<TSharedPtr<FRequestState, ESPMode::ThreadSafe>> HedgeCandidates;
+
+    FHallidayRequestSchedulerStats Stats;
+
+    /** Guards everything above. */
+    mutable FCriticalSection CriticalSection;
+
+    /** Creates the copies of requeued and hedged requests. Only set before the first request is enqueued, so it is read without the lock. */
+    TFunction<TSharedRef<IHttpRequest, ESPMode::ThreadSafe>()> RequestFactory;
+};
@@ -0,0 +1,167 @@
+#include "HallidaySecp256k1ContextPool.h"
+#include "secp256k1_preallocated.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTLS.h"
+#include <cstddef>
+#include <cstdint>
+
+// Include the following libraries depending on OS.
+// These are used for FillRandom()
+#if defined(_WIN32)
+#include <Windows.h>
+#include <bcrypt.h>
+#elif defined(__linux__) || defined(__FreeBSD__)
+#include <sys/random.h>
+#elif defined(__APPLE__)
+#include <Security/Security.h>
+#endif
+
+/**
+ * Fill a byte array with random data. Used for secp256k1 signing.
+ * @param Data Byte array
+ * @param Size Size of the byte array
+ * @returns A boolean to indicate success or failure.
+ */
+static bool FillRandom(uint8_t* Data, size_t Size) {
+#if defined(_WIN32)
+    NTSTATUS res = BCryptGenRandom(nullptr, Data, static_cast<ULONG>(Size), BCRYPT_USE_SYSTEM_PREFERRED_RNG);
+    return BCRYPT_SUCCESS(res) && Size <= ULONG_MAX;
+#elif defined(__linux__) || defined(__FreeBSD__)
+    ssize_t res = getrandom(Data, Size, 0);
+    return res >= 0 && static_cast<size_t>(res) == Size;
+#elif defined(__APPLE__)
+    return SecRandomCopyBytes(kSecRandomDefault, Size, Data) == errSecSuccess;
+#endif
+    return false;
+}
+
+bool FHallidaySecp256k1ContextPool::Randomize(secp256k1_context* Context)
+{
+    /* Randomizing the context is recommended to protect against side-channel
+     * leakage See `secp256k1_context_randomize` in secp256k1.h for more
+     * information about it. This should never fail. */
+    unsigned char Seed[32];
+    if (!FillRandom(Seed, sizeof(Seed))) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to generate randomness for the secp256k1 context."));
+        return false;
+    }
+    if (secp256k1_context_randomize(Context, Seed) != 1) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to randomize the secp256k1 context."));
+        return false;
+    }
+    return true;
+}
+
+FHallidaySecp256k1ContextPool* FHallidaySecp256k1ContextPool::Create(int32 NumContexts)
+{
+    NumContexts = FMath::Max(NumContexts, 1);
+
+    // Create a master context for the secp256k1 library using 'SECP256K1_CONTEXT_NONE'.
+    // All other contexts in the library have been deprecated. This will allow for all functionality.
+    secp256k1_context* Master = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+    if (!Master) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to create the secp256k1 context."));
+        return nullptr;
+    }
+    if (!Randomize(Master)) {
+        secp256k1_context_destroy(Master);
+        return nullptr;
+    }
+
+    // Lay the clones out back to back, each starting on its own cache line.
+    const size_t ContextSize = secp256k1_context_preallocated_clone_size(Master);
+    const size_t Stride = Align(ContextSize, (size_t)PLATFORM_CACHE_LINE_SIZE);
+
+    FHallidaySecp256k1ContextPool* Pool = new FHallidaySecp256k1ContextPool();
+    Pool->Arena = FMemory::Malloc(Stride * NumContexts, PLATFORM_CACHE_LINE_SIZE);
+    Pool->Slots = new FSlot[NumContexts];
+
+    bool bSucceeded = true;
+    for (int32 i = 0; i < NumContexts; ++i) {
+        secp256k1_context* Context = secp256k1_context_preallocated_clone(Master, (uint8*)Pool->Arena + i * Stride);
+        if (!Context) {
+            bSucceeded = false;
+            break;
+        }
+        Pool->Slots[i].Context = Context;
+        ++Pool->NumSlots;
+
+        // Give every clone its own blinding so that no two threads sign with the same one.
+        if (!Randomize(Context)) {
+            bSucceeded = false;
+            break;
+        }
+    }
+
+    secp256k1_context_destroy(Master);
+
+    if (!bSucceeded) {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to create the secp256k1 context pool."));
+        delete Pool;
+        return nullptr;
+    }
+    return Pool;
+}
+
+FHallidaySecp256k1ContextPool::~FHallidaySecp256k1ContextPool()
+{
+    for (int32 i = 0; i < NumSlots; ++i) {
+        check(!Slots[i].bInUse.load());
+        secp256k1_context_preallocated_destroy(Slots[i].Context);
+    }
+    delete[] Slots;
+    FMemory::Free(Arena);
+}
+
+int32 FHallidaySecp256k1ContextPool::Acquire()
+{
+    // Start at a slot picked by the thread id so that a thread usually gets the context it used last.
+    const int32 Start = (int32)(FPlatformTLS::GetCurrentThreadId() % (uint32)NumSlots);
+    for (;;) {
+        for (int32 i = 0; i < NumSlots; ++i) {
+            const int32 Slot = (Start + i) % NumSlots;
+            if (!Slots[Slot].bInUse.load(std::memory_order_relaxed) && !Slots[Slot].bInUse.exchange(true, std::memory_order_acquire)) {
+                return Slot;
+            }
+        }
+        // Every context is in use. This only happens when more threads sign at once than the pool was sized for.
+        FPlatformProcess::YieldThread();
+    }
+}
+
+void FHallidaySecp256k1ContextPool::Release(int32 Slot, int32 NumSignatures, int32 RandomizeInterval)
+{
+    FSlot& Leased = Slots[Slot];
+    Leased.SignaturesSinceRandomize += NumSignatures;
+
+    // Re-randomize on the configured schedule. This is done in place and does not allocate.
+    if (RandomizeInterval > 0 && Leased.SignaturesSinceRandomize >= RandomizeInterval) {
+        if (Randomize(Leased.Context)) {
+            Leased.SignaturesSinceRandomize = 0;
+        }
+    }
+
+    Leased.bInUse.store(false, std::memory_order_release);
+}
+
+FHallidaySecp256k1ContextPool::FScopedContext::FScopedContext(FHallidaySecp256k1ContextPool& InPool, int32 InRandomizeInterval)
+    : Pool(InPool)
+    , Slot(InPool.Acquire())
+    , RandomizeInterval(InRandomizeInterval)
+{
+}
+
+FHallidaySecp256k1ContextPool::FScopedContext::~FScopedContext()
+{
+    Pool.Release(Slot, NumSignatures, RandomizeInterval);
+}
+
+secp256k1_context* FHallidaySecp256k1ContextPool::FScopedContext::Get() const
+{
+    return Pool.Slots[Slot].Context;
+}
+
+void FHallidaySecp256k1ContextPool::FScopedContext::AddSignatures(int32 InNumSignatures)
+{
+    NumSignatures += InNumSignatures;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "secp256k1.h"
+#include <atomic>
+
+/**
+ * Fixed set of secp256k1 contexts that live in one preallocated arena so that threads can sign at the same time.
+ * Every context is cloned with secp256k1_context_preallocated_clone() from a randomized master and then given its own blinding.
+ * Memory is only allocated by Create(). Acquiring, signing with, re-randomizing and releasing a context never touch the allocator.
+ */
+class FHallidaySecp256k1ContextPool
+{
+public:
+    /**
+     * Lease of one context that is returned to the pool when it goes out of scope.
+     */
+    class FScopedContext
+    {
+    public:
+        /**
+         * Acquire a context, waiting for one to be released if all of them are in use.
+         * @param InPool Pool to acquire from.
+         * @param InRandomizeInterval Re-randomize the context after this many signatures. 0 disables re-randomization.
+         */
+        FScopedContext(FHallidaySecp256k1ContextPool& InPool, int32 InRandomizeInterval);
+        ~FScopedContext();
+
+        FScopedContext(const FScopedContext&) = delete;
+        FScopedContext& operator=(const FScopedContext&) = delete;
+
+        /** The leased context. Only use it until this lease goes out of scope. */
+        secp256k1_context* Get() const;
+
+        /** Record signatures made with the context so the pool knows when to re-randomize it. */
+        void AddSignatures(int32 NumSignatures);
+
+    private:
+        FHallidaySecp256k1ContextPool& Pool;
+        int32 Slot;
+        int32 RandomizeInterval;
+        int32 NumSignatures = 0;
+    };
+
+    /**
+     * Create a pool with one context per thread that may sign at the same time.
+     * @param NumContexts Number of contexts. Usually the number of task graph workers plus the game thread.
+     * @returns The pool, or nullptr if secp256k1 could not be initialized or randomized.
+     */
+    static FHallidaySecp256k1ContextPool* Create(int32 NumContexts);
+
+    ~FHallidaySecp256k1ContextPool();
+
+    /** Number of contexts in the pool. */
+    int32 Num() const { return NumSlots; }
+
+private:
+    /** One context and its lease state. Aligned to a cache line so threads signing side by side do not share lines. */
+    struct alignas(PLATFORM_CACHE_LINE_SIZE) FSlot
+    {
+        secp256k1_context* Context = nullptr;
+        std::atomic<bool> bInUse{ false };
+        int32 SignaturesSinceRandomize = 0;
+    };
+
+    FHallidaySecp256k1ContextPool() = default;
+
+    int32 Acquire();
+    void Release(int32 Slot, int32 NumSignatures, int32 RandomizeInterval);
+
+    /** Re-randomize a context in place with fresh entropy from the operating system. */
+    static bool Randomize(secp256k1_context* Context);
+
+    /** One block of memory that holds every context. */
+    void* Arena = nullptr;
+
+    /** Lease state of each context. */
+    FSlot* Slots = nullptr;
+
+    int32 NumSlots = 0;
+};
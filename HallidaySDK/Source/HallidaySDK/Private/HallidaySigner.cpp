@@ -0,0 +1,379 @@
+#include "HallidaySigner.h"
+#include "HallidayHex.h"
+#include "HallidayKeccak.h"
+#include "HallidaySecp256k1ContextPool.h"
+#include "Async/ParallelFor.h"
+#include "secp256k1_recovery.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#elif PLATFORM_UNIX || PLATFORM_APPLE || PLATFORM_ANDROID
+#include <sys/mman.h>
+#endif
+
+/**
+ * Zero a buffer that holds sensitive data. The volatile writes prevent the compiler from removing the zeroing as a dead store.
+ * @param Data Buffer to zero
+ * @param Size Size of the buffer
+ */
+static void SecureZero(void* Data, size_t Size)
+{
+    volatile uint8* Bytes = static_cast<volatile uint8*>(Data);
+    while (Size--)
+    {
+        *Bytes++ = 0;
+    }
+}
+
+/**
+ * Decode a 64 character hex private key into a 32 byte secret key without any intermediate heap copies.
+ * @param PrivateKeyHex Hex string of the private key with or without "0x" as the prefix.
+ * @param OutSecretKey Buffer of 32 bytes that receives the key. It is zeroed if the key is invalid.
+ * @returns A boolean to indicate whether the key was valid hex of the right length.
+ */
+static bool HexStringToSecretKey(const FString& PrivateKeyHex, uint8* OutSecretKey)
+{
+    if (!FHallidayHex::Decode(PrivateKeyHex, OutSecretKey, 32))
+    {
+        SecureZero(OutSecretKey, 32);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Lock pages in RAM so that they are never written to the page file.
+ * @param Pages Page aligned memory to lock.
+ * @param Size Size of the memory in bytes.
+ * @returns False if the platform cannot lock memory or the process has used up its allowance, e.g. RLIMIT_MEMLOCK.
+ */
+static bool LockPages(void* Pages, SIZE_T Size)
+{
+#if PLATFORM_WINDOWS
+    return ::VirtualLock(Pages, Size) != 0;
+#elif PLATFORM_UNIX || PLATFORM_APPLE || PLATFORM_ANDROID
+    return mlock(Pages, Size) == 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Unlock pages that were locked with LockPages().
+ * @param Pages Memory that was locked.
+ * @param Size Size of the memory in bytes.
+ */
+static void UnlockPages(void* Pages, SIZE_T Size)
+{
+#if PLATFORM_WINDOWS
+    ::VirtualUnlock(Pages, Size);
+#elif PLATFORM_UNIX || PLATFORM_APPLE || PLATFORM_ANDROID
+    munlock(Pages, Size);
+#endif
+}
+
+FHallidaySigner::FHallidaySigner()
+{
+    // The key gets a page from the OS for itself, because locks apply to whole pages and unlocking a shared page would unlock its neighbours as well.
+    SecretKeyPageSize = FPlatformMemory::GetConstants().PageSize;
+    SecretKey = static_cast<uint8*>(FPlatformMemory::BinnedAllocFromOS(SecretKeyPageSize));
+    SecureZero(SecretKey, SecretKeyPageSize);
+
+    bIsSecretKeyLocked = LockPages(SecretKey, SecretKeyPageSize);
+    if (!bIsSecretKeyLocked)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[Halliday] Could not lock the memory of the signing key in RAM. The key may be written to the page file."));
+    }
+}
+
+FHallidaySigner::~FHallidaySigner()
+{
+    Reset();
+
+    if (bIsSecretKeyLocked)
+    {
+        UnlockPages(SecretKey, SecretKeyPageSize);
+    }
+    FPlatformMemory::BinnedFreeToOS(SecretKey, SecretKeyPageSize);
+}
+
+bool FHallidaySigner::CreateContextPool()
+{
+    FRWScopeLock ScopeLock(Lock, SLT_Write);
+
+    if (ContextPool)
+    {
+        return true;
+    }
+
+    // One context for every task graph worker, the game thread and the background thread that signs submissions.
+    ContextPool = FHallidaySecp256k1ContextPool::Create(FTaskGraphInterface::Get().GetNumWorkerThreads() + 2);
+    return ContextPool != nullptr;
+}
+
+void FHallidaySigner::SetRandomizeInterval(int32 InRandomizeInterval)
+{
+    RandomizeInterval.store(FMath::Max(InRandomizeInterval, 0), std::memory_order_relaxed);
+}
+
+void FHallidaySigner::Reset()
+{
+    FRWScopeLock ScopeLock(Lock, SLT_Write);
+
+    ClearPlayerKeyLocked();
+    for (FHallidaySigningKey& Key : Keys)
+    {
+        SecureZero(Key.SecretKey, sizeof(Key.SecretKey));
+    }
+    Keys.Empty();
+
+    delete ContextPool;
+    ContextPool = nullptr;
+}
+
+bool FHallidaySigner::LoadPlayerKey(const FString& PrivateKeyHex)
+{
+    FRWScopeLock ScopeLock(Lock, SLT_Write);
+
+    ClearPlayerKeyLocked();
+    if (!ContextPool)
+    {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Cannot load the signing key because the secp256k1 context pool does not exist."));
+        return false;
+    }
+
+    if (!HexStringToSecretKey(PrivateKeyHex, SecretKey))
+    {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] The private key returned by Web3Auth is not a 64 character hex string."));
+        return false;
+    }
+
+    FHallidaySecp256k1ContextPool::FScopedContext Ctx(*ContextPool, RandomizeInterval.load(std::memory_order_relaxed));
+
+    // Derive the public key once so that wallet creation never has to recompute it.
+    if (secp256k1_ec_pubkey_create(Ctx.Get(), &PublicKey, SecretKey) != 1)
+    {
+        SecureZero(SecretKey, SecretKeySize);
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to generate the public key of the logged in player."));
+        return false;
+    }
+
+    // Serialize the public key in both formats.
+    size_t Len = sizeof(PublicKeyUncompressed);
+    secp256k1_ec_pubkey_serialize(Ctx.Get(), PublicKeyUncompressed, &Len, &PublicKey, SECP256K1_EC_UNCOMPRESSED);
+    Len = sizeof(PublicKeyCompressed);
+    secp256k1_ec_pubkey_serialize(Ctx.Get(), PublicKeyCompressed, &Len, &PublicKey, SECP256K1_EC_COMPRESSED);
+
+    // Convert the uncompressed public key into a hex string. This will NOT have "0x" as a prefix.
+    PublicKeyHex = FHallidayHex::Encode(PublicKeyUncompressed, sizeof(PublicKeyUncompressed), false);
+
+    // The signer address is the last 20 bytes of the Keccak256 hash of the public key without its 0x04 prefix byte.
+    uint8 PublicKeyHash[FHallidayKeccak256::DigestSize];
+    FHallidayKeccak256::Hash(PublicKeyUncompressed + 1, sizeof(PublicKeyUncompressed) - 1, PublicKeyHash);
+    SignerAddress = FHallidayAddress(PublicKeyHash + 12);
+
+    bHasPlayerKey = true;
+    return true;
+}
+
+void FHallidaySigner::ClearPlayerKey()
+{
+    FRWScopeLock ScopeLock(Lock, SLT_Write);
+    ClearPlayerKeyLocked();
+}
+
+void FHallidaySigner::ClearPlayerKeyLocked()
+{
+    SecureZero(SecretKey, SecretKeySize); // IMPORTANT! DO NOT REMOVE!
+    FMemory::Memzero(&PublicKey, sizeof(PublicKey));
+    FMemory::Memzero(PublicKeyUncompressed, sizeof(PublicKeyUncompressed));
+    FMemory::Memzero(PublicKeyCompressed, sizeof(PublicKeyCompressed));
+    PublicKeyHex.Empty();
+    SignerAddress = FHallidayAddress();
+    bHasPlayerKey = false;
+}
+
+bool FHallidaySigner::GetPublicKeyHex(FString& OutPublicKeyHex) const
+{
+    FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+    OutPublicKeyHex = PublicKeyHex;
+    return bHasPlayerKey;
+}
+
+bool FHallidaySigner::GetSignerAddress(FHallidayAddress& OutAddress) const
+{
+    FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+    OutAddress = SignerAddress;
+    return bHasPlayerKey;
+}
+
+bool FHallidaySigner::SignHash(const FHallidayHash32& Hash, bool bVerify, FHallidaySignature& OutSignature)
+{
+    FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+
+    if (!ContextPool || !bHasPlayerKey)
+    {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Cannot sign '%s' because no player is logged in."), *Hash.ToString());
+        return false;
+    }
+
+    // Lease a context so that other threads can sign at the same time. It is re-randomized on the configured schedule when released.
+    FHallidaySecp256k1ContextPool::FScopedContext Ctx(*ContextPool, RandomizeInterval.load(std::memory_order_relaxed));
+
+    secp256k1_ecdsa_recoverable_signature Signature;
+
+    // Get the recoverable signature.
+    if (secp256k1_ecdsa_sign_recoverable(Ctx.Get(), &Signature, Hash.Bytes, SecretKey, NULL, NULL) != 1)
+    {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to sign '%s' with the key of the logged in player."), *Hash.ToString());
+        return false;
+    }
+    Ctx.AddSignatures(1);
+
+    // Recover the signer and make sure it is the player's key so a bad signature fails here instead of at the bundler.
+    if (bVerify)
+    {
+        secp256k1_pubkey RecoveredPublicKey;
+        if (secp256k1_ecdsa_recover(Ctx.Get(), &RecoveredPublicKey, &Signature, Hash.Bytes) != 1 ||
+            secp256k1_ec_pubkey_cmp(Ctx.Get(), &RecoveredPublicKey, &PublicKey) != 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("[Halliday Error] The signature of '%s' does not recover to the public key of the logged in player."), *Hash.ToString());
+            return false;
+        }
+    }
+
+    // Serialize the recoverable signature into a compact signature.
+    int RecoveryId = 0;
+    secp256k1_ecdsa_recoverable_signature_serialize_compact(Ctx.Get(), OutSignature.Bytes, &RecoveryId, &Signature);
+
+    // Set the v component of the signature using the recovery id given by the serialize function.
+    OutSignature.Bytes[64] = (uint8)(27 + RecoveryId);
+    return true;
+}
+
+int32 FHallidaySigner::AddKey(const FString& PrivateKeyHex)
+{
+    // Batch signing workers lease their contexts from the same pool as the logged in player.
+    if (!CreateContextPool())
+    {
+        return INDEX_NONE;
+    }
+
+    // Verify the key before taking the lock for writing, so that leasing a context never waits on a writer.
+    FHallidaySigningKey NewKey;
+    bool bIsValidKey = HexStringToSecretKey(PrivateKeyHex, NewKey.SecretKey);
+    if (bIsValidKey)
+    {
+        FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+        if (ContextPool)
+        {
+            FHallidaySecp256k1ContextPool::FScopedContext Ctx(*ContextPool, RandomizeInterval.load(std::memory_order_relaxed));
+            bIsValidKey = secp256k1_ec_seckey_verify(Ctx.Get(), NewKey.SecretKey) == 1;
+        }
+    }
+    if (!bIsValidKey)
+    {
+        SecureZero(NewKey.SecretKey, sizeof(NewKey.SecretKey));
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Cannot add a signing key because it is not a valid secp256k1 private key."));
+        return INDEX_NONE;
+    }
+
+    // Adding a key may reallocate the array that SignBatch() reads, so it is only changed under the write lock.
+    FRWScopeLock ScopeLock(Lock, SLT_Write);
+
+    // Reuse the slot of a removed key if there is one.
+    int32 KeyHandle = Keys.IndexOfByPredicate([](const FHallidaySigningKey& Key) { return !Key.bIsValid; });
+    if (KeyHandle == INDEX_NONE)
+    {
+        KeyHandle = Keys.AddZeroed();
+    }
+
+    FHallidaySigningKey& Key = Keys[KeyHandle];
+    FMemory::Memcpy(Key.SecretKey, NewKey.SecretKey, sizeof(Key.SecretKey));
+    SecureZero(NewKey.SecretKey, sizeof(NewKey.SecretKey));
+    Key.bIsValid = true;
+    return KeyHandle;
+}
+
+void FHallidaySigner::RemoveKey(int32 KeyHandle)
+{
+    FRWScopeLock ScopeLock(Lock, SLT_Write);
+
+    if (Keys.IsValidIndex(KeyHandle))
+    {
+        SecureZero(Keys[KeyHandle].SecretKey, sizeof(Keys[KeyHandle].SecretKey));
+        Keys[KeyHandle].bIsValid = false;
+    }
+}
+
+void FHallidaySigner::ClearKeys()
+{
+    FRWScopeLock ScopeLock(Lock, SLT_Write);
+
+    for (FHallidaySigningKey& Key : Keys)
+    {
+        SecureZero(Key.SecretKey, sizeof(Key.SecretKey));
+    }
+    Keys.Empty();
+}
+
+bool FHallidaySigner::SignBatch(const TArray<FHallidaySignRequest>& Requests, int32 NumWorkers, TArray<uint8>& OutSignatures)
+{
+    OutSignatures.SetNumZeroed(Requests.Num() * HALLIDAY_SIGNATURE_SIZE);
+    if (Requests.Num() == 0)
+    {
+        return true;
+    }
+
+    FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+    if (!ContextPool)
+    {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Cannot sign a batch because no signing key has been added."));
+        return false;
+    }
+
+    // Split the batch into one contiguous chunk per worker so that each worker only needs a single context.
+    const int32 NumChunks = FMath::Clamp(NumWorkers, 1, Requests.Num());
+    const int32 ChunkSize = FMath::DivideAndRoundUp(Requests.Num(), NumChunks);
+    const int32 ChunkRandomizeInterval = RandomizeInterval.load(std::memory_order_relaxed);
+
+    std::atomic<bool> bAllSucceeded(true);
+    ParallelFor(NumChunks, [this, &Requests, &OutSignatures, &bAllSucceeded, ChunkSize, ChunkRandomizeInterval](int32 ChunkIndex)
+    {
+        const int32 Begin = ChunkIndex * ChunkSize;
+        const int32 End = FMath::Min(Begin + ChunkSize, Requests.Num());
+
+        // Each worker leases its own preallocated context so that signing never touches the allocator.
+        FHallidaySecp256k1ContextPool::FScopedContext Ctx(*ContextPool, ChunkRandomizeInterval);
+
+        for (int32 i = Begin; i < End; ++i)
+        {
+            const FHallidaySignRequest& SignRequest = Requests[i];
+            uint8* SerializedSignature = OutSignatures.GetData() + i * HALLIDAY_SIGNATURE_SIZE;
+            if (!Keys.IsValidIndex(SignRequest.KeyHandle) || !Keys[SignRequest.KeyHandle].bIsValid)
+            {
+                bAllSucceeded = false;
+                continue;
+            }
+
+            secp256k1_ecdsa_recoverable_signature Signature;
+            if (secp256k1_ecdsa_sign_recoverable(Ctx.Get(), &Signature, SignRequest.Hash.Bytes, Keys[SignRequest.KeyHandle].SecretKey, NULL, NULL) != 1)
+            {
+                bAllSucceeded = false;
+                continue;
+            }
+
+            // Serialize into the contiguous output buffer and set the v component like SignHash().
+            Ctx.AddSignatures(1);
+            int RecoveryId = 0;
+            secp256k1_ecdsa_recoverable_signature_serialize_compact(Ctx.Get(), SerializedSignature, &RecoveryId, &Signature);
+            SerializedSignature[64] = (uint8)(27 + RecoveryId);
+        }
+    });
+
+    if (!bAllSucceeded)
+    {
+        UE_LOG(LogTemp, Error, TEXT("[Halliday Error] Failed to sign some hashes of a batch. Their signatures are left zeroed."));
+    }
+    return bAllSucceeded;
+}
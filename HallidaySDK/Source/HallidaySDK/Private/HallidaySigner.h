@@ -0,0 +1,145 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HallidayTypes.h"
+#include "secp256k1.h"
+#include <atomic>
+
+class FHallidaySecp256k1ContextPool;
+
+/**
+ * The logged in player's key, the keys added for batch signing and the pool of secp256k1 contexts they sign with.
+ * AHalliday shares it with the transaction stages that run on background threads, so that they sign without touching the actor. It stays alive until the last of them is done.
+ * Every method is safe to call from any thread. Signing takes the lock for reading so that threads sign in parallel, and changing a key takes it for writing.
+ */
+class FHallidaySigner
+{
+public:
+    FHallidaySigner();
+    ~FHallidaySigner();
+
+    FHallidaySigner(const FHallidaySigner&) = delete;
+    FHallidaySigner& operator=(const FHallidaySigner&) = delete;
+
+    /**
+     * Create the pool of contexts that every signing path leases from if it does not exist yet.
+     * @returns False if secp256k1 could not be initialized.
+     */
+    bool CreateContextPool();
+
+    /**
+     * Change how often a leased context is re-randomized.
+     * @param InRandomizeInterval Number of signatures after which a context is re-randomized. 0 disables re-randomization.
+     */
+    void SetRandomizeInterval(int32 InRandomizeInterval);
+
+    /** Securely zero every key and destroy the context pool, e.g. because the owner is going away. Signing fails from then on. */
+    void Reset();
+
+    /**
+     * Decode the logged in player's private key and derive the public key and address from it once. The previous key is cleared.
+     * @param PrivateKeyHex 64 character hex string of the private key.
+     * @returns False if the context pool does not exist or the key is malformed.
+     */
+    bool LoadPlayerKey(const FString& PrivateKeyHex);
+
+    /** Securely zero the player's key and clear the cached public key. */
+    void ClearPlayerKey();
+
+    /**
+     * Get the uncompressed public key of the player's key.
+     * @param OutPublicKeyHex Receives the key as a hex string WITHOUT "0x" as the prefix.
+     * @returns False if no player key is loaded.
+     */
+    bool GetPublicKeyHex(FString& OutPublicKeyHex) const;
+
+    /**
+     * Get the address of the player's key.
+     * @param OutAddress Receives the address.
+     * @returns False if no player key is loaded.
+     */
+    bool GetSignerAddress(FHallidayAddress& OutAddress) const;
+
+    /**
+     * Sign a 32 byte hash with the player's key.
+     * @param Hash Hash to sign.
+     * @param bVerify Whether to recover the signer from the signature and compare it with the player's public key.
+     * @param OutSignature Receives the compact recoverable signature with v set to 27 or 28.
+     * @returns False if no player key is loaded or signing failed.
+     */
+    bool SignHash(const FHallidayHash32& Hash, bool bVerify, FHallidaySignature& OutSignature);
+
+    /**
+     * Add a key for SignBatch().
+     * @param PrivateKeyHex 64 character hex string of the private key.
+     * @returns A handle for the key, or INDEX_NONE if the key is not a valid secp256k1 private key.
+     */
+    int32 AddKey(const FString& PrivateKeyHex);
+
+    /**
+     * Securely zero a key that was added with AddKey(). Its handle may be reused.
+     * @param KeyHandle Handle returned by AddKey().
+     */
+    void RemoveKey(int32 KeyHandle);
+
+    /** Securely zero every key that was added with AddKey(). */
+    void ClearKeys();
+
+    /**
+     * Sign many hashes with the added keys, spread across workers that each lease one context.
+     * @param Requests Key handles and hashes to sign.
+     * @param NumWorkers Largest number of workers to spread the batch across.
+     * @param OutSignatures Receives HALLIDAY_SIGNATURE_SIZE bytes per request in the same order as Requests. Failed signatures are left zeroed.
+     * @returns False if any hash could not be signed.
+     */
+    bool SignBatch(const TArray<FHallidaySignRequest>& Requests, int32 NumWorkers, TArray<uint8>& OutSignatures);
+
+private:
+    /** Zero the player's key and public key. The lock must be held for writing. */
+    void ClearPlayerKeyLocked();
+
+    /** Randomized secp256k1 contexts, one per thread that may sign at once. */
+    FHallidaySecp256k1ContextPool* ContextPool = nullptr;
+
+    /** Number of signatures after which a context is re-randomized. */
+    std::atomic<int32> RandomizeInterval{64};
+
+    /** Size of a private key in bytes. */
+    static constexpr int32 SecretKeySize = 32;
+
+    /**
+     * The decoded private key of the logged in player. It is the only thing on its page, which is locked in RAM where the platform allows it so that the key is never written to the page file.
+     * The page stays allocated until the signer is destroyed.
+     */
+    uint8* SecretKey = nullptr;
+
+    /** Size of the page SecretKey points to. */
+    SIZE_T SecretKeyPageSize = 0;
+
+    /** Whether the page SecretKey points to is locked in RAM. */
+    bool bIsSecretKeyLocked = false;
+
+    /** Whether SecretKey and the public key below hold the key of a logged in player. */
+    bool bHasPlayerKey = false;
+
+    /** Public key derived from SecretKey. */
+    secp256k1_pubkey PublicKey;
+
+    /** PublicKey serialized in the 65 byte uncompressed format. */
+    uint8 PublicKeyUncompressed[65] = {0};
+
+    /** PublicKey serialized in the 33 byte compressed format. */
+    uint8 PublicKeyCompressed[33] = {0};
+
+    /** PublicKeyUncompressed formatted as a hex string WITHOUT "0x" as the prefix. */
+    FString PublicKeyHex;
+
+    /** Address of PublicKey. This is the non-custodial owner of the player's wallet. */
+    FHallidayAddress SignerAddress;
+
+    /** Keys that were added with AddKey(). Handles are indices into this array. */
+    TArray<FHallidaySigningKey> Keys;
+
+    /** Guards everything above except RandomizeInterval. */
+    mutable FRWLock Lock;
+};
@@ -0,0 +1,224 @@
+#include "HallidayTypes.h"
+#include "HallidayHex.h"
+#include "HallidayKeccak.h"
+
+/**
+ * Compare two byte arrays in constant time so that comparisons of secrets and signatures do not leak where they first differ.
+ * @returns True if both arrays hold the same bytes.
+ */
+static bool ConstantTimeEquals(const uint8* A, const uint8* B, int32 Size)
+{
+    uint8 Difference = 0;
+    for (int32 i = 0; i < Size; ++i)
+    {
+        Difference |= A[i] ^ B[i];
+    }
+    return Difference == 0;
+}
+
+static bool IsAllZero(const uint8* Bytes, int32 Size)
+{
+    uint8 Accumulated = 0;
+    for (int32 i = 0; i < Size; ++i)
+    {
+        Accumulated |= Bytes[i];
+    }
+    return Accumulated == 0;
+}
+
+/**
+ * Parse exactly Size bytes of hex from the start of an import buffer and advance the buffer past them.
+ * @param Buffer Text to parse. An optional "0x" prefix is skipped.
+ * @param OutBytes Buffer of Size bytes.
+ * @param Size Number of bytes to parse.
+ * @param bAllowEmpty Whether an empty value, i.e. no hex digits at all, is accepted and read as all zeros.
+ * @returns False if the buffer does not start with exactly the expected number of hex digits, e.g. because another hex digit follows them.
+ */
+static bool ImportHexBytes(const TCHAR*& Buffer, uint8* OutBytes, int32 Size, bool bAllowEmpty)
+{
+    const TCHAR* Chars = Buffer;
+    if (Chars[0] == '0' && (Chars[1] == 'x' || Chars[1] == 'X'))
+    {
+        Chars += 2;
+    }
+    
+    int32 NumChars = 0;
+    while (NumChars < Size * 2 && FChar::IsHexDigit(Chars[NumChars]))
+    {
+        ++NumChars;
+    }
+    
+    if (NumChars == 0 && bAllowEmpty)
+    {
+        FMemory::Memzero(OutBytes, Size);
+        Buffer = Chars;
+        return true;
+    }
+    // A longer value would otherwise be silently truncated to its first Size bytes.
+    if (NumChars != Size * 2 || FChar::IsHexDigit(Chars[NumChars]) || !FHallidayHex::DecodeChars(Chars, Size, OutBytes))
+    {
+        return false;
+    }
+    
+    Buffer = Chars + NumChars;
+    return true;
+}
+
+FHallidayAddress::FHallidayAddress()
+{
+    FMemory::Memzero(Bytes, Size);
+}
+
+FHallidayAddress::FHallidayAddress(const uint8* InBytes)
+{
+    FMemory::Memcpy(Bytes, InBytes, Size);
+}
+
+bool FHallidayAddress::FromString(const FString& HexString, FHallidayAddress& OutAddress)
+{
+    return FHallidayHex::Decode(HexString, OutAddress.Bytes, Size);
+}
+
+FString FHallidayAddress::ToString() const
+{
+    // EIP-55 hashes the lowercase hex address as ASCII and uppercases every letter whose hash nibble is 8 or higher.
+    FString ChecksumAddress = FHallidayHex::Encode(Bytes, Size, true);
+    TCHAR* Chars = ChecksumAddress.GetCharArray().GetData() + 2;
+    ANSICHAR LowercaseAscii[Size * 2];
+    for (int32 i = 0; i < Size * 2; ++i)
+    {
+        LowercaseAscii[i] = (ANSICHAR)Chars[i];
+    }
+    
+    uint8 Hash[FHallidayKeccak256::DigestSize];
+    FHallidayKeccak256::Hash(reinterpret_cast<const uint8*>(LowercaseAscii), sizeof(LowercaseAscii), Hash);
+    
+    for (int32 i = 0; i < Size * 2; ++i)
+    {
+        const uint8 HashNibble = (i % 2 == 0) ? (Hash[i / 2] >> 4) : (Hash[i / 2] & 0x0f);
+        if (HashNibble >= 8 && Chars[i] >= 'a' && Chars[i] <= 'f')
+        {
+            Chars[i] = (TCHAR)(Chars[i] - 'a' + 'A');
+        }
+    }
+    return ChecksumAddress;
+}
+
+bool FHallidayAddress::IsZero() const
+{
+    return IsAllZero(Bytes, Size);
+}
+
+bool FHallidayAddress::operator==(const FHallidayAddress& Other) const
+{
+    return ConstantTimeEquals(Bytes, Other.Bytes, Size);
+}
+
+bool FHallidayAddress::ExportTextItem(FString& ValueStr, const FHallidayAddress& DefaultValue, UObject* Parent, int32 PortFlags, UObject* ExportRootScope) const
+{
+    ValueStr += ToString();
+    return true;
+}
+
+bool FHallidayAddress::ImportTextItem(const TCHAR*& Buffer, int32 PortFlags, UObject* Parent, FOutputDevice* ErrorText)
+{
+    return ImportHexBytes(Buffer, Bytes, Size, false);
+}
+
+uint32 GetTypeHash(const FHallidayAddress& Address)
+{
+    return FCrc::MemCrc32(Address.Bytes, FHallidayAddress::Size);
+}
+
+FHallidayHash32::FHallidayHash32()
+{
+    FMemory::Memzero(Bytes, Size);
+}
+
+FHallidayHash32::FHallidayHash32(const uint8* InBytes)
+{
+    FMemory::Memcpy(Bytes, InBytes, Size);
+}
+
+bool FHallidayHash32::FromString(const FString& HexString, FHallidayHash32& OutHash)
+{
+    return FHallidayHex::Decode(HexString, OutHash.Bytes, Size);
+}
+
+FString FHallidayHash32::ToString() const
+{
+    return FHallidayHex::Encode(Bytes, Size, true);
+}
+
+bool FHallidayHash32::IsZero() const
+{
+    return IsAllZero(Bytes, Size);
+}
+
+bool FHallidayHash32::operator==(const FHallidayHash32& Other) const
+{
+    return ConstantTimeEquals(Bytes, Other.Bytes, Size);
+}
+
+bool FHallidayHash32::ExportTextItem(FString& ValueStr, const FHallidayHash32& DefaultValue, UObject* Parent, int32 PortFlags, UObject* ExportRootScope) const
+{
+    ValueStr += ToString();
+    return true;
+}
+
+bool FHallidayHash32::ImportTextItem(const TCHAR*& Buffer, int32 PortFlags, UObject* Parent, FOutputDevice* ErrorText)
+{
+    return ImportHexBytes(Buffer, Bytes, Size, false);
+}
+
+uint32 GetTypeHash(const FHallidayHash32& Hash)
+{
+    return FCrc::MemCrc32(Hash.Bytes, FHallidayHash32::Size);
+}
+
+FHallidaySignature::FHallidaySignature()
+{
+    FMemory::Memzero(Bytes, Size);
+}
+
+FHallidaySignature::FHallidaySignature(const uint8* InBytes)
+{
+    FMemory::Memcpy(Bytes, InBytes, Size);
+}
+
+bool FHallidaySignature::FromString(const FString& HexString, FHallidaySignature& OutSignature)
+{
+    return FHallidayHex::Decode(HexString, OutSignature.Bytes, Size);
+}
+
+FString FHallidaySignature::ToString() const
+{
+    return FHallidayHex::Encode(Bytes, Size, true);
+}
+
+bool FHallidaySignature::IsZero() const
+{
+    return IsAllZero(Bytes, Size);
+}
+
+bool FHallidaySignature::operator==(const FHallidaySignature& Other) const
+{
+    return ConstantTimeEquals(Bytes, Other.Bytes, Size);
+}
+
+bool FHallidaySignature::ExportTextItem(FString& ValueStr, const FHallidaySignature& DefaultValue, UObject* Parent, int32 PortFlags, UObject* ExportRootScope) const
+{
+    ValueStr += ToString();
+    return true;
+}
+
+bool FHallidaySignature::ImportTextItem(const TCHAR*& Buffer, int32 PortFlags, UObject* Parent, FOutputDevice* ErrorText)
+{
+    // Unsigned transactions are returned by the backend with an empty signature.
+    return ImportHexBytes(Buffer, Bytes, Size, true);
+}
+
+uint32 GetTypeHash(const FHallidaySignature& Signature)
+{
+    return FCrc::MemCrc32(Signature.Bytes, FHallidaySignature::Size);
+}
@@ -0,0 +1,52 @@
+#include "HallidayTypesLibrary.h"
+
+FHallidayAddress UHallidayTypesLibrary::MakeHallidayAddress(const FString& HexString, bool& bSuccess)
+{
+    FHallidayAddress Address;
+    bSuccess = FHallidayAddress::FromString(HexString, Address);
+    return Address;
+}
+
+FString UHallidayTypesLibrary::Conv_HallidayAddressToString(const FHallidayAddress& Address)
+{
+    return Address.ToString();
+}
+
+bool UHallidayTypesLibrary::EqualEqual_HallidayAddress(const FHallidayAddress& A, const FHallidayAddress& B)
+{
+    return A == B;
+}
+
+FHallidayHash32 UHallidayTypesLibrary::MakeHallidayHash32(const FString& HexString, bool& bSuccess)
+{
+    FHallidayHash32 Hash;
+    bSuccess = FHallidayHash32::FromString(HexString, Hash);
+    return Hash;
+}
+
+FString UHallidayTypesLibrary::Conv_HallidayHash32ToString(const FHallidayHash32& Hash)
+{
+    return Hash.ToString();
+}
+
+bool UHallidayTypesLibrary::EqualEqual_HallidayHash32(const FHallidayHash32& A, const FHallidayHash32& B)
+{
+    return A == B;
+}
+
+FHallidaySignature UHallidayTypesLibrary::MakeHallidaySignature(const FString& HexString, bool& bSuccess)
+{
+    FHallidaySignature Signature;
+    bSuccess = FHallidaySignature::FromString(HexString, Signature);
+    return Signature;
+}
+
+FString UHallidayTypesLibrary::Conv_HallidaySignatureToString(const FHallidaySignature& Signature)
+{
+    return Signature.ToString();
+}
+
+bool UHallidayTypesLibrary::EqualEqual_HallidaySignature(const FHallidaySignature& A, const FHallidaySignature& B)
+{
+    return A == B;
+}
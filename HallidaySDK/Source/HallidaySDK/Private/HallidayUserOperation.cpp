@@ -0,0 +1,66 @@
+#include "HallidayUserOperation.h"
+#include "HallidayHex.h"
+#include "HallidayKeccak.h"
+
+/**
+ * Write a hex encoded number as a 32 byte big-endian ABI word.
+ * @param HexString Hex string with or without "0x" as the prefix. Leading zero nibbles may be omitted.
+ * @param OutWord Buffer of 32 bytes that receives the word.
+ * @returns A boolean to indicate whether the value was valid hex and fits in 32 bytes.
+ */
+static bool HexStringToWord(const FString& HexString, uint8* OutWord)
+{
+    return FHallidayHex::DecodeNumber(HexString, OutWord, 32);
+}
+
+/**
+ * Hash the bytes of a hex string with Keccak256 into a 32 byte word. This is how dynamic bytes are packed into a UserOperation.
+ * @param HexString Hex string with or without "0x" as the prefix.
+ * @param OutWord Buffer of 32 bytes that receives the hash.
+ * @returns A boolean to indicate whether the value was valid hex.
+ */
+static bool HashHexStringToWord(const FString& HexString, uint8* OutWord)
+{
+    TArray<uint8> Bytes;
+    if (!FHallidayHex::Decode(HexString, Bytes))
+    {
+        return false;
+    }
+
+    FHallidayKeccak256::Hash(Bytes.GetData(), Bytes.Num(), OutWord);
+    return true;
+}
+
+bool FHallidayUserOperation::ComputeHash(const FAATransaction& Transaction, const FHallidayAddress& EntryPoint, uint64 ChainId, FHallidayHash32& OutHash)
+{
+    // pack(UserOp) is the ABI encoding of the ten static words below. Dynamic bytes are replaced by their hash.
+    uint8 Packed[10 * 32];
+    FMemory::Memzero(Packed, 12);
+    FMemory::Memcpy(Packed + 12, Transaction.sender.Bytes, FHallidayAddress::Size);
+    const bool bIsValid =
+        HexStringToWord(Transaction.nonce.hex, Packed + 1 * 32) &&
+        HashHexStringToWord(Transaction.initCode, Packed + 2 * 32) &&
+        HashHexStringToWord(Transaction.callData, Packed + 3 * 32) &&
+        HexStringToWord(Transaction.callGasLimit.hex, Packed + 4 * 32) &&
+        HexStringToWord(Transaction.verificationGasLimit.hex, Packed + 5 * 32) &&
+        HexStringToWord(Transaction.preVerificationGas.hex, Packed + 6 * 32) &&
+        HexStringToWord(Transaction.maxFeePerGas.hex, Packed + 7 * 32) &&
+        HexStringToWord(Transaction.maxPriorityFeePerGas.hex, Packed + 8 * 32) &&
+        HashHexStringToWord(Transaction.paymasterAndData, Packed + 9 * 32);
+    if (!bIsValid)
+    {
+        return false;
+    }
+
+    uint8 Encoded[3 * 32];
+    FHallidayKeccak256::Hash(Packed, sizeof(Packed), Encoded);
+    FMemory::Memzero(Encoded + 32, 64);
+    FMemory::Memcpy(Encoded + 32 + 12, EntryPoint.Bytes, FHallidayAddress::Size);
+    for (int32 i = 0; i < 8; ++i)
+    {
+        Encoded[95 - i] = (uint8)(ChainId >> (i * 8));
+    }
+
+    FHallidayKeccak256::Hash(Encoded, sizeof(Encoded), OutHash.Bytes);
+    return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HallidayTypes.h"
+
+/**
+ * Local hashing of the ERC-4337 UserOperations built by the Halliday backend, so that the tx_hash it returns can be checked before it is signed.
+ */
+class FHallidayUserOperation
+{
+public:
+    /**
+     * Compute the ERC-4337 (EntryPoint v0.6) UserOperation hash of a transaction, i.e.
+     * keccak256(abi.encode(keccak256(pack(UserOp)), EntryPoint, ChainId)).
+     * @param Transaction UserOperation returned by the Halliday backend.
+     * @param EntryPoint Address of the EntryPoint contract.
+     * @param ChainId Chain id of the blockchain the UserOperation is executed on.
+     * @param OutHash Receives the UserOperation hash.
+     * @returns False if a field of the transaction is malformed.
+     */
+    static bool ComputeHash(const FAATransaction& Transaction, const FHallidayAddress& EntryPoint, uint64 ChainId, FHallidayHash32& OutHash);
+};
@@ -0,0 +1,104 @@
+#include "HallidayWalletCache.h"
+#include "HAL/FileManager.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+
+void FHallidayWalletCache::Load(const FString& InFilePath)
+{
+    FilePath = InFilePath;
+    Wallets.Reset();
+
+    FString Json;
+    if (!FFileHelper::LoadFileToString(Json, *FilePath))
+    {
+        return;
+    }
+
+    // The file has the same shape as the response of client/accounts/{id}/wallets.
+    FGetWalletsResponse Saved;
+    if (!FJsonObjectConverter::JsonObjectStringToUStruct(Json, &Saved, 0, 0))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[Halliday] Ignoring the wallet cache '%s' because it is malformed."), *FilePath);
+        return;
+    }
+
+    for (const FWallet& Wallet : Saved.wallets)
+    {
+        if (!Wallet.in_game_player_id.IsEmpty() && !Wallet.account_address.IsEmpty())
+        {
+            Wallets.Add(MakeKey(Wallet.in_game_player_id, Wallet.blockchain_type), Wallet);
+        }
+    }
+}
+
+bool FHallidayWalletCache::Find(const FString& InGamePlayerId, EBlockchainType BlockchainType, FWallet& OutWallet) const
+{
+    const FWallet* Wallet = Wallets.Find(MakeKey(InGamePlayerId, BlockchainType));
+    if (Wallet == nullptr)
+    {
+        return false;
+    }
+
+    OutWallet = *Wallet;
+    return true;
+}
+
+void FHallidayWalletCache::Add(const FWallet& Wallet)
+{
+    FWallet& Cached = Wallets.FindOrAdd(MakeKey(Wallet.in_game_player_id, Wallet.blockchain_type));
+    if (Cached.account_address == Wallet.account_address && Cached.in_game_player_id == Wallet.in_game_player_id)
+    {
+        return;
+    }
+
+    Cached = Wallet;
+    Save();
+}
+
+void FHallidayWalletCache::Remove(const FString& InGamePlayerId)
+{
+    const int32 NumBefore = Wallets.Num();
+    for (auto It = Wallets.CreateIterator(); It; ++It)
+    {
+        if (It.Value().in_game_player_id == InGamePlayerId)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    if (Wallets.Num() != NumBefore)
+    {
+        Save();
+    }
+}
+
+void FHallidayWalletCache::Empty()
+{
+    Wallets.Empty();
+    if (!FilePath.IsEmpty())
+    {
+        IFileManager::Get().Delete(*FilePath, false, false, true);
+    }
+}
+
+void FHallidayWalletCache::Save() const
+{
+    if (FilePath.IsEmpty())
+    {
+        return;
+    }
+
+    FGetWalletsResponse Saved;
+    Wallets.GenerateValueArray(Saved.wallets);
+
+    FString Json;
+    if (!FJsonObjectConverter::UStructToJsonObjectString(Saved, Json) || !FFileHelper::SaveStringToFile(Json, *FilePath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[Halliday] Failed to save the wallet cache to '%s'."), *FilePath);
+    }
+}
+
+FString FHallidayWalletCache::MakeKey(const FString& InGamePlayerId, EBlockchainType BlockchainType)
+{
+    return FString::Printf(TEXT("%s|%d"), *InGamePlayerId, (int32)BlockchainType);
+}
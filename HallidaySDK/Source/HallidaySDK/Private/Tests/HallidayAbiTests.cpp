@@ -0,0 +1,226 @@
+#include "HallidayAbi.h"
+#include "HallidayHex.h"
+#include "HallidaySelectors.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Sender of the test calls. */
+static const TCHAR* TestFromAddress = TEXT("0x5FF137D4b0FDCD49DcA30c7CF57E578a026d2789");
+
+/** Recipient of the test calls. */
+static const TCHAR* TestToAddress = TEXT("0xd8dA6BF26964aF9D7eEd9e03E53415D37aA96045");
+
+/** transfer(address,uint256) of 1e18 base units. */
+static const TCHAR* Erc20TransferCalldata =
+    TEXT("a9059cbb")
+    TEXT("000000000000000000000000d8da6bf26964af9d7eed9e03e53415d37aa96045")
+    TEXT("0000000000000000000000000000000000000000000000000de0b6b3a7640000");
+
+/** safeTransferFrom(address,address,uint256,bytes) of token 42 with 0xcafe as the data. */
+static const TCHAR* Erc721SafeTransferFromCalldata =
+    TEXT("b88d4fde")
+    TEXT("0000000000000000000000005ff137d4b0fdcd49dca30c7cf57e578a026d2789")
+    TEXT("000000000000000000000000d8da6bf26964af9d7eed9e03e53415d37aa96045")
+    TEXT("000000000000000000000000000000000000000000000000000000000000002a")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000080")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000002")
+    TEXT("cafe000000000000000000000000000000000000000000000000000000000000");
+
+/** f(uint256,uint32[],bytes10,bytes) with (0x123, [0x456, 0x789], "1234567890", "Hello, world!") from the examples of the Solidity ABI specification. */
+static const TCHAR* SpecFCalldata =
+    TEXT("8be65246")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000123")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000080")
+    TEXT("3132333435363738393000000000000000000000000000000000000000000000")
+    TEXT("00000000000000000000000000000000000000000000000000000000000000e0")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000002")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000456")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000789")
+    TEXT("000000000000000000000000000000000000000000000000000000000000000d")
+    TEXT("48656c6c6f2c20776f726c642100000000000000000000000000000000000000");
+
+/** g(uint256[][],string[]) with ([[1, 2], [3]], ["one", "two", "three"]) from the examples of the Solidity ABI specification. Nested arrays have offsets relative to their own head. */
+static const TCHAR* SpecGCalldata =
+    TEXT("2289b18c")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000040")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000140")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000002")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000040")
+    TEXT("00000000000000000000000000000000000000000000000000000000000000a0")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000002")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000001")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000002")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000001")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000003")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000003")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000060")
+    TEXT("00000000000000000000000000000000000000000000000000000000000000a0")
+    TEXT("00000000000000000000000000000000000000000000000000000000000000e0")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000003")
+    TEXT("6f6e650000000000000000000000000000000000000000000000000000000000")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000003")
+    TEXT("74776f0000000000000000000000000000000000000000000000000000000000")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000005")
+    TEXT("7468726565000000000000000000000000000000000000000000000000000000");
+
+/** h((uint256,string)[]) with [(1, "one"), (2, "two")]. Every tuple is dynamic, so the array holds an offset per tuple. */
+static const TCHAR* TupleArrayCalldata =
+    TEXT("00d8308e")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000020")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000002")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000040")
+    TEXT("00000000000000000000000000000000000000000000000000000000000000c0")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000001")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000040")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000003")
+    TEXT("6f6e650000000000000000000000000000000000000000000000000000000000")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000002")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000040")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000003")
+    TEXT("74776f0000000000000000000000000000000000000000000000000000000000");
+
+/** k(string[2],uint256) with (["a", "bc"], 7). A T[k] of a dynamic type has no length but is dynamic itself. */
+static const TCHAR* FixedStringArrayCalldata =
+    TEXT("d3f230a8")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000040")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000007")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000040")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000080")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000001")
+    TEXT("6100000000000000000000000000000000000000000000000000000000000000")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000002")
+    TEXT("6263000000000000000000000000000000000000000000000000000000000000");
+
+/** Number of calls encoded per benchmarked variant. */
+static constexpr int32 NumBenchmarkCalls = 100000;
+
+/**
+ * Compare encoded data with a known hex vector.
+ * @param Test Test to report a mismatch to.
+ * @param What Name of the vector.
+ * @param Encoded Data produced by the encoder.
+ * @param ExpectedHex Expected data as hex WITHOUT "0x" as the prefix.
+ */
+static void TestEncoded(FAutomationTestBase& Test, const TCHAR* What, const TArray<uint8>& Encoded, const TCHAR* ExpectedHex)
+{
+    Test.TestEqual(What, FHallidayHex::Encode(Encoded.GetData(), Encoded.Num(), false), FString(ExpectedHex));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayAbiKnownVectorsTest, "Halliday.Abi.KnownVectors", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Encode each vector with the typed template or the builder methods and with the string based EncodeCall() that Blueprints use.
+ * One encoder is reused for every vector, so stale head, tail or offset state left over from a previous call would show up as a mismatch.
+ */
+bool FHallidayAbiKnownVectorsTest::RunTest(const FString& Parameters)
+{
+    FHallidayAddress From;
+    FHallidayAddress To;
+    FHallidayAddress::FromString(TestFromAddress, From);
+    FHallidayAddress::FromString(TestToAddress, To);
+
+    // The runtime hash must agree with the compile-time one.
+    TestTrue(TEXT("Runtime transfer selector"), FHallidayAbiEncoder::ComputeSelector(TEXT("transfer(address,uint256)")) == FHallidayErc20::Transfer);
+    TestTrue(TEXT("Runtime safeTransferFrom selector"), FHallidayAbiEncoder::ComputeSelector(TEXT("safeTransferFrom(address,address,uint256,bytes)")) == FHallidayErc721::SafeTransferFromWithData);
+
+    FHallidayAbiEncoder Encoder;
+
+    // Static arguments only.
+    TestEncoded(*this, TEXT("ERC-20 transfer, typed"), Encoder.EncodeCall(FHallidayErc20::Transfer, To, (uint64)1000000000000000000ull), Erc20TransferCalldata);
+    TestTrue(TEXT("ERC-20 transfer, strings"), Encoder.EncodeCall(TEXT("transfer(address,uint256)"), { TestToAddress, TEXT("1000000000000000000") }));
+    TestEncoded(*this, TEXT("ERC-20 transfer, strings"), Encoder.GetEncoded(), Erc20TransferCalldata);
+
+    // A dynamic bytes argument after static ones.
+    const TArray<uint8> Data = { 0xca, 0xfe };
+    TestEncoded(*this, TEXT("ERC-721 safeTransferFrom, typed"), Encoder.EncodeCall(FHallidayErc721::SafeTransferFromWithData, From, To, (uint64)42, Data), Erc721SafeTransferFromCalldata);
+    TestTrue(TEXT("ERC-721 safeTransferFrom, strings"), Encoder.EncodeCall(TEXT("safeTransferFrom(address,address,uint256,bytes)"), { TestFromAddress, TestToAddress, TEXT("42"), TEXT("0xcafe") }));
+    TestEncoded(*this, TEXT("ERC-721 safeTransferFrom, strings"), Encoder.GetEncoded(), Erc721SafeTransferFromCalldata);
+
+    // Static and dynamic arguments interleaved, so the tail offsets skip static words of the head.
+    Encoder.Begin(FHallidayAbiEncoder::ComputeSelector(TEXT("f(uint256,uint32[],bytes10,bytes)")));
+    Encoder.AddUint((uint64)0x123);
+    Encoder.BeginArray();
+    Encoder.AddUint((uint64)0x456);
+    Encoder.AddUint((uint64)0x789);
+    Encoder.EndArray();
+    Encoder.AddFixedBytes((const uint8*)"1234567890", 10);
+    Encoder.AddBytes((const uint8*)"Hello, world!", 13);
+    TestEncoded(*this, TEXT("Specification f(), builder"), Encoder.Finish(), SpecFCalldata);
+    TestTrue(TEXT("Specification f(), strings"), Encoder.EncodeCall(TEXT("f(uint256,uint32[],bytes10,bytes)"), { TEXT("0x123"), TEXT("[0x456,0x789]"), TEXT("0x31323334353637383930"), TEXT("0x48656c6c6f2c20776f726c6421") }));
+    TestEncoded(*this, TEXT("Specification f(), strings"), Encoder.GetEncoded(), SpecFCalldata);
+
+    // Arrays of dynamic arrays and of strings.
+    const TArray<TArray<uint64>> Numbers = { { 1, 2 }, { 3 } };
+    const TArray<FString> Words = { TEXT("one"), TEXT("two"), TEXT("three") };
+    TestEncoded(*this, TEXT("Specification g(), typed"), Encoder.EncodeCall(FHallidayAbiEncoder::ComputeSelector(TEXT("g(uint256[][],string[])")), Numbers, Words), SpecGCalldata);
+    TestTrue(TEXT("Specification g(), strings"), Encoder.EncodeCall(TEXT("g(uint256[][],string[])"), { TEXT("[[1,2],[3]]"), TEXT("[\"one\",\"two\",\"three\"]") }));
+    TestEncoded(*this, TEXT("Specification g(), strings"), Encoder.GetEncoded(), SpecGCalldata);
+
+    // A dynamic array of dynamic tuples.
+    const TArray<TTuple<uint64, FString>> Pairs = { MakeTuple((uint64)1, FString(TEXT("one"))), MakeTuple((uint64)2, FString(TEXT("two"))) };
+    TestEncoded(*this, TEXT("Tuple array, typed"), Encoder.EncodeCall(FHallidayAbiEncoder::ComputeSelector(TEXT("h((uint256,string)[])")), Pairs), TupleArrayCalldata);
+    TestTrue(TEXT("Tuple array, strings"), Encoder.EncodeCall(TEXT("h((uint256,string)[])"), { TEXT("[(1,\"one\"),(2,\"two\")]") }));
+    TestEncoded(*this, TEXT("Tuple array, strings"), Encoder.GetEncoded(), TupleArrayCalldata);
+
+    // A fixed-size array of a dynamic type followed by a static argument.
+    Encoder.Begin(FHallidayAbiEncoder::ComputeSelector(TEXT("k(string[2],uint256)")));
+    Encoder.BeginTuple();
+    Encoder.AddString(TEXT("a"));
+    Encoder.AddString(TEXT("bc"));
+    Encoder.EndTuple();
+    Encoder.AddUint((uint64)7);
+    TestEncoded(*this, TEXT("Fixed string array, builder"), Encoder.Finish(), FixedStringArrayCalldata);
+    TestTrue(TEXT("Fixed string array, strings"), Encoder.EncodeCall(TEXT("k(string[2],uint256)"), { TEXT("[\"a\",\"bc\"]"), TEXT("7") }));
+    TestEncoded(*this, TEXT("Fixed string array, strings"), Encoder.GetEncoded(), FixedStringArrayCalldata);
+
+    // Malformed input is rejected instead of producing calldata.
+    TestFalse(TEXT("Wrong number of arguments"), Encoder.EncodeCall(TEXT("transfer(address,uint256)"), { TestToAddress }));
+    TestFalse(TEXT("Wrong length of a fixed-size array"), Encoder.EncodeCall(TEXT("k(string[2],uint256)"), { TEXT("[\"a\"]"), TEXT("7") }));
+    TestFalse(TEXT("Number too large for its type"), Encoder.EncodeCall(TEXT("f(uint8)"), { TEXT("256") }));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayAbiEncodeBenchmark, "Halliday.Abi.EncodeBenchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Time encoding ERC-20 and ERC-721 calls with a warm encoder, with the typed template and with the string based EncodeCall().
+ * The last calldata of each variant is checked against its known vector so that the benchmark cannot time a broken encoder.
+ */
+bool FHallidayAbiEncodeBenchmark::RunTest(const FString& Parameters)
+{
+    FHallidayAddress From;
+    FHallidayAddress To;
+    FHallidayAddress::FromString(TestFromAddress, From);
+    FHallidayAddress::FromString(TestToAddress, To);
+    const TArray<uint8> Data = { 0xca, 0xfe };
+    const TArray<FString> Erc20Arguments = { TestToAddress, TEXT("1000000000000000000") };
+    const TArray<FString> Erc721Arguments = { TestFromAddress, TestToAddress, TEXT("42"), TEXT("0xcafe") };
+
+    FHallidayAbiEncoder Encoder;
+    auto Measure = [this, &Encoder](const TCHAR* What, const TCHAR* ExpectedHex, TFunctionRef<void()> EncodeOnce)
+    {
+        // Warm the buffers so that only steady state encoding is timed.
+        EncodeOnce();
+
+        const double StartSeconds = FPlatformTime::Seconds();
+        for (int32 i = 0; i < NumBenchmarkCalls; ++i)
+        {
+            EncodeOnce();
+        }
+        const double Seconds = FPlatformTime::Seconds() - StartSeconds;
+
+        TestEncoded(*this, What, Encoder.GetEncoded(), ExpectedHex);
+        AddInfo(FString::Printf(TEXT("%-34s %8.1f ns/call, %10.0f calls/s"), What, Seconds * 1e9 / NumBenchmarkCalls, NumBenchmarkCalls / Seconds));
+    };
+
+    Measure(TEXT("ERC-20 transfer, typed"), Erc20TransferCalldata, [&]() { Encoder.EncodeCall(FHallidayErc20::Transfer, To, (uint64)1000000000000000000ull); });
+    Measure(TEXT("ERC-20 transfer, strings"), Erc20TransferCalldata, [&]() { Encoder.EncodeCall(TEXT("transfer(address,uint256)"), Erc20Arguments); });
+    Measure(TEXT("ERC-721 safeTransferFrom, typed"), Erc721SafeTransferFromCalldata, [&]() { Encoder.EncodeCall(FHallidayErc721::SafeTransferFromWithData, From, To, (uint64)42, Data); });
+    Measure(TEXT("ERC-721 safeTransferFrom, strings"), Erc721SafeTransferFromCalldata, [&]() { Encoder.EncodeCall(TEXT("safeTransferFrom(address,address,uint256,bytes)"), Erc721Arguments); });
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,91 @@
+#include "HallidayEip712.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Compare a hash with the expected one.
+ * @param Test Test that reports the result.
+ * @param What Name of the hash.
+ * @param Hash Hash to compare.
+ * @param ExpectedHash Expected hash with "0x" as the prefix.
+ */
+static void TestHash(FAutomationTestBase& Test, const TCHAR* What, const FHallidayHash32& Hash, const TCHAR* ExpectedHash)
+{
+    Test.TestEqual(What, Hash.ToString(), FString(ExpectedHash));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayEip712MailTest, "Halliday.Eip712.Mail", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Hash the "Ether Mail" example of the EIP-712 specification and compare every step with the hashes the specification lists.
+ * Mail references the Person struct, which FHallidayEip712Type does not support, so its struct hash is taken from the specification and only combined with the domain here.
+ */
+bool FHallidayEip712MailTest::RunTest(const FString& Parameters)
+{
+    FHallidayEip712Domain Domain;
+    Domain.Name = TEXT("Ether Mail");
+    Domain.Version = TEXT("1");
+    Domain.ChainId = 1;
+    Domain.VerifyingContract = TEXT("0xCcCCccccCCCCcCCCCCCcCcCccCcCCCcCcccccccC");
+
+    FHallidayHash32 DomainSeparator;
+    if (TestTrue(TEXT("Domain hashed"), FHallidayEip712Type::HashDomain(Domain, DomainSeparator)))
+    {
+        TestHash(*this, TEXT("Domain separator"), DomainSeparator, TEXT("0xf2cee375fa42b42143804025fc449deafd50cc031ca257e0b194a650a912090f"));
+    }
+
+    // Whitespace is dropped from the canonical type before it is hashed.
+    FHallidayEip712Type Person;
+    if (!TestTrue(TEXT("Person parsed"), FHallidayEip712Type::Parse(TEXT("Person( string name , address wallet )"), Person)))
+    {
+        return false;
+    }
+    TestEqual(TEXT("Person encoded type"), Person.GetEncodedType(), FString(TEXT("Person(string name,address wallet)")));
+    TestHash(*this, TEXT("Person type hash"), Person.GetTypeHash(), TEXT("0xb9d8c78acf9b987311de6c7b45bb6a9c8e1bf361fa7fd3467a2163f994c79500"));
+
+    FHallidayHash32 FromHash;
+    FHallidayHash32 ToHash;
+    TestTrue(TEXT("From hashed"), Person.HashStruct({ TEXT("Cow"), TEXT("0xCD2a3d9F938E13CD947Ec05AbC7FE734Df8DD826") }, FromHash));
+    TestTrue(TEXT("To hashed"), Person.HashStruct({ TEXT("Bob"), TEXT("0xbBbBBBBbbBBBbbbBbbBbbbbBBbBbbbbBbBbbBBbB") }, ToHash));
+    TestHash(*this, TEXT("From struct hash"), FromHash, TEXT("0xfc71e5fa27ff56c350aa531bc129ebdf613b772b6604664f5d8dbe21b85eb0c8"));
+    TestHash(*this, TEXT("To struct hash"), ToHash, TEXT("0xcd54f074a4af31b4411ff6a60c9719dbd559c221c8ac3492d9d872b041d703d1"));
+
+    // Nested structs are rejected instead of being hashed with the wrong type hash.
+    FHallidayEip712Type Mail;
+    TestFalse(TEXT("Mail with nested Person rejected"), FHallidayEip712Type::Parse(TEXT("Mail(Person from,Person to,string contents)"), Mail));
+
+    FHallidayHash32 MailHash;
+    FHallidayHash32::FromString(TEXT("0xc52c0ee5d84264471806290a3f2c4cecfc5490626bf912d01f240d7a274b371e"), MailHash);
+    FHallidayHash32 Digest;
+    FHallidayEip712::HashTypedData(DomainSeparator, MailHash, Digest);
+    TestHash(*this, TEXT("Typed data digest"), Digest, TEXT("0xbe609aee343fb3c4b28e1df9e632fca64fcfaede20f02e86244efddf30957bd2"));
+
+    // Malformed values are rejected.
+    TestFalse(TEXT("Too few values"), Person.HashStruct({ TEXT("Cow") }, FromHash));
+    TestFalse(TEXT("Malformed address"), Person.HashStruct({ TEXT("Cow"), TEXT("0xCD2a3d9F938E13CD947Ec05AbC7FE734Df8DD82") }, FromHash));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayEip712PersonalMessageTest, "Halliday.Eip712.PersonalMessage", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Hash messages the way personal_sign does and compare them with hashMessage() of ethers.
+ */
+bool FHallidayEip712PersonalMessageTest::RunTest(const FString& Parameters)
+{
+    FHallidayHash32 Hash;
+
+    const FTCHARToUTF8 HelloWorld(TEXT("Hello World"));
+    FHallidayEip712::HashPersonalMessage((const uint8*)HelloWorld.Get(), HelloWorld.Length(), Hash);
+    TestHash(*this, TEXT("Hello World"), Hash, TEXT("0xa1de988600a42c4b4ab089b619297c17d53cffae5d5120d82d8a92d0bb3b78f2"));
+
+    // The length prefix is "0" for an empty message.
+    FHallidayEip712::HashPersonalMessage(nullptr, 0, Hash);
+    TestHash(*this, TEXT("Empty message"), Hash, TEXT("0x5f35dce98ba4fba25530a026ed80b2cecdaa31091ba4958b99b52ea1d068adad"));
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Response that tests fill in directly instead of receiving it from a server.
+ */
+class FHallidayFakeHttpResponse : public IHttpResponse
+{
+public:
+    FHallidayFakeHttpResponse(int32 InResponseCode, const TArray<uint8>& InContent)
+        : ResponseCode(InResponseCode)
+        , Content(InContent)
+    {
+    }
+
+    /** Set a header, replacing any previous value. */
+    void SetHeader(const FString& Name, const FString& Value) { Headers.Add(Name, Value); }
+
+    virtual FString GetURL() const override { return TEXT("https://halliday.test/"); }
+    virtual FString GetURLParameter(const FString& ParameterName) const override { return FString(); }
+    virtual FString GetHeader(const FString& HeaderName) const override
+    {
+        const FString* Value = Headers.Find(HeaderName);
+        return Value ? *Value : FString();
+    }
+    virtual TArray<FString> GetAllHeaders() const override
+    {
+        TArray<FString> AllHeaders;
+        for (const TPair<FString, FString>& Header : Headers)
+        {
+            AllHeaders.Add(Header.Key + TEXT(": ") + Header.Value);
+        }
+        return AllHeaders;
+    }
+    virtual FString GetContentType() const override { return GetHeader(TEXT("Content-Type")); }
+    virtual uint64 GetContentLength() const override { return Content.Num(); }
+    virtual const TArray<uint8>& GetContent() const override { return Content; }
+    virtual int32 GetResponseCode() const override { return ResponseCode; }
+    virtual FString GetContentAsString() const override
+    {
+        const FUTF8ToTCHAR Converter((const ANSICHAR*)Content.GetData(), Content.Num());
+        return FString(Converter.Length(), Converter.Get());
+    }
+
+private:
+    int32 ResponseCode;
+    TArray<uint8> Content;
+
+    /** Header names are matched case-insensitively, as by the HTTP module. */
+    TMap<FString, FString> Headers;
+};
+
+class FHallidayFakeHttpServer;
+
+/**
+ * Request that is answered by the test instead of being sent. It is only completed by Respond(), Fail() or CancelRequest().
+ */
+class FHallidayFakeHttpRequest : public IHttpRequest
+{
+public:
+    explicit FHallidayFakeHttpRequest(FHallidayFakeHttpServer& InServer)
+        : Server(InServer)
+    {
+    }
+
+    /**
+     * Complete the request with a response, as the HTTP module does once the server answers. Does nothing if the request is not in flight.
+     * @param ResponseCode Status code of the response.
+     * @param ResponseHeaders Headers of the response, e.g. Retry-After.
+     */
+    void Respond(int32 ResponseCode, const TMap<FString, FString>& ResponseHeaders = TMap<FString, FString>());
+
+    /** Complete the request without a response, as on a connection error. Does nothing if the request is not in flight. */
+    void Fail();
+
+    /** Whether ProcessRequest() was called and the request has not completed since. */
+    bool IsInFlight() const { return Status == EHttpRequestStatus::Processing; }
+
+    /** Whether CancelRequest() completed the request. */
+    bool WasCancelled() const { return bWasCancelled; }
+
+    /** Make ProcessRequest() complete the request as failed and return false, as it does when a request cannot be started. */
+    bool bFailToStart = false;
+
+    virtual FString GetURL() const override { return URL; }
+    virtual FString GetURLParameter(const FString& ParameterName) const override { return FString(); }
+    virtual FString GetHeader(const FString& HeaderName) const override
+    {
+        const FString* Value = Headers.Find(HeaderName);
+        return Value ? *Value : FString();
+    }
+    virtual TArray<FString> GetAllHeaders() const override
+    {
+        TArray<FString> AllHeaders;
+        for (const TPair<FString, FString>& Header : Headers)
+        {
+            AllHeaders.Add(Header.Key + TEXT(": ") + Header.Value);
+        }
+        return AllHeaders;
+    }
+    virtual FString GetContentType() const override { return GetHeader(TEXT("Content-Type")); }
+    virtual uint64 GetContentLength() const override { return Content.Num(); }
+    virtual const TArray<uint8>& GetContent() const override { return Content; }
+
+    virtual FString GetVerb() const override { return Verb; }
+    virtual void SetVerb(const FString& InVerb) override { Verb = InVerb; }
+    virtual void SetURL(const FString& InURL) override { URL = InURL; }
+    virtual void SetContent(const TArray<uint8>& ContentPayload) override { Content = ContentPayload; }
+    virtual void SetContent(TArray<uint8>&& ContentPayload) override { Content = MoveTemp(ContentPayload); }
+    virtual void SetContentAsString(const FString& ContentString) override
+    {
+        const FTCHARToUTF8 Utf8(*ContentString);
+        Content = TArray<uint8>((const uint8*)Utf8.Get(), Utf8.Length());
+    }
+    virtual bool SetContentAsStreamedFile(const FString& Filename) override { return false; }
+    virtual bool SetContentFromStream(TSharedRef<FArchive, ESPMode::ThreadSafe> Stream) override { return false; }
+    virtual bool SetResponseBodyReceiveStream(TSharedRef<FArchive> Stream) override { return false; }
+    virtual void SetHeader(const FString& HeaderName, const FString& HeaderValue) override { Headers.Add(HeaderName, HeaderValue); }
+    virtual void AppendToHeader(const FString& HeaderName, const FString& AdditionalHeaderValue) override
+    {
+        FString& Value = Headers.FindOrAdd(HeaderName);
+        Value = Value.IsEmpty() ? AdditionalHeaderValue : Value + TEXT(", ") + AdditionalHeaderValue;
+    }
+    virtual void SetTimeout(float InTimeoutSecs) override { Timeout = InTimeoutSecs; }
+    virtual void ClearTimeout() override { Timeout.Reset(); }
+    virtual TOptional<float> GetTimeout() const override { return Timeout; }
+    virtual bool ProcessRequest() override;
+    virtual FHttpRequestCompleteDelegate& OnProcessRequestComplete() override { return CompleteDelegate; }
+    virtual FHttpRequestProgressDelegate& OnRequestProgress() override { return ProgressDelegate; }
+    virtual FHttpRequestWillRetryDelegate& OnRequestWillRetry() override { return WillRetryDelegate; }
+    virtual FHttpRequestHeaderReceivedDelegate& OnHeaderReceived() override { return HeaderReceivedDelegate; }
+    virtual void CancelRequest() override;
+    virtual EHttpRequestStatus::Type GetStatus() const override { return Status; }
+    virtual const FHttpResponsePtr GetResponse() const override { return Response; }
+    virtual void Tick(float DeltaSeconds) override {}
+    virtual float GetElapsedTime() const override { return 0.0f; }
+    virtual void SetDelegateThreadPolicy(EHttpRequestDelegateThreadPolicy InThreadPolicy) override {}
+    virtual EHttpRequestDelegateThreadPolicy GetDelegateThreadPolicy() const override { return EHttpRequestDelegateThreadPolicy::CompleteOnGameThread; }
+
+private:
+    /** Take the request out of flight and execute the completion delegate. */
+    void Finish(EHttpRequestStatus::Type InStatus, FHttpResponsePtr InResponse, bool bWasSuccessful);
+
+    FHallidayFakeHttpServer& Server;
+
+    FString URL;
+    FString Verb = TEXT("GET");
+    TArray<uint8> Content;
+    TMap<FString, FString> Headers;
+    TOptional<float> Timeout;
+
+    EHttpRequestStatus::Type Status = EHttpRequestStatus::NotStarted;
+    FHttpResponsePtr Response;
+    bool bWasCancelled = false;
+
+    FHttpRequestCompleteDelegate CompleteDelegate;
+    FHttpRequestProgressDelegate ProgressDelegate;
+    FHttpRequestWillRetryDelegate WillRetryDelegate;
+    FHttpRequestHeaderReceivedDelegate HeaderReceivedDelegate;
+};
+
+/**
+ * Creates fake requests and keeps track of the ones that were sent, so that a test can answer them in any order.
+ * It must outlive its requests.
+ */
+class FHallidayFakeHttpServer
+{
+public:
+    /**
+     * Create a request.
+     * @param URL URL of the request. Tests use it to tell requests and their copies apart.
+     * @param Verb Verb of the request.
+     */
+    TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> CreateRequest(const FString& URL = FString(), const FString& Verb = TEXT("GET"))
+    {
+        TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> Request = MakeShared<FHallidayFakeHttpRequest, ESPMode::ThreadSafe>(*this);
+        Request->SetURL(URL);
+        Request->SetVerb(Verb);
+        return Request;
+    }
+
+    /** Find the request in flight with a URL, e.g. to answer it. Copies of a request share its URL, so the one sent first is returned. */
+    TSharedPtr<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> FindInFlight(const FString& URL) const
+    {
+        const TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe>* Request = InFlight.FindByPredicate([&URL](const TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe>& Candidate) { return Candidate->GetURL() == URL; });
+        return Request ? TSharedPtr<FHallidayFakeHttpRequest, ESPMode::ThreadSafe>(*Request) : nullptr;
+    }
+
+    /** Requests that were sent and have not completed, in the order they were sent. */
+    TArray<TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe>> InFlight;
+
+    /** URLs of every request that was sent, in the order they were sent. */
+    TArray<FString> SentUrls;
+};
+
+inline void FHallidayFakeHttpRequest::Respond(int32 ResponseCode, const TMap<FString, FString>& ResponseHeaders)
+{
+    TSharedRef<FHallidayFakeHttpResponse, ESPMode::ThreadSafe> FakeResponse = MakeShared<FHallidayFakeHttpResponse, ESPMode::ThreadSafe>(ResponseCode, TArray<uint8>());
+    for (const TPair<FString, FString>& Header : ResponseHeaders)
+    {
+        FakeResponse->SetHeader(Header.Key, Header.Value);
+    }
+    Finish(EHttpRequestStatus::Succeeded, FakeResponse, true);
+}
+
+inline void FHallidayFakeHttpRequest::Fail()
+{
+    Finish(EHttpRequestStatus::Failed, nullptr, false);
+}
+
+inline bool FHallidayFakeHttpRequest::ProcessRequest()
+{
+    if (Status != EHttpRequestStatus::NotStarted)
+    {
+        return false;
+    }
+
+    Status = EHttpRequestStatus::Processing;
+    Server.SentUrls.Add(URL);
+    Server.InFlight.Add(StaticCastSharedRef<FHallidayFakeHttpRequest>(AsShared()));
+    if (bFailToStart)
+    {
+        Fail();
+        return false;
+    }
+    return true;
+}
+
+inline void FHallidayFakeHttpRequest::CancelRequest()
+{
+    if (IsInFlight())
+    {
+        bWasCancelled = true;
+        Finish(EHttpRequestStatus::Failed, nullptr, false);
+    }
+}
+
+inline void FHallidayFakeHttpRequest::Finish(EHttpRequestStatus::Type InStatus, FHttpResponsePtr InResponse, bool bWasSuccessful)
+{
+    if (!IsInFlight())
+    {
+        return;
+    }
+
+    // Keep the request alive while its delegate runs, because the server held the last reference.
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Self = AsShared();
+    Status = InStatus;
+    Response = InResponse;
+    Server.InFlight.RemoveAll([this](const TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe>& Request) { return &Request.Get() == this; });
+    CompleteDelegate.ExecuteIfBound(Self, Response, bWasSuccessful);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,171 @@
+#include "HallidayHex.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Largest number of bytes the round trip test encodes and decodes. Covers several SIMD blocks and every scalar tail length. */
+static constexpr int32 MaxTestSize = 199;
+
+/** Number of times each size is encoded and decoded by the benchmark. */
+static constexpr int32 NumBenchmarkCalls = 100000;
+
+/**
+ * Characters that are not hex digits. These sit just outside the digit and letter ranges, and the wide ones narrow to a hex digit if the high byte is dropped.
+ */
+static const TCHAR BadChars[] = { '/', ':', '@', 'G', '`', 'g', ' ', '\0', (TCHAR)0x0130, (TCHAR)0x0161 };
+
+/**
+ * Fill an array with bytes from a seeded stream so that failures can be reproduced.
+ * @param Size Number of bytes.
+ * @returns The bytes.
+ */
+static TArray<uint8> MakeBytes(int32 Size)
+{
+    FRandomStream Random(Size);
+    TArray<uint8> Bytes;
+    Bytes.SetNumUninitialized(Size);
+    for (int32 i = 0; i < Size; ++i)
+    {
+        Bytes[i] = (uint8)Random.RandHelper(256);
+    }
+    return Bytes;
+}
+
+/**
+ * Encode bytes one character at a time without any of the vectorized paths.
+ * @param Bytes Bytes to encode.
+ * @param bUpperCase Whether to use uppercase letters.
+ * @returns A hex string of the bytes without a prefix.
+ */
+static FString ScalarEncode(const TArray<uint8>& Bytes, bool bUpperCase)
+{
+    FString HexString;
+    for (const uint8 Byte : Bytes)
+    {
+        HexString += FString::Printf(bUpperCase ? TEXT("%02X") : TEXT("%02x"), Byte);
+    }
+    return HexString;
+}
+
+/**
+ * Decode a hex string one character at a time without any of the vectorized paths.
+ * @param HexString Hex string without a prefix.
+ * @param OutBytes Receives the bytes.
+ */
+static void ScalarDecode(const FString& HexString, TArray<uint8>& OutBytes)
+{
+    OutBytes.SetNum(HexString.Len() / 2);
+    for (int32 i = 0; i < OutBytes.Num(); ++i)
+    {
+        OutBytes[i] = (uint8)((FParse::HexDigit(HexString[i * 2]) << 4) | FParse::HexDigit(HexString[i * 2 + 1]));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayHexRoundTripTest, "Halliday.Hex.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Encode and decode every size from 0 to MaxTestSize bytes and compare the results with the scalar reference.
+ * Decoding is checked with lowercase, uppercase and "0x" prefixed input.
+ */
+bool FHallidayHexRoundTripTest::RunTest(const FString& Parameters)
+{
+    TArray<uint8> Decoded;
+    TArray<uint8> Expected;
+    for (int32 Size = 0; Size <= MaxTestSize; ++Size)
+    {
+        const TArray<uint8> Bytes = MakeBytes(Size);
+        const FString Lower = ScalarEncode(Bytes, false);
+        const FString Upper = ScalarEncode(Bytes, true);
+
+        TestEqual(FString::Printf(TEXT("Encode %d bytes"), Size), FHallidayHex::Encode(Bytes.GetData(), Size, false), Lower);
+        TestEqual(FString::Printf(TEXT("Encode %d bytes with prefix"), Size), FHallidayHex::Encode(Bytes.GetData(), Size, true), TEXT("0x") + Lower);
+
+        ScalarDecode(Upper, Expected);
+        TestTrue(FString::Printf(TEXT("Scalar reference for %d bytes"), Size), Expected == Bytes);
+
+        TestTrue(FString::Printf(TEXT("Decode %d bytes lowercase"), Size), FHallidayHex::Decode(Lower, Decoded) && Decoded == Bytes);
+        TestTrue(FString::Printf(TEXT("Decode %d bytes uppercase"), Size), FHallidayHex::Decode(Upper, Decoded) && Decoded == Bytes);
+        TestTrue(FString::Printf(TEXT("Decode %d bytes with prefix"), Size), FHallidayHex::Decode(TEXT("0x") + Lower, Decoded) && Decoded == Bytes);
+
+        Decoded.SetNumUninitialized(Size);
+        TestTrue(FString::Printf(TEXT("Decode %d bytes of fixed size"), Size), FHallidayHex::Decode(Upper, Decoded.GetData(), Size) && Decoded == Bytes);
+        TestFalse(FString::Printf(TEXT("Decode %d bytes as %d bytes"), Size, Size + 1), FHallidayHex::Decode(Upper, Decoded.GetData(), Size + 1));
+    }
+
+    TestFalse(TEXT("Odd length"), FHallidayHex::Decode(FString(TEXT("0xabc")), Decoded));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayHexRejectTest, "Halliday.Hex.RejectBadCharacters", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Put every bad character at every position of every size up to MaxTestSize bytes and check that decoding fails.
+ * This covers both the vectorized blocks and the scalar tail, and both nibbles of a byte.
+ */
+bool FHallidayHexRejectTest::RunTest(const FString& Parameters)
+{
+    TArray<uint8> Decoded;
+    for (int32 Size = 1; Size <= MaxTestSize; ++Size)
+    {
+        const FString Valid = ScalarEncode(MakeBytes(Size), Size % 2 == 0);
+        Decoded.SetNumUninitialized(Size);
+
+        int32 NumAccepted = 0;
+        for (const TCHAR BadChar : BadChars)
+        {
+            for (int32 Position = 0; Position < Size * 2; ++Position)
+            {
+                FString Invalid = Valid;
+                Invalid[Position] = BadChar;
+                NumAccepted += FHallidayHex::DecodeChars(*Invalid, Size, Decoded.GetData()) ? 1 : 0;
+            }
+        }
+        TestEqual(FString::Printf(TEXT("Bad characters accepted in %d bytes"), Size), NumAccepted, 0);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayHexBenchmark, "Halliday.Hex.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Time encoding and decoding addresses, signatures and calldata sized buffers.
+ */
+bool FHallidayHexBenchmark::RunTest(const FString& Parameters)
+{
+    for (const int32 Size : { 20, 65, 1024 })
+    {
+        const TArray<uint8> Bytes = MakeBytes(Size);
+        TArray<TCHAR> Chars;
+        Chars.SetNumUninitialized(Size * 2);
+        TArray<uint8> Decoded;
+        Decoded.SetNumUninitialized(Size);
+
+        double StartSeconds = FPlatformTime::Seconds();
+        for (int32 i = 0; i < NumBenchmarkCalls; ++i)
+        {
+            FHallidayHex::EncodeChars(Bytes.GetData(), Size, Chars.GetData());
+        }
+        const double EncodeSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+        bool bIsValid = true;
+        StartSeconds = FPlatformTime::Seconds();
+        for (int32 i = 0; i < NumBenchmarkCalls; ++i)
+        {
+            bIsValid &= FHallidayHex::DecodeChars(Chars.GetData(), Size, Decoded.GetData());
+        }
+        const double DecodeSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+        // Check the output so that the benchmark cannot time a broken codec.
+        TestTrue(FString::Printf(TEXT("%d bytes round trip"), Size), bIsValid && Decoded == Bytes);
+        AddInfo(FString::Printf(TEXT("%5d bytes: encode %8.1f ns, %7.1f MB/s; decode %8.1f ns, %7.1f MB/s"), Size,
+            EncodeSeconds * 1e9 / NumBenchmarkCalls, (double)Size * NumBenchmarkCalls / EncodeSeconds / 1e6,
+            DecodeSeconds * 1e9 / NumBenchmarkCalls, (double)Size * NumBenchmarkCalls / DecodeSeconds / 1e6));
+    }
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,181 @@
+#include "HallidayHttpCompression.h"
+#include "HallidayFakeHttp.h"
+#include "Misc/AutomationTest.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Window bits that make zlib write a gzip header. */
+static constexpr int32 GzipWindowBits = MAX_WBITS + 16;
+
+/** Window bits that make zlib write a zlib header. */
+static constexpr int32 ZlibWindowBits = MAX_WBITS;
+
+/** Window bits that make zlib write raw deflate data without a header. */
+static constexpr int32 RawDeflateWindowBits = -MAX_WBITS;
+
+/**
+ * Make a JSON body with repetitive rows like the asset and balance responses.
+ */
+static TArray<uint8> MakeJsonBody()
+{
+    FString Json = TEXT("{\"assets\":[");
+    for (int32 i = 0; i < 200; ++i)
+    {
+        Json += FString::Printf(TEXT("%s{\"token_id\":\"%d\",\"name\":\"Sword %d\",\"contract\":\"0xd8da6bf26964af9d7eed9e03e53415d37aa96045\"}"), i > 0 ? TEXT(",") : TEXT(""), i, i);
+    }
+    Json += TEXT("]}");
+
+    const FTCHARToUTF8 Utf8(*Json);
+    return TArray<uint8>((const uint8*)Utf8.Get(), Utf8.Length());
+}
+
+/**
+ * Compress data with zlib.
+ * @param Data Bytes to compress.
+ * @param WindowBits GzipWindowBits, ZlibWindowBits or RawDeflateWindowBits.
+ * @returns The compressed bytes, or an empty array if zlib failed.
+ */
+static TArray<uint8> Compress(const TArray<uint8>& Data, int32 WindowBits)
+{
+    z_stream Stream;
+    FMemory::Memzero(Stream);
+    if (deflateInit2(&Stream, Z_BEST_COMPRESSION, Z_DEFLATED, WindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return TArray<uint8>();
+    }
+
+    TArray<uint8> Compressed;
+    Compressed.SetNumUninitialized(deflateBound(&Stream, Data.Num()));
+    Stream.next_in = (Bytef*)Data.GetData();
+    Stream.avail_in = (uInt)Data.Num();
+    Stream.next_out = Compressed.GetData();
+    Stream.avail_out = (uInt)Compressed.Num();
+    const int Result = deflate(&Stream, Z_FINISH);
+    Compressed.SetNum(Result == Z_STREAM_END ? (int32)Stream.total_out : 0);
+    deflateEnd(&Stream);
+    return Compressed;
+}
+
+/**
+ * Make a response with a body and an optional Content-Encoding header.
+ */
+static TSharedRef<FHallidayFakeHttpResponse> MakeResponse(const TArray<uint8>& Content, const TCHAR* ContentEncoding)
+{
+    TSharedRef<FHallidayFakeHttpResponse> Response = MakeShared<FHallidayFakeHttpResponse>(200, Content);
+    if (ContentEncoding)
+    {
+        Response->SetHeader(TEXT("Content-Encoding"), ContentEncoding);
+    }
+    return Response;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayHttpCompressionInflateTest, "Halliday.HttpCompression.Inflate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Inflate gzip, zlib and raw deflate data, and reject truncated, corrupt and oversized data.
+ */
+bool FHallidayHttpCompressionInflateTest::RunTest(const FString& Parameters)
+{
+    const TArray<uint8> Body = MakeJsonBody();
+    TArray<uint8> Inflated;
+
+    const TArray<uint8> Gzip = Compress(Body, GzipWindowBits);
+    const TArray<uint8> Zlib = Compress(Body, ZlibWindowBits);
+    const TArray<uint8> RawDeflate = Compress(Body, RawDeflateWindowBits);
+    if (!TestTrue(TEXT("Test data compressed"), Gzip.Num() > 0 && Zlib.Num() > 0 && RawDeflate.Num() > 0))
+    {
+        return false;
+    }
+
+    TestTrue(TEXT("gzip"), FHallidayHttpCompression::Inflate(Gzip.GetData(), Gzip.Num(), false, Inflated) && Inflated == Body);
+    TestTrue(TEXT("zlib"), FHallidayHttpCompression::Inflate(Zlib.GetData(), Zlib.Num(), false, Inflated) && Inflated == Body);
+    TestTrue(TEXT("Raw deflate"), FHallidayHttpCompression::Inflate(RawDeflate.GetData(), RawDeflate.Num(), true, Inflated) && Inflated == Body);
+    TestFalse(TEXT("Raw deflate read as zlib"), FHallidayHttpCompression::Inflate(RawDeflate.GetData(), RawDeflate.Num(), false, Inflated));
+
+    // Truncated data must fail instead of returning the part that was inflated, including when only the trailer is missing.
+    TestFalse(TEXT("Truncated gzip"), FHallidayHttpCompression::Inflate(Gzip.GetData(), Gzip.Num() / 2, false, Inflated));
+    TestTrue(TEXT("Truncated gzip leaves no output"), Inflated.Num() == 0);
+    TestFalse(TEXT("gzip without its trailer"), FHallidayHttpCompression::Inflate(Gzip.GetData(), Gzip.Num() - 4, false, Inflated));
+    TestFalse(TEXT("Truncated zlib"), FHallidayHttpCompression::Inflate(Zlib.GetData(), Zlib.Num() / 2, false, Inflated));
+    TestFalse(TEXT("Truncated raw deflate"), FHallidayHttpCompression::Inflate(RawDeflate.GetData(), RawDeflate.Num() / 2, true, Inflated));
+    TestFalse(TEXT("Empty"), FHallidayHttpCompression::Inflate(nullptr, 0, false, Inflated));
+
+    TArray<uint8> Corrupt = Gzip;
+    Corrupt[Corrupt.Num() / 2] ^= 0xff;
+    TestFalse(TEXT("Corrupt gzip"), FHallidayHttpCompression::Inflate(Corrupt.GetData(), Corrupt.Num(), false, Inflated));
+
+    // A small body that inflates past the cap, as a decompression bomb would, is rejected. A body just under the cap is accepted.
+    TArray<uint8> Zeros;
+    Zeros.SetNumZeroed(FHallidayHttpCompression::MaxDecodedSize - 1024);
+    const TArray<uint8> UnderCap = Compress(Zeros, GzipWindowBits);
+    Zeros.AddZeroed(1024 + 1);
+    const TArray<uint8> OverCap = Compress(Zeros, GzipWindowBits);
+    Zeros.Empty();
+    TestTrue(TEXT("Just under MaxDecodedSize"), FHallidayHttpCompression::Inflate(UnderCap.GetData(), UnderCap.Num(), false, Inflated) && Inflated.Num() == FHallidayHttpCompression::MaxDecodedSize - 1024);
+    TestFalse(TEXT("One byte over MaxDecodedSize"), FHallidayHttpCompression::Inflate(OverCap.GetData(), OverCap.Num(), false, Inflated));
+    TestTrue(TEXT("Over the cap leaves no output"), Inflated.Num() == 0);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayHttpCompressionGetContentTest, "Halliday.HttpCompression.GetContent", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Read response bodies that are still compressed, that the HTTP stack already decoded while keeping Content-Encoding, and that are corrupt.
+ */
+bool FHallidayHttpCompressionGetContentTest::RunTest(const FString& Parameters)
+{
+    const TArray<uint8> Body = MakeJsonBody();
+    const FString BodyString = FHallidayHttpCompression::ToString(Body);
+    TArray<uint8> Buffer;
+    bool bWasDecoded = false;
+
+    // Bodies that are still compressed are decoded into the buffer.
+    struct FEncodedCase
+    {
+        const TCHAR* Encoding;
+        int32 WindowBits;
+    };
+    for (const FEncodedCase& Case : { FEncodedCase{ TEXT("gzip"), GzipWindowBits }, FEncodedCase{ TEXT("x-gzip"), GzipWindowBits }, FEncodedCase{ TEXT(" GZIP "), GzipWindowBits }, FEncodedCase{ TEXT("deflate"), ZlibWindowBits }, FEncodedCase{ TEXT("deflate"), RawDeflateWindowBits } })
+    {
+        const FString What = FString::Printf(TEXT("'%s' with %d window bits"), Case.Encoding, Case.WindowBits);
+        TSharedRef<FHallidayFakeHttpResponse> Response = MakeResponse(Compress(Body, Case.WindowBits), Case.Encoding);
+        const TArray<uint8>* Content = FHallidayHttpCompression::GetContent(*Response, Buffer, bWasDecoded);
+        TestTrue(What + TEXT(" decoded"), Content == &Buffer && bWasDecoded && Buffer == Body);
+        TestEqual(What + TEXT(" as a string"), FHallidayHttpCompression::GetContentAsString(*Response), BodyString);
+    }
+
+    // Bodies the HTTP stack already decoded keep a stale Content-Encoding and are passed through untouched.
+    for (const TCHAR* Encoding : { TEXT("gzip"), TEXT("deflate"), TEXT("br"), static_cast<const TCHAR*>(nullptr) })
+    {
+        const FString What = FString::Printf(TEXT("Plain body with '%s'"), Encoding ? Encoding : TEXT("no encoding"));
+        TSharedRef<FHallidayFakeHttpResponse> Response = MakeResponse(Body, Encoding);
+        const TArray<uint8>* Content = FHallidayHttpCompression::GetContent(*Response, Buffer, bWasDecoded);
+        TestTrue(What + TEXT(" passed through"), Content == &Response->GetContent() && !bWasDecoded);
+        TestEqual(What + TEXT(" as a string"), FHallidayHttpCompression::GetContentAsString(*Response), BodyString);
+    }
+
+    // An empty body, e.g. of a 204, is not decoded.
+    TSharedRef<FHallidayFakeHttpResponse> EmptyResponse = MakeResponse(TArray<uint8>(), TEXT("deflate"));
+    TestTrue(TEXT("Empty body passed through"), FHallidayHttpCompression::GetContent(*EmptyResponse, Buffer, bWasDecoded) == &EmptyResponse->GetContent() && !bWasDecoded);
+
+    // Truncated and corrupt bodies fail instead of being passed on as garbage.
+    const TArray<uint8> Gzip = Compress(Body, GzipWindowBits);
+    TSharedRef<FHallidayFakeHttpResponse> TruncatedResponse = MakeResponse(TArray<uint8>(Gzip.GetData(), Gzip.Num() / 2), TEXT("gzip"));
+    AddExpectedError(TEXT("Failed to decode"), EAutomationExpectedErrorFlags::Contains, 3);
+    TestNull(TEXT("Truncated gzip"), FHallidayHttpCompression::GetContent(*TruncatedResponse, Buffer, bWasDecoded));
+    TestFalse(TEXT("Truncated gzip not decoded"), bWasDecoded);
+    TestTrue(TEXT("Truncated gzip as a string"), FHallidayHttpCompression::GetContentAsString(*TruncatedResponse).IsEmpty());
+
+    TArray<uint8> Garbage = { 0x78, 0x9c, 0xde, 0xad, 0xbe, 0xef };
+    TSharedRef<FHallidayFakeHttpResponse> CorruptResponse = MakeResponse(Garbage, TEXT("deflate"));
+    TestNull(TEXT("Corrupt zlib"), FHallidayHttpCompression::GetContent(*CorruptResponse, Buffer, bWasDecoded));
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
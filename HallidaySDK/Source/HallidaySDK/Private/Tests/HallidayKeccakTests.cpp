@@ -0,0 +1,138 @@
+#include "HallidayKeccak.h"
+#include "HallidayHex.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Number of messages hashed per benchmark variant. */
+static constexpr int32 NumBenchmarkHashes = 100000;
+
+/**
+ * Fill a message with a byte pattern that differs at every position of a block.
+ * @param Size Number of bytes in the message.
+ * @returns The message.
+ */
+static TArray<uint8> MakeMessage(int32 Size)
+{
+    TArray<uint8> Message;
+    Message.SetNumUninitialized(Size);
+    for (int32 i = 0; i < Size; ++i)
+    {
+        Message[i] = (uint8)(i * 7 + 3);
+    }
+    return Message;
+}
+
+/**
+ * Hash a message in one call and compare the digest with the expected one.
+ * @param Test Test that reports the result.
+ * @param What Name of the vector.
+ * @param Message Bytes to hash.
+ * @param ExpectedHex Expected digest as lowercase hex without a prefix.
+ */
+static void TestDigest(FAutomationTestBase& Test, const TCHAR* What, const TArray<uint8>& Message, const TCHAR* ExpectedHex)
+{
+    uint8 Digest[FHallidayKeccak256::DigestSize];
+    FHallidayKeccak256::Hash(Message.GetData(), Message.Num(), Digest);
+    Test.TestEqual(What, FHallidayHex::Encode(Digest, FHallidayKeccak256::DigestSize, false), FString(ExpectedHex));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayKeccak256VectorsTest, "Halliday.Keccak256.Vectors", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Hash known vectors with the original Keccak padding, including messages around the 136 byte rate where the padding moves into its own block.
+ * The patterned vectors were generated with an independent reference implementation of Keccak-256.
+ */
+bool FHallidayKeccak256VectorsTest::RunTest(const FString& Parameters)
+{
+    TestDigest(*this, TEXT("Empty"), TArray<uint8>(), TEXT("c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470"));
+
+    const FTCHARToUTF8 Abc(TEXT("abc"));
+    TestDigest(*this, TEXT("abc"), TArray<uint8>((const uint8*)Abc.Get(), Abc.Length()), TEXT("4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45"));
+
+    const FTCHARToUTF8 Fox(TEXT("The quick brown fox jumps over the lazy dog"));
+    TestDigest(*this, TEXT("Quick brown fox"), TArray<uint8>((const uint8*)Fox.Get(), Fox.Length()), TEXT("4d741b6f1eb29cb2a9b9911c82f56fa8d73b04959d3d9d222895df6c0b28aa15"));
+
+    // One byte short of the rate, so both padding bits land in the same byte.
+    TestDigest(*this, TEXT("135 bytes"), MakeMessage(135), TEXT("00ef96af9cf4b24c7f269d922294444a197d0a33638c2e56634c57e892103a8f"));
+    // Exactly the rate, so the padding needs a block of its own.
+    TestDigest(*this, TEXT("136 bytes"), MakeMessage(136), TEXT("742061bcad767ed4c4f5883b1dcb1aad11afdcc140dc469d953759b127b9f9ed"));
+    TestDigest(*this, TEXT("137 bytes"), MakeMessage(137), TEXT("e3371f61e770abf254c34239c3b0099ad90594507415bc81dd0a10b9692bbf2a"));
+    TestDigest(*this, TEXT("272 bytes"), MakeMessage(272), TEXT("ac141fd7b0a0ffcd2e967254d508da3ec616596493c36fa304425647d90e6de5"));
+    TestDigest(*this, TEXT("1000 bytes"), MakeMessage(1000), TEXT("80cdc8dd52cbb3dbaea8f383209893fa2bb52efbd5aedbb4b26dcfe307fcdc9b"));
+
+    // The compile time hasher must agree with the runtime one.
+    constexpr FHallidayKeccak256Digest ConstexprAbc = FHallidayConstexprKeccak256::Hash("abc", 3);
+    TestEqual(TEXT("Constexpr abc"), FHallidayHex::Encode(ConstexprAbc.Bytes, FHallidayKeccak256::DigestSize, false), FString(TEXT("4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45")));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayKeccak256StreamingTest, "Halliday.Keccak256.Streaming", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Stream messages with Update() split at every position and byte by byte, and check that the digest matches the one-shot Hash().
+ * The same hasher is reused after Reset() so that stale state would show up as a mismatch.
+ */
+bool FHallidayKeccak256StreamingTest::RunTest(const FString& Parameters)
+{
+    FHallidayKeccak256 Hasher;
+    uint8 Expected[FHallidayKeccak256::DigestSize];
+    uint8 Digest[FHallidayKeccak256::DigestSize];
+
+    for (const int32 Size : { 0, 1, 31, 32, 135, 136, 137, 271, 272, 273, 409 })
+    {
+        const TArray<uint8> Message = MakeMessage(Size);
+        FHallidayKeccak256::Hash(Message.GetData(), Size, Expected);
+
+        int32 NumMismatches = 0;
+        for (int32 Split = 0; Split <= Size; ++Split)
+        {
+            Hasher.Reset();
+            Hasher.Update(Message.GetData(), Split);
+            Hasher.Update(Message.GetData() + Split, Size - Split);
+            Hasher.Final(Digest);
+            NumMismatches += FMemory::Memcmp(Digest, Expected, FHallidayKeccak256::DigestSize) != 0 ? 1 : 0;
+        }
+        TestEqual(FString::Printf(TEXT("%d bytes split in two"), Size), NumMismatches, 0);
+
+        Hasher.Reset();
+        for (int32 i = 0; i < Size; ++i)
+        {
+            Hasher.Update(Message.GetData() + i, 1);
+        }
+        Hasher.Final(Digest);
+        TestTrue(FString::Printf(TEXT("%d bytes one at a time"), Size), FMemory::Memcmp(Digest, Expected, FHallidayKeccak256::DigestSize) == 0);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayKeccak256Benchmark, "Halliday.Keccak256.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Time hashing a 32 byte tx_hash, as the transaction pipeline does, and longer messages that take several permutations.
+ */
+bool FHallidayKeccak256Benchmark::RunTest(const FString& Parameters)
+{
+    uint8 Digest[FHallidayKeccak256::DigestSize];
+    for (const int32 Size : { 32, 136, 1024 })
+    {
+        TArray<uint8> Message = MakeMessage(Size);
+
+        const double StartSeconds = FPlatformTime::Seconds();
+        for (int32 i = 0; i < NumBenchmarkHashes; ++i)
+        {
+            FHallidayKeccak256::Hash(Message.GetData(), Size, Digest);
+            // Chain the digests so that the calls cannot be hoisted out of the loop.
+            Message[0] = Digest[0];
+        }
+        const double Seconds = FPlatformTime::Seconds() - StartSeconds;
+
+        AddInfo(FString::Printf(TEXT("%5d bytes %8.1f ns/hash, %10.0f hashes/s, %7.1f MB/s"), Size, Seconds * 1e9 / NumBenchmarkHashes, NumBenchmarkHashes / Seconds, (double)Size * NumBenchmarkHashes / Seconds / 1e6));
+    }
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,599 @@
+#include "HallidayRequestScheduler.h"
+#include "HallidayFakeHttp.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Longest time a test waits for a token bucket to let the next request through. Buckets refill in real time at 20 tokens per second. */
+static constexpr double MaxSendWaitSeconds = 2.0;
+
+/** Number of times each request of a test completed, by URL. */
+typedef TMap<FString, int32> FCompletionCounts;
+
+/**
+ * Create a fake request that counts its completions.
+ * @param Server Server that creates and records the request.
+ * @param Counts Receives the completions of the request under its URL. It must outlive the scheduler's requests.
+ * @param URL URL that identifies the request.
+ * @param Verb Verb of the request.
+ * @returns The request.
+ */
+static TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> CreateCountedRequest(FHallidayFakeHttpServer& Server, FCompletionCounts& Counts, const FString& URL, const FString& Verb = TEXT("GET"))
+{
+    TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> Request = Server.CreateRequest(URL, Verb);
+    Counts.Add(URL, 0);
+    Request->OnProcessRequestComplete().BindLambda([&Counts, URL](FHttpRequestPtr CompletedRequest, FHttpResponsePtr Response, bool bWasSuccessful) {
+        ++Counts.FindOrAdd(URL);
+    });
+    return Request;
+}
+
+/**
+ * Create a fake request that counts its completions and enqueue it.
+ * @param Scheduler Scheduler to enqueue the request with.
+ * @param Server Server that creates and records the request.
+ * @param Counts Receives the completions of the request under its URL. It must outlive the scheduler's requests.
+ * @param URL URL that identifies the request.
+ * @param Priority Priority class of the request.
+ * @param PlayerId Player the request is made for.
+ * @param Operation Operation the request is made for, if any.
+ * @returns The request.
+ */
+static TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> EnqueueRequest(FHallidayRequestScheduler& Scheduler, FHallidayFakeHttpServer& Server, FCompletionCounts& Counts, const FString& URL, EHallidayRequestPriority Priority, const FString& PlayerId, const TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe>& Operation = nullptr)
+{
+    TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> Request = CreateCountedRequest(Server, Counts, URL);
+    Scheduler.Enqueue(Request, Priority, PlayerId, Operation);
+    return Request;
+}
+
+/**
+ * Create a scheduler that sends at most MaxInFlight requests at once and creates the copies of requeued and hedged requests on the fake server.
+ */
+static TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> MakeScheduler(FHallidayFakeHttpServer& Server, int32 MaxInFlight = 1)
+{
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeShared<FHallidayRequestScheduler, ESPMode::ThreadSafe>();
+    Scheduler->SetMaxInFlight(MaxInFlight);
+    Scheduler->SetRequestFactory([&Server]() -> TSharedRef<IHttpRequest, ESPMode::ThreadSafe> { return Server.CreateRequest(); });
+    return Scheduler;
+}
+
+/**
+ * Tick the scheduler until a request is in flight, because a request held back by an empty token bucket is only sent from Tick().
+ * @returns False if nothing was sent within MaxSendWaitSeconds.
+ */
+static bool WaitForSend(FHallidayRequestScheduler& Scheduler, FHallidayFakeHttpServer& Server)
+{
+    const double StartSeconds = FPlatformTime::Seconds();
+    while (Server.InFlight.Num() == 0 && FPlatformTime::Seconds() - StartSeconds < MaxSendWaitSeconds)
+    {
+        FPlatformProcess::Sleep(0.005f);
+        Scheduler.Tick();
+    }
+    return Server.InFlight.Num() > 0;
+}
+
+/**
+ * Tick the scheduler for a while without answering anything, e.g. to check that a held back request stays held back.
+ */
+static void TickFor(FHallidayRequestScheduler& Scheduler, double Seconds)
+{
+    const double StartSeconds = FPlatformTime::Seconds();
+    while (FPlatformTime::Seconds() - StartSeconds < Seconds)
+    {
+        FPlatformProcess::Sleep(0.005f);
+        Scheduler.Tick();
+    }
+}
+
+/**
+ * Tick the scheduler until it has sent a number of hedges in total.
+ * @returns False if the hedges were not sent within MaxSendWaitSeconds.
+ */
+static bool WaitForHedges(FHallidayRequestScheduler& Scheduler, int64 NumHedged)
+{
+    const double StartSeconds = FPlatformTime::Seconds();
+    while (Scheduler.GetStats().NumHedged < NumHedged && FPlatformTime::Seconds() - StartSeconds < MaxSendWaitSeconds)
+    {
+        FPlatformProcess::Sleep(0.005f);
+        Scheduler.Tick();
+    }
+    return Scheduler.GetStats().NumHedged >= NumHedged;
+}
+
+/**
+ * Get the copies of a request that are in flight, i.e. the request and its hedge, in the order they were sent.
+ */
+static TArray<TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe>> GetInFlightCopies(const FHallidayFakeHttpServer& Server, const FString& URL)
+{
+    return Server.InFlight.FilterByPredicate([&URL](const TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe>& Request) { return Request->GetURL() == URL; });
+}
+
+/**
+ * Answer the requests one at a time with 200 until nothing is queued any more. Only use this with MaxInFlight set to 1.
+ */
+static void DrainOneByOne(FHallidayRequestScheduler& Scheduler, FHallidayFakeHttpServer& Server)
+{
+    while (Server.InFlight.Num() > 0)
+    {
+        Server.InFlight[0]->Respond(200);
+        if (Server.InFlight.Num() == 0 && Scheduler.GetStats().NumQueued > 0)
+        {
+            WaitForSend(Scheduler, Server);
+        }
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayRequestSchedulerPriorityTest, "Halliday.RequestScheduler.PriorityOrder", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Queue one request per class behind a request in flight and check that they are sent from the most to the least urgent class, whatever order they were enqueued in.
+ */
+bool FHallidayRequestSchedulerPriorityTest::RunTest(const FString& Parameters)
+{
+    FCompletionCounts Counts;
+    FHallidayFakeHttpServer Server;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeScheduler(Server);
+
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("warmup"), EHallidayRequestPriority::Warmup, FString());
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("assets"), EHallidayRequestPriority::Assets, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("balances"), EHallidayRequestPriority::Balances, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("transaction"), EHallidayRequestPriority::Transaction, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("wallet"), EHallidayRequestPriority::Wallet, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("status"), EHallidayRequestPriority::TransactionStatus, TEXT("A"));
+    TestEqual(TEXT("Only one request in flight"), Server.InFlight.Num(), 1);
+    TestEqual(TEXT("Queued"), Scheduler->GetStats().NumQueued, 5);
+
+    DrainOneByOne(*Scheduler, Server);
+
+    const TArray<FString> Expected = { TEXT("warmup"), TEXT("transaction"), TEXT("wallet"), TEXT("status"), TEXT("balances"), TEXT("assets") };
+    TestEqual(TEXT("Send order"), FString::Join(Server.SentUrls, TEXT(",")), FString::Join(Expected, TEXT(",")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayRequestSchedulerPlayerTurnsTest, "Halliday.RequestScheduler.PlayerTurns", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Queue bursts of different sizes for three players in one class and check that the players take turns instead of the first burst being sent first.
+ */
+bool FHallidayRequestSchedulerPlayerTurnsTest::RunTest(const FString& Parameters)
+{
+    FCompletionCounts Counts;
+    FHallidayFakeHttpServer Server;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeScheduler(Server);
+
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("Z1"), EHallidayRequestPriority::Assets, TEXT("Z"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("A1"), EHallidayRequestPriority::Assets, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("A2"), EHallidayRequestPriority::Assets, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("A3"), EHallidayRequestPriority::Assets, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("B1"), EHallidayRequestPriority::Assets, TEXT("B"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("C1"), EHallidayRequestPriority::Assets, TEXT("C"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("C2"), EHallidayRequestPriority::Assets, TEXT("C"));
+
+    DrainOneByOne(*Scheduler, Server);
+
+    const TArray<FString> Expected = { TEXT("Z1"), TEXT("A1"), TEXT("B1"), TEXT("C1"), TEXT("A2"), TEXT("C2"), TEXT("A3") };
+    TestEqual(TEXT("Send order"), FString::Join(Server.SentUrls, TEXT(",")), FString::Join(Expected, TEXT(",")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayRequestSchedulerCancelKeepsTurnTest, "Halliday.RequestScheduler.CancelKeepsTurn", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Cancel the last queued request of a player whose turn already passed and check that the player whose turn is next keeps it.
+ * RemoveLocked() removes the emptied player from the turn order, which shifts every later player down by one.
+ */
+bool FHallidayRequestSchedulerCancelKeepsTurnTest::RunTest(const FString& Parameters)
+{
+    FCompletionCounts Counts;
+    FHallidayFakeHttpServer Server;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeScheduler(Server);
+    TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> Operation = MakeShared<FHallidayOperation, ESPMode::ThreadSafe>(1);
+
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("Z1"), EHallidayRequestPriority::Assets, TEXT("Z"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("A1"), EHallidayRequestPriority::Assets, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("A2"), EHallidayRequestPriority::Assets, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("B1"), EHallidayRequestPriority::Assets, TEXT("B"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("B2"), EHallidayRequestPriority::Assets, TEXT("B"), Operation);
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("C1"), EHallidayRequestPriority::Assets, TEXT("C"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("C2"), EHallidayRequestPriority::Assets, TEXT("C"));
+
+    // Send Z1, A1 and B1, so that it is C's turn next.
+    for (const TCHAR* URL : { TEXT("Z1"), TEXT("A1") })
+    {
+        if (!TestTrue(FString::Printf(TEXT("%s in flight"), URL), Server.FindInFlight(URL).IsValid()))
+        {
+            return false;
+        }
+        Server.FindInFlight(URL)->Respond(200);
+        WaitForSend(*Scheduler, Server);
+    }
+    if (!TestTrue(TEXT("B1 in flight"), Server.FindInFlight(TEXT("B1")).IsValid()))
+    {
+        return false;
+    }
+
+    Scheduler->Cancel(*Operation);
+    TestEqual(TEXT("B2 completed when cancelled"), Counts[TEXT("B2")], 1);
+
+    DrainOneByOne(*Scheduler, Server);
+
+    const TArray<FString> Expected = { TEXT("Z1"), TEXT("A1"), TEXT("B1"), TEXT("C1"), TEXT("A2"), TEXT("C2") };
+    TestEqual(TEXT("Send order"), FString::Join(Server.SentUrls, TEXT(",")), FString::Join(Expected, TEXT(",")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayRequestSchedulerCompletesOnceTest, "Halliday.RequestScheduler.CompletesOnce", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Complete requests in every way the scheduler knows and check that each one executes its caller's delegate exactly once and gives its slot back.
+ */
+bool FHallidayRequestSchedulerCompletesOnceTest::RunTest(const FString& Parameters)
+{
+    FCompletionCounts Counts;
+    FHallidayFakeHttpServer Server;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeScheduler(Server);
+    TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> QueuedOperation = MakeShared<FHallidayOperation, ESPMode::ThreadSafe>(1);
+    TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> InFlightOperation = MakeShared<FHallidayOperation, ESPMode::ThreadSafe>(2);
+    TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> CancelledOperation = MakeShared<FHallidayOperation, ESPMode::ThreadSafe>(3);
+
+    // Answered.
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("answered"), EHallidayRequestPriority::Transaction, TEXT("A"));
+
+    // Cancelled while queued behind the answered request.
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("cancelled while queued"), EHallidayRequestPriority::Wallet, TEXT("A"), QueuedOperation);
+    Scheduler->Cancel(*QueuedOperation);
+    Server.FindInFlight(TEXT("answered"))->Respond(200);
+
+    // Cancelled in flight.
+    TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> InFlight = EnqueueRequest(*Scheduler, Server, Counts, TEXT("cancelled in flight"), EHallidayRequestPriority::TransactionStatus, TEXT("A"), InFlightOperation);
+    TestTrue(TEXT("Sent before it was cancelled"), InFlight->IsInFlight());
+    Scheduler->Cancel(*InFlightOperation);
+    TestTrue(TEXT("Request in flight cancelled"), InFlight->WasCancelled());
+
+    // Enqueued for an operation that was already cancelled.
+    Scheduler->Cancel(*CancelledOperation);
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("enqueued after cancel"), EHallidayRequestPriority::Balances, TEXT("A"), CancelledOperation);
+
+    // Completed inside ProcessRequest() because it could not be started.
+    TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> FailToStart = CreateCountedRequest(Server, Counts, TEXT("failed to start"));
+    FailToStart->bFailToStart = true;
+    Scheduler->Enqueue(FailToStart, EHallidayRequestPriority::Assets, TEXT("A"), nullptr);
+
+    // Failed without a response, e.g. because the connection dropped.
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("connection error"), EHallidayRequestPriority::Warmup, FString());
+    if (TestTrue(TEXT("Connection error sent"), Server.FindInFlight(TEXT("connection error")).IsValid()))
+    {
+        Server.FindInFlight(TEXT("connection error"))->Fail();
+    }
+
+    // Cancelled by CancelAll() in flight and while queued.
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("CancelAll in flight"), EHallidayRequestPriority::Transaction, TEXT("B"));
+    WaitForSend(*Scheduler, Server);
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("CancelAll queued"), EHallidayRequestPriority::Transaction, TEXT("B"));
+    Scheduler->CancelAll();
+
+    for (const TPair<FString, int32>& Count : Counts)
+    {
+        TestEqual(FString::Printf(TEXT("'%s' completions"), *Count.Key), Count.Value, 1);
+    }
+    for (const TCHAR* URL : { TEXT("cancelled while queued"), TEXT("enqueued after cancel"), TEXT("CancelAll queued") })
+    {
+        TestFalse(FString::Printf(TEXT("'%s' never sent"), URL), Server.SentUrls.Contains(URL));
+    }
+
+    const FHallidayRequestSchedulerStats Stats = Scheduler->GetStats();
+    TestEqual(TEXT("Nothing in flight"), Stats.NumInFlight, 0);
+    TestEqual(TEXT("Nothing queued"), Stats.NumQueued, 0);
+    TestEqual(TEXT("No fake request in flight"), Server.InFlight.Num(), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayRequestSchedulerBackoffTest, "Halliday.RequestScheduler.BackoffOncePerRound", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Throttle a full round of requests and check that the class backs off once for the round instead of once per response, and that its concurrency limit was halved.
+ */
+bool FHallidayRequestSchedulerBackoffTest::RunTest(const FString& Parameters)
+{
+    FCompletionCounts Counts;
+    FHallidayFakeHttpServer Server;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeScheduler(Server, 4);
+
+    // The requests are not requeued, so that only the limiter is tested.
+    for (int32 i = 1; i <= 8; ++i)
+    {
+        Scheduler->Enqueue(CreateCountedRequest(Server, Counts, FString::Printf(TEXT("R%d"), i)), EHallidayRequestPriority::Assets, TEXT("A"), nullptr, false, false);
+    }
+    TestEqual(TEXT("First round in flight"), Server.InFlight.Num(), 4);
+
+    while (Server.InFlight.Num() > 0)
+    {
+        Server.InFlight[0]->Respond(503);
+    }
+    TestEqual(TEXT("Backoffs after the first round"), Scheduler->GetStats().NumBackoffs, (int64)1);
+
+    // The bucket was emptied and refills at half the rate. Once it has, only half of the former limit of 4 is in flight.
+    const double StartSeconds = FPlatformTime::Seconds();
+    while (Server.InFlight.Num() < 2 && FPlatformTime::Seconds() - StartSeconds < MaxSendWaitSeconds)
+    {
+        FPlatformProcess::Sleep(0.005f);
+        Scheduler->Tick();
+    }
+    TickFor(*Scheduler, 0.3);
+    TestEqual(TEXT("Second round in flight after halving the limit"), Server.InFlight.Num(), 2);
+
+    // The second round was sent after the first backoff, so it backs off once more.
+    while (Server.InFlight.Num() > 0)
+    {
+        Server.InFlight[0]->Respond(429);
+    }
+    TestEqual(TEXT("Backoffs after the second round"), Scheduler->GetStats().NumBackoffs, (int64)2);
+
+    WaitForSend(*Scheduler, Server);
+    DrainOneByOne(*Scheduler, Server);
+    for (const TPair<FString, int32>& Count : Counts)
+    {
+        TestEqual(FString::Printf(TEXT("'%s' completions"), *Count.Key), Count.Value, 1);
+    }
+    TestEqual(TEXT("Nothing requeued"), Scheduler->GetStats().NumRequeued, (int64)0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayRequestSchedulerRetryAfterTest, "Halliday.RequestScheduler.RetryAfter", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Throttle a request with a Retry-After header and check that its class sends nothing until the pause is over while other classes go on.
+ */
+bool FHallidayRequestSchedulerRetryAfterTest::RunTest(const FString& Parameters)
+{
+    FCompletionCounts Counts;
+    FHallidayFakeHttpServer Server;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeScheduler(Server, 2);
+
+    Scheduler->Enqueue(CreateCountedRequest(Server, Counts, TEXT("throttled")), EHallidayRequestPriority::Balances, TEXT("A"), nullptr, false, false);
+    Server.FindInFlight(TEXT("throttled"))->Respond(429, { { TEXT("Retry-After"), TEXT("1") } });
+    const double PauseStartSeconds = FPlatformTime::Seconds();
+
+    Scheduler->Enqueue(CreateCountedRequest(Server, Counts, TEXT("paused")), EHallidayRequestPriority::Balances, TEXT("A"), nullptr, false, false);
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("other class"), EHallidayRequestPriority::Assets, TEXT("A"));
+    TestTrue(TEXT("Other class sent during the pause"), Server.FindInFlight(TEXT("other class")).IsValid());
+
+    // By now the bucket has refilled, so only the pause holds the request back.
+    TickFor(*Scheduler, 0.5);
+    TestFalse(TEXT("Paused class held back"), Server.SentUrls.Contains(TEXT("paused")));
+
+    Server.FindInFlight(TEXT("other class"))->Respond(200);
+    TestTrue(TEXT("Paused class sent after the pause"), WaitForSend(*Scheduler, Server) && Server.FindInFlight(TEXT("paused")).IsValid());
+    TestTrue(TEXT("Pause lasted for Retry-After"), FPlatformTime::Seconds() - PauseStartSeconds >= 0.95);
+
+    DrainOneByOne(*Scheduler, Server);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayRequestSchedulerRequeueTest, "Halliday.RequestScheduler.Requeue", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Throttle requests and check that a retryable one is sent again ahead of the requests queued behind it, up to the attempt limit, while the rest complete with the throttled response.
+ */
+bool FHallidayRequestSchedulerRequeueTest::RunTest(const FString& Parameters)
+{
+    FCompletionCounts Counts;
+    FHallidayFakeHttpServer Server;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeScheduler(Server);
+
+    // A throttled request is sent again before the requests of its player that were queued behind it.
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("G1"), EHallidayRequestPriority::Assets, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("G2"), EHallidayRequestPriority::Assets, TEXT("A"));
+    EnqueueRequest(*Scheduler, Server, Counts, TEXT("G3"), EHallidayRequestPriority::Assets, TEXT("A"));
+    Server.FindInFlight(TEXT("G1"))->Respond(503);
+    TestEqual(TEXT("Requeued request not completed"), Counts[TEXT("G1")], 0);
+    TestEqual(TEXT("Requeued"), Scheduler->GetStats().NumRequeued, (int64)1);
+
+    WaitForSend(*Scheduler, Server);
+    DrainOneByOne(*Scheduler, Server);
+    const TArray<FString> Expected = { TEXT("G1"), TEXT("G1"), TEXT("G2"), TEXT("G3") };
+    TestEqual(TEXT("Send order"), FString::Join(Server.SentUrls, TEXT(",")), FString::Join(Expected, TEXT(",")));
+
+    // Requests with side effects are only requeued on 429 and 503, which mean that the backend did not process them.
+    Scheduler->Enqueue(CreateCountedRequest(Server, Counts, TEXT("POST 429"), TEXT("POST")), EHallidayRequestPriority::Transaction, TEXT("A"), nullptr);
+    Server.FindInFlight(TEXT("POST 429"))->Respond(429);
+    TestEqual(TEXT("POST requeued on 429"), Counts[TEXT("POST 429")], 0);
+    WaitForSend(*Scheduler, Server);
+    Server.FindInFlight(TEXT("POST 429"))->Respond(200);
+
+    Scheduler->Enqueue(CreateCountedRequest(Server, Counts, TEXT("POST 500"), TEXT("POST")), EHallidayRequestPriority::Wallet, TEXT("A"), nullptr);
+    Server.FindInFlight(TEXT("POST 500"))->Respond(500);
+    TestEqual(TEXT("POST completed on 500"), Counts[TEXT("POST 500")], 1);
+
+    // A caller that retries by itself gets the throttled response right away.
+    Scheduler->Enqueue(CreateCountedRequest(Server, Counts, TEXT("caller retries")), EHallidayRequestPriority::TransactionStatus, TEXT("A"), nullptr, false, false);
+    Server.FindInFlight(TEXT("caller retries"))->Respond(503);
+    TestEqual(TEXT("Not requeued when the caller retries"), Counts[TEXT("caller retries")], 1);
+
+    // After the last attempt the throttled response is passed on. The scheduler sends a request at most 4 times.
+    Scheduler->Enqueue(CreateCountedRequest(Server, Counts, TEXT("always throttled")), EHallidayRequestPriority::Balances, TEXT("A"), nullptr);
+    for (int32 Attempt = 1; Attempt <= 4 && WaitForSend(*Scheduler, Server); ++Attempt)
+    {
+        Server.FindInFlight(TEXT("always throttled"))->Respond(503);
+    }
+    TestEqual(TEXT("Attempts"), Server.SentUrls.FilterByPredicate([](const FString& URL) { return URL == TEXT("always throttled"); }).Num(), 4);
+    TestEqual(TEXT("Completed after the last attempt"), Counts[TEXT("always throttled")], 1);
+
+    for (const TPair<FString, int32>& Count : Counts)
+    {
+        TestEqual(FString::Printf(TEXT("'%s' completions"), *Count.Key), Count.Value, 1);
+    }
+    TestEqual(TEXT("Nothing in flight"), Scheduler->GetStats().NumInFlight, 0);
+    return true;
+}
+
+/** Seconds a hedgeable request is in flight before the hedging tests hedge it. */
+static constexpr double TestHedgeDelaySeconds = 0.05;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayRequestSchedulerHedgeBudgetTest, "Halliday.RequestScheduler.HedgeBudget", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Let hedgeable requests become slow and check that hedges are only sent as far as the budget earned by sending them allows.
+ */
+bool FHallidayRequestSchedulerHedgeBudgetTest::RunTest(const FString& Parameters)
+{
+    FCompletionCounts Counts;
+    FHallidayFakeHttpServer Server;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeScheduler(Server, 6);
+    Scheduler->SetHedging(true, TestHedgeDelaySeconds, 0.5);
+
+    // One request earns half a hedge, which is not enough to send one.
+    Scheduler->Enqueue(CreateCountedRequest(Server, Counts, TEXT("H1")), EHallidayRequestPriority::Assets, TEXT("A"), nullptr, true);
+    TickFor(*Scheduler, TestHedgeDelaySeconds * 3);
+    TestEqual(TEXT("Hedges within half a hedge of budget"), Scheduler->GetStats().NumHedged, (int64)0);
+
+    // Two requests earn one hedge, which goes to the request that is due. The other request stays unhedged once it is due as well.
+    Scheduler->Enqueue(CreateCountedRequest(Server, Counts, TEXT("H2")), EHallidayRequestPriority::Assets, TEXT("A"), nullptr, true);
+    TickFor(*Scheduler, TestHedgeDelaySeconds * 3);
+    TestEqual(TEXT("Hedges within one hedge of budget"), Scheduler->GetStats().NumHedged, (int64)1);
+    TestEqual(TEXT("H1 hedged"), GetInFlightCopies(Server, TEXT("H1")).Num(), 2);
+    TestEqual(TEXT("H2 not hedged"), GetInFlightCopies(Server, TEXT("H2")).Num(), 1);
+
+    while (Server.InFlight.Num() > 0)
+    {
+        Server.InFlight[0]->Respond(200);
+    }
+    for (const TPair<FString, int32>& Count : Counts)
+    {
+        TestEqual(FString::Printf(TEXT("'%s' completions"), *Count.Key), Count.Value, 1);
+    }
+
+    // A whole hedge per request sent saves up at most three hedges, however many requests become slow at once.
+    FHallidayFakeHttpServer BurstServer;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> BurstScheduler = MakeScheduler(BurstServer, 10);
+    BurstScheduler->SetHedging(true, TestHedgeDelaySeconds, 1.0);
+    for (int32 i = 0; i < 5; ++i)
+    {
+        BurstScheduler->Enqueue(CreateCountedRequest(BurstServer, Counts, FString::Printf(TEXT("burst %d"), i)), EHallidayRequestPriority::Assets, TEXT("A"), nullptr, true);
+    }
+    TickFor(*BurstScheduler, TestHedgeDelaySeconds * 3);
+    TestEqual(TEXT("Hedges of a burst"), BurstScheduler->GetStats().NumHedged, (int64)3);
+    TestEqual(TEXT("Requests of a burst in flight"), BurstServer.InFlight.Num(), 5 + 3);
+
+    while (BurstServer.InFlight.Num() > 0)
+    {
+        BurstServer.InFlight[0]->Respond(200);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayRequestSchedulerHedgeLoserTest, "Halliday.RequestScheduler.HedgeLoserCancelled", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Answer either the hedge or the request it was sent for and check that the other one is cancelled and the caller hears back once.
+ */
+bool FHallidayRequestSchedulerHedgeLoserTest::RunTest(const FString& Parameters)
+{
+    FCompletionCounts Counts;
+    FHallidayFakeHttpServer Server;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeScheduler(Server, 6);
+    Scheduler->SetHedging(true, TestHedgeDelaySeconds, 1.0);
+
+    struct FWinnerCase
+    {
+        const TCHAR* URL;
+        bool bHedgeWins;
+    };
+    int64 NumHedged = 0;
+    for (const FWinnerCase& Case : { FWinnerCase{ TEXT("hedge wins"), true }, FWinnerCase{ TEXT("request wins"), false } })
+    {
+        Scheduler->Enqueue(CreateCountedRequest(Server, Counts, Case.URL), EHallidayRequestPriority::Assets, TEXT("A"), nullptr, true);
+        if (!TestTrue(FString::Printf(TEXT("'%s' hedged"), Case.URL), WaitForHedges(*Scheduler, ++NumHedged)))
+        {
+            return false;
+        }
+
+        TArray<TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe>> Copies = GetInFlightCopies(Server, Case.URL);
+        if (!TestEqual(FString::Printf(TEXT("'%s' copies in flight"), Case.URL), Copies.Num(), 2))
+        {
+            return false;
+        }
+        TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> Winner = Copies[Case.bHedgeWins ? 1 : 0];
+        TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe> Loser = Copies[Case.bHedgeWins ? 0 : 1];
+
+        Winner->Respond(200);
+        TestTrue(FString::Printf(TEXT("'%s' loser cancelled"), Case.URL), Loser->WasCancelled());
+        TestEqual(FString::Printf(TEXT("'%s' completions"), Case.URL), Counts[Case.URL], 1);
+
+        // A response that arrives after all is dropped.
+        Loser->Respond(200);
+        TestEqual(FString::Printf(TEXT("'%s' completions after the loser answered"), Case.URL), Counts[Case.URL], 1);
+    }
+
+    const FHallidayRequestSchedulerStats Stats = Scheduler->GetStats();
+    TestEqual(TEXT("Hedge wins"), Stats.NumHedgeWins, (int64)1);
+    TestEqual(TEXT("Nothing in flight"), Stats.NumInFlight, 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayRequestSchedulerHedgeFailureTest, "Halliday.RequestScheduler.HedgeFailureDropped", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Fail one copy of a hedged request and check that the failure is dropped while the other copy may still answer, and only passed on once both failed.
+ */
+bool FHallidayRequestSchedulerHedgeFailureTest::RunTest(const FString& Parameters)
+{
+    FCompletionCounts Counts;
+    FHallidayFakeHttpServer Server;
+    TSharedRef<FHallidayRequestScheduler, ESPMode::ThreadSafe> Scheduler = MakeScheduler(Server, 6);
+    Scheduler->SetHedging(true, TestHedgeDelaySeconds, 1.0);
+
+    struct FFailureCase
+    {
+        const TCHAR* URL;
+
+        /** Status code the first copy fails with, or 0 for a connection error. */
+        int32 FirstResponseCode;
+
+        /** Whether the second copy answers with 200 or fails as well. */
+        bool bSecondSucceeds;
+    };
+    int64 NumHedged = 0;
+    for (const FFailureCase& Case : { FFailureCase{ TEXT("connection error, then 200"), 0, true }, FFailureCase{ TEXT("503, then 200"), 503, true }, FFailureCase{ TEXT("both fail"), 0, false } })
+    {
+        Scheduler->Enqueue(CreateCountedRequest(Server, Counts, Case.URL), EHallidayRequestPriority::Assets, TEXT("A"), nullptr, true);
+        if (!TestTrue(FString::Printf(TEXT("'%s' hedged"), Case.URL), WaitForHedges(*Scheduler, ++NumHedged)))
+        {
+            return false;
+        }
+
+        TArray<TSharedRef<FHallidayFakeHttpRequest, ESPMode::ThreadSafe>> Copies = GetInFlightCopies(Server, Case.URL);
+        if (!TestEqual(FString::Printf(TEXT("'%s' copies in flight"), Case.URL), Copies.Num(), 2))
+        {
+            return false;
+        }
+
+        const FHallidayRequestSchedulerStats StatsBefore = Scheduler->GetStats();
+        if (Case.FirstResponseCode == 0)
+        {
+            Copies[0]->Fail();
+        }
+        else
+        {
+            Copies[0]->Respond(Case.FirstResponseCode);
+        }
+        TestEqual(FString::Printf(TEXT("'%s' failure dropped"), Case.URL), Counts[Case.URL], 0);
+        TestFalse(FString::Printf(TEXT("'%s' other copy kept"), Case.URL), Copies[1]->WasCancelled());
+        TestEqual(FString::Printf(TEXT("'%s' not requeued"), Case.URL), Scheduler->GetStats().NumRequeued, StatsBefore.NumRequeued);
+
+        if (Case.bSecondSucceeds)
+        {
+            Copies[1]->Respond(200);
+        }
+        else
+        {
+            Copies[1]->Fail();
+        }
+        TestEqual(FString::Printf(TEXT("'%s' completions"), Case.URL), Counts[Case.URL], 1);
+    }
+
+    TestEqual(TEXT("Nothing in flight"), Scheduler->GetStats().NumInFlight, 0);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,176 @@
+#include "Halliday.h"
+#include "HallidayHex.h"
+#include "HallidayKeccak.h"
+#include "HallidaySigner.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "secp256k1_recovery.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Number of bot keys the benchmark signs for. */
+static constexpr int32 NumBenchmarkKeys = 16;
+
+/** Number of hashes in every benchmarked batch. */
+static constexpr int32 NumBenchmarkHashes = 4096;
+
+/** Number of times every worker count is measured. The fastest run is reported. */
+static constexpr int32 NumBenchmarkRuns = 3;
+
+/** Number of hashes signed one at a time when comparing the pooled context with a context per call. */
+static constexpr int32 NumBenchmarkSingleSignatures = 2048;
+
+/**
+ * Make a deterministic private key for the benchmark.
+ * @param Index Index of the key. The key is Index + 1, so it is always a valid secp256k1 private key.
+ * @returns The key as a 64 character hex string.
+ */
+static FString MakeBenchmarkKey(int32 Index)
+{
+    return FString::Printf(TEXT("%064x"), Index + 1);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidaySignBatchScalingTest, "Halliday.Signer.SignBatchScaling", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Sign the same batch with MaxBatchSigningWorkers set from 1 to N, where N is every task graph worker plus the calling thread.
+ * Every worker count must produce the same signatures as one worker, and the time and speedup of each count are logged.
+ */
+bool FHallidaySignBatchScalingTest::RunTest(const FString& Parameters)
+{
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+    AHalliday* Halliday = World->SpawnActor<AHalliday>();
+
+    TArray<int32> KeyHandles;
+    for (int32 i = 0; i < NumBenchmarkKeys; ++i)
+    {
+        KeyHandles.Add(Halliday->AddSigningKey(MakeBenchmarkKey(i)));
+        TestNotEqual(TEXT("Key handle"), KeyHandles.Last(), (int32)INDEX_NONE);
+    }
+
+    TArray<FHallidaySignRequest> Requests;
+    Requests.SetNum(NumBenchmarkHashes);
+    for (int32 i = 0; i < NumBenchmarkHashes; ++i)
+    {
+        Requests[i].KeyHandle = KeyHandles[i % NumBenchmarkKeys];
+        FHallidayKeccak256::Hash((const uint8*)&i, sizeof(i), Requests[i].Hash.Bytes);
+    }
+
+    // Nonces are deterministic, so every worker count must match the single worker.
+    TArray<uint8> ExpectedSignatures;
+    Halliday->MaxBatchSigningWorkers = 1;
+    TestTrue(TEXT("Batch signed with 1 worker"), Halliday->SignBatch(Requests, ExpectedSignatures));
+
+    const int32 MaxWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    double SingleWorkerSeconds = 0.0;
+    TArray<uint8> Signatures;
+    for (int32 NumWorkers = 1; NumWorkers <= MaxWorkers && !HasAnyErrors(); ++NumWorkers)
+    {
+        Halliday->MaxBatchSigningWorkers = NumWorkers;
+
+        double BestSeconds = TNumericLimits<double>::Max();
+        for (int32 Run = 0; Run < NumBenchmarkRuns; ++Run)
+        {
+            const double StartSeconds = FPlatformTime::Seconds();
+            const bool bSigned = Halliday->SignBatch(Requests, Signatures);
+            BestSeconds = FMath::Min(BestSeconds, FPlatformTime::Seconds() - StartSeconds);
+
+            TestTrue(FString::Printf(TEXT("Batch signed with %d workers"), NumWorkers), bSigned);
+            TestTrue(FString::Printf(TEXT("Signatures with %d workers match 1 worker"), NumWorkers), Signatures == ExpectedSignatures);
+        }
+
+        if (NumWorkers == 1)
+        {
+            SingleWorkerSeconds = BestSeconds;
+        }
+        AddInfo(FString::Printf(TEXT("%2d workers: %8.2f ms, %9.0f signatures/s, %5.2fx"),
+            NumWorkers, BestSeconds * 1000.0, NumBenchmarkHashes / BestSeconds, SingleWorkerSeconds / BestSeconds));
+    }
+
+    for (const int32 KeyHandle : KeyHandles)
+    {
+        Halliday->RemoveSigningKey(KeyHandle);
+    }
+    World->DestroyWorld(false);
+    return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidaySignContextPoolTest, "Halliday.Signer.ContextPool", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Compare signing one hash at a time with a leased context from the pool against creating, randomizing and destroying a context for every signature, as the SDK used to.
+ * Nonces are deterministic, so both must produce the same signatures. The signatures per second of each and the speedup are logged.
+ */
+bool FHallidaySignContextPoolTest::RunTest(const FString& Parameters)
+{
+    const FString KeyHex = MakeBenchmarkKey(0);
+    uint8 SecretKey[32];
+    FHallidaySigner Signer;
+    if (!TestTrue(TEXT("Context pool created"), Signer.CreateContextPool()) ||
+        !TestTrue(TEXT("Player key loaded"), Signer.LoadPlayerKey(KeyHex)) ||
+        !TestTrue(TEXT("Key decoded"), FHallidayHex::Decode(KeyHex, SecretKey, sizeof(SecretKey))))
+    {
+        return false;
+    }
+
+    TArray<FHallidayHash32> Hashes;
+    Hashes.SetNum(NumBenchmarkSingleSignatures);
+    for (int32 i = 0; i < NumBenchmarkSingleSignatures; ++i)
+    {
+        FHallidayKeccak256::Hash((const uint8*)&i, sizeof(i), Hashes[i].Bytes);
+    }
+
+    // Pooled: every call leases a context that was randomized once and is re-randomized on the configured schedule.
+    TArray<uint8> PooledSignatures;
+    PooledSignatures.SetNumZeroed(NumBenchmarkSingleSignatures * HALLIDAY_SIGNATURE_SIZE);
+    double PooledSeconds = TNumericLimits<double>::Max();
+    for (int32 Run = 0; Run < NumBenchmarkRuns; ++Run)
+    {
+        const double StartSeconds = FPlatformTime::Seconds();
+        for (int32 i = 0; i < NumBenchmarkSingleSignatures; ++i)
+        {
+            FHallidaySignature Signature;
+            Signer.SignHash(Hashes[i], false, Signature);
+            FMemory::Memcpy(&PooledSignatures[i * HALLIDAY_SIGNATURE_SIZE], Signature.Bytes, HALLIDAY_SIGNATURE_SIZE);
+        }
+        PooledSeconds = FMath::Min(PooledSeconds, FPlatformTime::Seconds() - StartSeconds);
+    }
+
+    // Per call: create a context, randomize it, sign and destroy it again for every hash.
+    TArray<uint8> PerCallSignatures;
+    PerCallSignatures.SetNumZeroed(NumBenchmarkSingleSignatures * HALLIDAY_SIGNATURE_SIZE);
+    double PerCallSeconds = TNumericLimits<double>::Max();
+    for (int32 Run = 0; Run < NumBenchmarkRuns; ++Run)
+    {
+        const double StartSeconds = FPlatformTime::Seconds();
+        for (int32 i = 0; i < NumBenchmarkSingleSignatures; ++i)
+        {
+            secp256k1_context* Ctx = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+
+            // The seed only needs to differ per call to cost the same as fresh entropy from the operating system.
+            uint8 Seed[32];
+            FHallidayKeccak256::Hash(Hashes[i].Bytes, FHallidayHash32::Size, Seed);
+            secp256k1_context_randomize(Ctx, Seed);
+
+            secp256k1_ecdsa_recoverable_signature Signature;
+            uint8* OutSignature = &PerCallSignatures[i * HALLIDAY_SIGNATURE_SIZE];
+            int RecoveryId = 0;
+            secp256k1_ecdsa_sign_recoverable(Ctx, &Signature, Hashes[i].Bytes, SecretKey, NULL, NULL);
+            secp256k1_ecdsa_recoverable_signature_serialize_compact(Ctx, OutSignature, &RecoveryId, &Signature);
+            OutSignature[64] = (uint8)(27 + RecoveryId);
+
+            secp256k1_context_destroy(Ctx);
+        }
+        PerCallSeconds = FMath::Min(PerCallSeconds, FPlatformTime::Seconds() - StartSeconds);
+    }
+    FMemory::Memzero(SecretKey, sizeof(SecretKey));
+
+    TestTrue(TEXT("Pooled and per call signatures match"), PooledSignatures == PerCallSignatures);
+    AddInfo(FString::Printf(TEXT("Context per call: %9.0f signatures/s"), NumBenchmarkSingleSignatures / PerCallSeconds));
+    AddInfo(FString::Printf(TEXT("Pooled context:   %9.0f signatures/s, %5.2fx"), NumBenchmarkSingleSignatures / PooledSeconds, PerCallSeconds / PooledSeconds));
+
+    Signer.Reset();
+    return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,108 @@
+#include "HallidayUserOperation.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Address of the v0.6 EntryPoint contract. */
+static const TCHAR* EntryPointV06Address = TEXT("0x5FF137D4b0FDCD49DcA30c7CF57E578a026d2789");
+
+/** transfer(address,uint256) of 1e18 base units to 0xd8dA6BF26964aF9D7eEd9e03E53415D37aA96045. */
+static const TCHAR* Erc20TransferCalldata =
+    TEXT("0xa9059cbb")
+    TEXT("000000000000000000000000d8da6bf26964af9d7eed9e03e53415d37aa96045")
+    TEXT("0000000000000000000000000000000000000000000000000de0b6b3a7640000");
+
+/** createAccount(address,uint256) on a factory for owner 0xd8dA6BF26964aF9D7eEd9e03E53415D37aA96045 with salt 0. */
+static const TCHAR* FactoryInitCode =
+    TEXT("0x9406cc6185a346906296840746125a0e44976454")
+    TEXT("5fbfb9cf")
+    TEXT("000000000000000000000000d8da6bf26964af9d7eed9e03e53415d37aa96045")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000000");
+
+/** A paymaster address followed by 32 bytes of paymaster data. */
+static const TCHAR* PaymasterAndData =
+    TEXT("0xe93eca6595fe94091dc1af46aac2a8b5d7990770")
+    TEXT("0000000000000000000000000000000000000000000000000000000000000000");
+
+/**
+ * Build a UserOperation from an already deployed account that pays its own gas.
+ */
+static FAATransaction MakeTransaction()
+{
+    FAATransaction Transaction;
+    FHallidayAddress::FromString(TEXT("0xb856dbd4fa1a79a46d426f537455e7d3e79ab7c4"), Transaction.sender);
+    Transaction.nonce.hex = TEXT("0x1");
+    Transaction.initCode = TEXT("0x");
+    Transaction.callData = Erc20TransferCalldata;
+    Transaction.callGasLimit.hex = TEXT("0x186a0");
+    Transaction.verificationGasLimit.hex = TEXT("0x30d40");
+    Transaction.preVerificationGas.hex = TEXT("0xc350");
+    Transaction.maxFeePerGas.hex = TEXT("0x59682f00");
+    Transaction.maxPriorityFeePerGas.hex = TEXT("0x3b9aca00");
+    Transaction.paymasterAndData = TEXT("0x");
+    return Transaction;
+}
+
+/**
+ * Hash a transaction and compare the hash with the expected one.
+ * @param Test Test that reports the result.
+ * @param What Name of the vector.
+ * @param Transaction UserOperation to hash.
+ * @param ChainId Chain id to hash it for.
+ * @param ExpectedHash Expected hash with "0x" as the prefix.
+ */
+static void TestUserOperationHash(FAutomationTestBase& Test, const TCHAR* What, const FAATransaction& Transaction, uint64 ChainId, const TCHAR* ExpectedHash)
+{
+    FHallidayAddress EntryPoint;
+    FHallidayAddress::FromString(EntryPointV06Address, EntryPoint);
+
+    FHallidayHash32 Hash;
+    if (Test.TestTrue(FString::Printf(TEXT("%s hashed"), What), FHallidayUserOperation::ComputeHash(Transaction, EntryPoint, ChainId, Hash)))
+    {
+        Test.TestEqual(What, Hash.ToString(), FString(ExpectedHash));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHallidayUserOperationHashTest, "Halliday.UserOperation.Hash", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * Hash UserOperations for the v0.6 EntryPoint the way EntryPoint.getUserOpHash() does.
+ * The expected hashes were generated with an independent reference implementation of Keccak-256 and the v0.6 packing.
+ */
+bool FHallidayUserOperationHashTest::RunTest(const FString& Parameters)
+{
+    // Empty initCode and paymasterAndData, so both hash to keccak256("").
+    FAATransaction Transaction = MakeTransaction();
+    TestUserOperationHash(*this, TEXT("Deployed account on Polygon"), Transaction, 137, TEXT("0xbbd3cdbe6fb608dd1030afa3510a74e2476aab500b6544ce10c73eb5de9e72cb"));
+
+    // Non-empty dynamic fields and an odd number of nonce nibbles.
+    Transaction.nonce.hex = TEXT("0x1f");
+    Transaction.initCode = FactoryInitCode;
+    Transaction.paymasterAndData = PaymasterAndData;
+    TestUserOperationHash(*this, TEXT("Counterfactual account with a paymaster on Base"), Transaction, 8453, TEXT("0x73002031e72b1e299734ad3e898401d58921ce8e74e75cf9835d7ba24b87e122"));
+
+    // The chain id is part of the hash, so the same UserOperation must hash differently on another chain.
+    FHallidayAddress EntryPoint;
+    FHallidayAddress::FromString(EntryPointV06Address, EntryPoint);
+    FHallidayHash32 BaseHash;
+    FHallidayHash32 OptimismHash;
+    FHallidayUserOperation::ComputeHash(Transaction, EntryPoint, 8453, BaseHash);
+    FHallidayUserOperation::ComputeHash(Transaction, EntryPoint, 10, OptimismHash);
+    TestTrue(TEXT("Chain id changes the hash"), BaseHash != OptimismHash);
+
+    // Malformed fields are rejected instead of being hashed as zero.
+    FHallidayHash32 Hash;
+    FAATransaction Malformed = MakeTransaction();
+    Malformed.callData = TEXT("0xa9059cb");
+    TestFalse(TEXT("Odd length callData"), FHallidayUserOperation::ComputeHash(Malformed, EntryPoint, 137, Hash));
+    Malformed = MakeTransaction();
+    Malformed.maxFeePerGas.hex = TEXT("0x59682g00");
+    TestFalse(TEXT("Non-hex maxFeePerGas"), FHallidayUserOperation::ComputeHash(Malformed, EntryPoint, 137, Hash));
+    Malformed = MakeTransaction();
+    Malformed.nonce.hex = TEXT("0x1") + FString::ChrN(64, '0');
+    TestFalse(TEXT("Nonce wider than 32 bytes"), FHallidayUserOperation::ComputeHash(Malformed, EntryPoint, 137, Hash));
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -5,9 +5,29 @@
 #include "Http.h"
 #include "GameFramework/Actor.h"
 #include "HallidayTypes.h"
+#include "HallidayEip712.h"
+#include "HallidayAbi.h"
+#include "HallidayWalletCache.h"
+#include "HallidayResponseCache.h"
+#include <atomic>
 
 #include "Halliday.generated.h"
 
+class FHallidaySigner;
+class FHallidayRequestScheduler;
+class FHallidayOperation;
+enum class EHallidayRequestPriority : uint8;
+
+/** A read request in flight and the calls that share it. Only used by AHalliday on the game thread. */
+struct FHallidayReadRequest
+{
+    /** Id of the operation the request was sent for. */
+    int64 OperationId = 0;
+    
+    /** Handle ids of the calls that wait for the response and have not been cancelled. */
+    TArray<int64, TInlineAllocator<4>> CallIds;
+};
+
 /** Bind a callback function to this delegate if you want to execute an action after the player has logged in. */
 DECLARE_DYNAMIC_DELEGATE(FOnLoginCompleted);
 /** Bind a callback function to this delegate if you want to execute an action after the player has logged out. */
@@ -37,6 +57,9 @@ class HALLIDAYSDK_API AHalliday : public AActor
 protected:
     // Called when the game starts or when spawned
     virtual void BeginPlay() override;
+    
+    // Called when the actor is removed from the level or the game ends
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     // Called every frame
@@ -67,6 +90,116 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Halliday");
         FOnCallContractSubmitted OnCallContractSubmitted;
     
+    UPROPERTY(BlueprintAssignable, Category = "Halliday")
+        FOnCalldataBuilt OnCalldataBuilt;
+    
+    /**
+     * Number of signatures after which a pooled secp256k1 context is re-randomized to protect against side-channel leakage.
+     * Set to 0 to only randomize the contexts once when they are created.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        int32 Secp256k1RandomizeInterval = 64;
+    
+    /**
+     * Transaction hashes are hashed with Keccak256 locally. While this is on, the Halliday backend is also asked for the hash and the transaction is not signed if the two differ.
+     * This adds a round trip to every transaction. Only turn it off once the local hash is trusted on the target platforms.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        bool bCrossCheckKeccak256WithServer = true;
+    
+    /**
+     * Compute the ERC-4337 UserOperation hash of every built transaction locally and refuse to sign if it differs from the tx_hash returned by the Halliday backend.
+     * This is off by default because the hash depends on the EntryPoint the backend builds for. Only turn it on once EntryPointAddress is set to that EntryPoint.
+     * Transactions on a blockchain whose chain id the SDK does not know fail while this is on.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        bool bVerifyUserOperationHash = false;
+    
+    /**
+     * Recover the public key from every signature before it is submitted and refuse to submit if it is not the player's key.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        bool bVerifySignatureBeforeSubmit = true;
+    
+    /**
+     * Seconds that assets stay fresh after they were fetched. GetAssets() always delivers cached assets right away and revalidates them in the background once they are older than this.
+     * OnAssetsReceived only fires a second time if the assets changed. Set to 0 to revalidate on every call.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        float AssetsCacheTtlSeconds = 30.0f;
+    
+    /**
+     * Seconds that balances stay fresh after they were fetched. GetBalances() always delivers cached balances right away and revalidates them in the background once they are older than this.
+     * OnBalancesReceived only fires a second time if the balances changed. Set to 0 to revalidate on every call.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        float BalancesCacheTtlSeconds = 10.0f;
+    
+    /**
+     * Maximum number of requests to the Halliday backend in flight at once. Further requests wait in a queue where transactions go before wallets, balances and assets,
+     * and players take turns within each of those, so a burst of inventory refreshes cannot delay a purchase.
+     * Below this cap, each class of endpoints adapts its own rate and concurrency to what the backend sustains, backing off on 429 and 5xx responses and retrying the throttled requests.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        int32 MaxRequestsInFlight = 6;
+    
+    /**
+     * Send a lightweight request to the Halliday backend in Initialize() so that DNS, TCP and TLS are done before the first real call, usually the wallet fetch after login.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        bool bPrewarmConnection = true;
+    
+    /**
+     * Warm the connection up again after this many seconds without a request, before the backend or a proxy closes it. 0, the default, only warms it up in Initialize().
+     * Every idle game instance then sends a request this often for as long as it runs, so only turn this on if the first call after a quiet period must be fast, e.g. to 45.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        float ConnectionRewarmIdleSeconds = 0.0f;
+    
+    /**
+     * Send a second, identical request for GetAssets() and GetBalances() when the first is slow and use whichever answers first. This cuts the tail latency caused by a stalled connection.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        bool bHedgeReadRequests = false;
+    
+    /**
+     * Seconds a hedged read is in flight before the second request is sent. Set to 0 to use the 95th percentile of the recent response times of the endpoint.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        float HedgeDelaySeconds = 0.0f;
+    
+    /**
+     * Extra requests hedging may add, in percent of the hedgeable reads sent.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        float HedgeBudgetPercent = 5.0f;
+    
+    /**
+     * Seconds a request to the Halliday backend may take once it is sent before it fails. Set to 0 to use the default of the HTTP module.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        float RequestTimeoutSeconds = 30.0f;
+    
+    /** Number of times a signed transaction is submitted before giving up on connection errors, 408, 429 and 5xx responses. Every attempt reuses the signed payload and its tx_id. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        int32 MaxSubmitAttempts = 5;
+    
+    /** Upper bound of the delay before the first submit retry. The bound doubles with every retry and each delay is picked at random below it. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        float SubmitRetryBaseDelaySeconds = 0.5f;
+    
+    /** Largest bound of the delay between submit retries. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        float SubmitRetryMaxDelaySeconds = 8.0f;
+    
+    /** Maximum number of workers SignBatch() spreads a batch across. Set to 0 to use every task graph worker plus the calling thread. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        int32 MaxBatchSigningWorkers = 0;
+    
+    /** Address of the ERC-4337 EntryPoint contract that is used to compute UserOperation hashes if bVerifyUserOperationHash is set. Defaults to the v0.6 EntryPoint. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Halliday")
+        FString EntryPointAddress = TEXT("0x5FF137D4b0FDCD49DcA30c7CF57E578a026d2789");
+    
 	AHalliday();
     
     /**
@@ -113,32 +246,52 @@ public:
 
     /**
      * Get your player's account abstraction wallet address.
+     * Wallets are cached in memory and on disk, so for a returning player OnWalletReceived is broadcast before this returns without a request.
      * @param InGamePlayerId Id of the player you want to fetch an address for.
      * @param bWasPreviouslyCalled Internally used. You do not need to use this parameter.
+     * @returns A handle to cancel the call with, or an invalid handle if the wallet was cached.
      */
     UFUNCTION(BlueprintCallable, Category = "Halliday")
-        void GetOrCreateHallidayAAWallet(const FString& InGamePlayerId, bool bWasPreviouslyCalled = false);
+        FHallidayRequestHandle GetOrCreateHallidayAAWallet(const FString& InGamePlayerId, bool bWasPreviouslyCalled = false);
         
+    /**
+     * Forget the cached wallets of a player so that the next GetOrCreateHallidayAAWallet() asks the Halliday backend again.
+     * @param InGamePlayerId Id of the player whose wallets to forget.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Halliday")
+        void InvalidateCachedWallet(const FString& InGamePlayerId);
+    
+    /**
+     * Forget every cached wallet and delete the wallet cache on disk.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Halliday")
+        void ClearWalletCache();
+    
     /**
      * Get your player's assets.
+     * Cached assets are broadcast right away. They are revalidated in the background once they are older than AssetsCacheTtlSeconds, and broadcast again only if they changed.
      * @param InGamePlayerId Id of the player  you want to fetch assets for,
+     * @returns A handle to cancel the call with, or an invalid handle if no request was sent because the cached assets are fresh or a request for them is already in flight.
      */
     UFUNCTION(BlueprintCallable, Category = "Halliday")
-        void GetAssets(const FString& InGamePlayerId);
+        FHallidayRequestHandle GetAssets(const FString& InGamePlayerId);
     
     /**
      * Get your players' native and ERC20 token balances.
+     * Cached balances are broadcast right away. They are revalidated in the background once they are older than BalancesCacheTtlSeconds, and broadcast again only if they changed.
      * @param InGamePlayerId Id of the player you want to fetch token balances for,
+     * @returns A handle to cancel the call with, or an invalid handle if no request was sent because the cached balances are fresh or a request for them is already in flight.
      */
     UFUNCTION(BlueprintCallable, Category = "Halliday")
-        void GetBalances(const FString& InGamePlayerId);
+        FHallidayRequestHandle GetBalances(const FString& InGamePlayerId);
     
     /**
      * Get a transaction that your player has built or executed.
      * @param TxId Id of the transaction id you want to fetch.
+     * @returns A handle to cancel the call with, or an invalid handle if a request for the transaction is already in flight.
      */
     UFUNCTION(BlueprintCallable, Category = "Halliday")
-        void GetTransaction(const FString& TxId);
+        FHallidayRequestHandle GetTransaction(const FString& TxId);
     
     /**
      * Enable your player to transfer an asset to another within your application.
@@ -148,10 +301,11 @@ public:
      * @param TokenId Id of the asset.
      * @param BlockchainType Blockchain where the asset resides.
      * @param bSponsorGas Enable gas sponsorship for this transaction.
+     * @returns A handle to cancel the transaction with. Cancelling does not undo a transaction that was already submitted.
      * @warning Gas sponsorship is disabled by default. Please reach out to the Halliday team to enable gas sponsorship for your application.
      */
     UFUNCTION(BlueprintCallable, Category = "Halliday")
-        void TransferAsset(const FString& FromInGamePlayerId, const FString& ToInGamePlayerId, const FString& CollectionAddress, const FString& TokenId, EBlockchainType BlockchainType, bool bSponsorGas);
+        FHallidayRequestHandle TransferAsset(const FString& FromInGamePlayerId, const FString& ToInGamePlayerId, const FString& CollectionAddress, const FString& TokenId, EBlockchainType BlockchainType, bool bSponsorGas);
     
     /**
      * Enable your player to transfer native or ERC20 tokens  to another within your application.
@@ -161,10 +315,11 @@ public:
      * @param bSponsorGas Enable gas sponsorship for this transaction.
      * @param Value The amount of token to send. Please check and use the decimals of the token, e.i. 1 ETH = 1e18.
      * @param TokenAddress [Optional for native transfers] Address of the token contract.
+     * @returns A handle to cancel the transaction with. Cancelling does not undo a transaction that was already submitted.
      * @warning Gas sponsorship is disabled by default. Please reach out to the Halliday team to enable gas sponsorship for your application.
      */
     UFUNCTION(BlueprintCallable, Category = "Halliday")
-        void TransferBalance(const FString& FromInGamePlayerId, const FString& ToInGamePlayerId, EBlockchainType BlockchainType, bool bSponsorGas, const FString& Value, const FString& TokenAddress = "");
+        FHallidayRequestHandle TransferBalance(const FString& FromInGamePlayerId, const FString& ToInGamePlayerId, EBlockchainType BlockchainType, bool bSponsorGas, const FString& Value, const FString& TokenAddress = "");
     
     /**
      * Enable your player to call any contract call with their Halliday smart account.
@@ -175,10 +330,77 @@ public:
      * @param BlockchainType Blockchain where the contract call is made.
      * @param bSponsorGas Enable gas sponsorship for this transaction.
      * @param Value [Optional] The amount for native transfer calls. Please check and use the decimals of the token, e.i. 1 ETH = 1e18.
+     * @returns A handle to cancel the transaction with. Cancelling does not undo a transaction that was already submitted.
      * @warning Gas sponsorship is disabled by default. Please reach out to the Halliday team to enable gas sponsorship for your application.
      */
     UFUNCTION(BlueprintCallable, Category = "Halliday")
-        void ContractCall(const FString& FromInGamePlayerId, const FString& TargetAddress, const FString& Calldata, EBlockchainType BlockchainType, bool bSponsorGas, const FString& Value = "0");
+        FHallidayRequestHandle ContractCall(const FString& FromInGamePlayerId, const FString& TargetAddress, const FString& Calldata, EBlockchainType BlockchainType, bool bSponsorGas, const FString& Value = "0");
+    
+    /**
+     * Cancel a call, e.g. because the widget that made it was closed. Its queued and in-flight requests are cancelled and its delegates are not broadcast.
+     * Read calls for the same data share one request. Cancelling one of them only detaches it, and the request is cancelled once every call that shares it is. Calls on this actor are cancelled automatically when it leaves play.
+     * @param Handle Handle returned by the call. Invalid handles and handles of finished calls are ignored.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Halliday")
+        void CancelRequest(const FHallidayRequestHandle& Handle);
+    
+    /**
+     * Build the calldata of a contract call locally and broadcast it through OnCalldataBuilt. Pass the calldata to ContractCall() to execute it.
+     * C++ callers can use FHallidayAbiEncoder directly to encode typed values without going through strings.
+     * @param FunctionSignature Signature of the function, e.g. "transfer(address,uint256)". Tuples, T[] and T[k] are supported.
+     * @param Arguments One string per parameter. Numbers may be decimal or "0x" hex and bytes are hex. Arrays are written as "[a,b]" and tuples as "(a,b)", with strings inside them in double quotes.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Halliday")
+        void BuildCalldata(const FString& FunctionSignature, const TArray<FString>& Arguments);
+    
+    /**
+     * Add a custodial private key that SignBatch() can sign with, e.g. for a bot account on a dedicated server.
+     * @param PrivateKeyHex 64 character hex string of the private key.
+     * @returns A handle to the key, or INDEX_NONE if the key is invalid.
+     */
+    int32 AddSigningKey(const FString& PrivateKeyHex);
+    
+    /**
+     * Securely zero and remove a key that was added with AddSigningKey(). The handle may be reused by a later key.
+     * @param KeyHandle Handle returned by AddSigningKey().
+     */
+    void RemoveSigningKey(int32 KeyHandle);
+    
+    /**
+     * Sign many hashes in parallel across the task graph workers. Adding or removing a signing key waits until the batch is signed.
+     * @param Requests Pairs of key handle and 32 byte hash to sign.
+     * @param OutSignatures Receives HALLIDAY_SIGNATURE_SIZE bytes (r, s, v) per request in the same order as Requests.
+     * @returns True if every hash was signed. Signatures of failed requests are left zeroed.
+     */
+    bool SignBatch(const TArray<FHallidaySignRequest>& Requests, TArray<uint8>& OutSignatures);
+    
+    /**
+     * Sign a message with the logged in player's key the way EIP-191 personal_sign does. This is done locally without a round trip.
+     * @param Message Message to sign. It is signed as UTF-8.
+     * @returns The 65 byte signature as a hex string, or an empty string on failure.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Halliday")
+        FString SignPersonalMessage(const FString& Message);
+    
+    /**
+     * Register an EIP-712 struct type and its domain so that messages of that type can be signed with SignTypedData().
+     * The type hash and domain separator are computed once here. Registering the same type and domain again returns the same handle.
+     * @param EncodedType Struct type, e.g. "Listing(address seller,uint256 tokenId,uint256 price)". Arrays and nested structs are not supported.
+     * @param Domain Domain the signatures are valid in.
+     * @returns A handle to the type, or INDEX_NONE if the type or domain is malformed.
+     * @warning Register types on the game thread before signing them from other threads.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Halliday")
+        int32 RegisterTypedDataType(const FString& EncodedType, const FHallidayEip712Domain& Domain);
+    
+    /**
+     * Sign an EIP-712 message with the logged in player's key. This is done locally without a round trip.
+     * @param TypeHandle Handle returned by RegisterTypedDataType().
+     * @param Values One value per member of the type in declaration order. Numbers may be decimal or "0x" hex, bytes are hex and bools are "true" or "false".
+     * @returns The 65 byte signature as a hex string, or an empty string on failure.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Halliday")
+        FString SignTypedData(int32 TypeHandle, const TArray<FString>& Values);
     
     /**
      * Getters and setters.
@@ -203,16 +425,29 @@ public:
     
     UFUNCTION(BlueprintCallable, Category = "Halliday")
         void SetInGamePlayerId(const FString& InGamePlayerId);
+    
+    /**
+     * Get counters of the requests the SDK has sent and saved since the actor was spawned.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Halliday")
+        FHallidayStats GetStats();
 
     /**
-     * Generate the public key using the private key returned by Web3Auth.
+     * Get the uncompressed public key of the logged in player. This is derived once at login from the private key returned by Web3Auth.
      * You do not need to call this.
      */
     UFUNCTION()
         FString _GetPublicKeyFromPrivateKey();
     
     /**
-     * Sign a transaction hash with a private key.
+     * Get the EIP-55 checksummed address of the logged in player's signing key. This is derived locally at login.
+     * You do not need to call this.
+     */
+    UFUNCTION()
+        FString _GetSignerAddress();
+    
+    /**
+     * Sign a transaction hash with a private key. This is safe to call from any thread.
      * You do not need to call this.
      * @param TxHash Keccak256 hashed transaction hash
      * @param PrivateKey Private key to sign with
@@ -220,6 +455,72 @@ public:
      */
     UFUNCTION()
         FString _Secp256k1(FString TxHash);
+    
+    /**
+     * Sign a 32 byte hash with the logged in player's key. This is safe to call from any thread.
+     * You do not need to call this.
+     * @param Hash Keccak256 hashed transaction hash
+     * @param OutSignature Receives the compact recoverable signature with v set to 27 or 28.
+     * @returns A boolean to indicate success or failure.
+     */
+    bool _SignHash(const FHallidayHash32& Hash, FHallidaySignature& OutSignature);
+    
+    /**
+     * Get the signer that holds the logged in player's key. It may be kept and used from any thread, also after the actor is gone.
+     * You do not need to call this.
+     */
+    TSharedRef<FHallidaySigner, ESPMode::ThreadSafe> _GetSigner() const;
+    
+    /**
+     * Create an HTTP request and note that the connection to the Halliday backend is in use. This is safe to call from any thread.
+     * You do not need to call this.
+     */
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> _CreateRequest();
+    
+    /**
+     * Send a request through the request scheduler once a slot is free. This is safe to call from any thread.
+     * You do not need to call this.
+     * @param Request Request with its completion delegate bound.
+     * @param Priority Priority class of the request.
+     * @param PlayerId Player the request is made for, so that players take turns.
+     * @param Operation Call the request is made for, so that it is cancelled with it.
+     * @param bCanHedge Whether the request has no side effects and may be hedged if bHedgeReadRequests is set.
+     * @param bCanRequeue Whether the scheduler sends the request again on a 429 or 503. Pass false if the caller retries it itself.
+     */
+    void _ProcessRequest(const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& Request, EHallidayRequestPriority Priority, const FString& PlayerId, const TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe>& Operation, bool bCanHedge = false, bool bCanRequeue = true);
+    
+    /**
+     * Fetch the wallet of a player, creating it if needed, as part of a call that can be cancelled.
+     * You do not need to call this.
+     * @param InGamePlayerId Id of the player you want to fetch an address for.
+     * @param bWasPreviouslyCalled Whether the wallet was just created, so that it is not created again.
+     * @param Operation Call of GetOrCreateHallidayAAWallet() that this is part of.
+     */
+    void _GetOrCreateWallet(const FString& InGamePlayerId, bool bWasPreviouslyCalled, const TSharedRef<FHallidayOperation, ESPMode::ThreadSafe>& Operation);
+    
+    /**
+     * Record how often a transaction was submitted and how long it was retried. Called on the game thread once the transaction is submitted or given up on.
+     * You do not need to call this.
+     * @param NumAttempts Number of times the signed payload was submitted.
+     * @param RetrySeconds Seconds from the first failed attempt to the last response.
+     * @param bWasSubmitted Whether the backend accepted the transaction.
+     */
+    void _RecordSubmitAttempts(int32 NumAttempts, double RetrySeconds, bool bWasSubmitted);
+    
+    /**
+     * Broadcast a wallet through OnWalletReceived and record the time to the first wallet.
+     * You do not need to call this.
+     * @param Wallet Wallet to broadcast.
+     */
+    void _BroadcastWallet(const FWallet& Wallet);
+    
+    /**
+     * Remember a wallet returned by the Halliday backend.
+     * You do not need to call this.
+     * @param InGamePlayerId Id of the player the wallet was requested for.
+     * @param Wallet Wallet to cache.
+     */
+    void _CacheWallet(const FString& InGamePlayerId, const FWallet& Wallet);
 private:
     /**
      * [PRIVATE HELPER METHODS] You will not need to call these yourself.
@@ -236,6 +537,51 @@ private:
      */
     UFUNCTION()
         void _HandleLogout();
+    
+    /**
+     * Send a HEAD request to the API endpoint so that the HTTP module has a connection ready for the next call.
+     */
+    void _PrewarmConnection();
+    
+    /**
+     * Register a read call with the requests in flight. Calls for the same endpoint, player and chain share one request, and its response is broadcast once to every listener.
+     * @param RequestKey Key from _MakeReadRequestKey().
+     * @param OutHandle Receives the handle of the call. Every call gets its own, also when it shares a request.
+     * @returns The operation to send the request for, or nullptr if the call attached to a request that is already in flight.
+     */
+    TSharedPtr<FHallidayOperation, ESPMode::ThreadSafe> _BeginReadRequest(const FString& RequestKey, FHallidayRequestHandle& OutHandle);
+    
+    /**
+     * Remove a read request from the requests in flight once its response has arrived, so that the next call sends a fresh request.
+     * @param RequestKey Key that was passed to _BeginReadRequest().
+     * @param Operation Operation returned by _BeginReadRequest(). A newer request for the same key is left alone.
+     */
+    void _EndReadRequest(const FString& RequestKey, const FHallidayOperation& Operation);
+    
+    /**
+     * Start a call that can be cancelled.
+     * @param OutHandle Receives the handle to return to the caller.
+     * @returns The operation to enqueue the requests of the call for.
+     */
+    TSharedRef<FHallidayOperation, ESPMode::ThreadSafe> _BeginOperation(FHallidayRequestHandle& OutHandle);
+    
+    /**
+     * Cancel a call that does not share its request.
+     * @param OperationId Id of the call's operation.
+     */
+    void _CancelOperation(int64 OperationId);
+    
+    /**
+     * Cancel every call that has not finished and every request in flight. Called when the actor leaves play.
+     */
+    void _CancelAllOperations();
+    
+    /**
+     * Build the key that identifies identical read calls.
+     * @param Endpoint Name of the endpoint, e.g. "assets".
+     * @param Id Player or transaction the call is for.
+     */
+    FString _MakeReadRequestKey(const TCHAR* Endpoint, const FString& Id) const;
    
     /**
      *[PRIVATE MEMBER VARIABLES]
@@ -253,12 +599,54 @@ private:
     /** The base Halliday endpoint that your API calls will target depending on the production mode you provided in 'Initialize()'  */
     FString _ApiEndpoint;
     
-    /** The private key of your player that will be used to sign onchain transactions. This is only set once the player logs in. */
-    FString _PrivateKey;
-    
     /** Id of the player that has logged in.  */
     FString _InGamePlayerId;
     
+    /** The logged in player's key and the keys added with AddSigningKey(). Shared with transactions that sign on background threads, so that they never touch the actor. */
+    TSharedPtr<FHallidaySigner, ESPMode::ThreadSafe> _Signer;
+    
+    /** Encoder reused by every BuildCalldata() call so that its buffers are only allocated once. */
+    FHallidayAbiEncoder _CalldataEncoder;
+    
+    /** EIP-712 types that were registered with RegisterTypedDataType(). Handles are indices into this array. */
+    TArray<FHallidayEip712Schema> _TypedDataSchemas;
+    
+    /** Handle of each registered type keyed by its encoded type and domain separator. */
+    TMap<FString, int32> _TypedDataSchemaHandles;
+    
+    /** Wallets of players keyed by player and blockchain, loaded from disk in Initialize(). Only used on the game thread. */
+    FHallidayWalletCache _WalletCache;
+    
+    /** Assets by read request key for stale-while-revalidate. Emptied at logout. */
+    THallidayResponseCache<FGetAssetsResponse> _AssetsCache;
+    
+    /** Balances by read request key for stale-while-revalidate. Emptied at logout. */
+    THallidayResponseCache<FGetBalancesResponse> _BalancesCache;
+    
+    /** Read requests in flight by key. Only used on the game thread. */
+    TMap<FString, FHallidayReadRequest> _InFlightReadRequests;
+    
+    /** Key of the read request that each read call waits for, by handle id. Only used on the game thread. */
+    TMap<int64, FString> _ReadRequestCalls;
+    
+    /** Counters returned by GetStats(). Only updated on the game thread. */
+    FHallidayStats _Stats;
+    
+    /** Calls that may still be running by handle id, so that CancelRequest() can find them. Finished calls expire on their own. Only used on the game thread. */
+    TMap<int64, TWeakPtr<FHallidayOperation, ESPMode::ThreadSafe>> _Operations;
+    
+    /** Id of the last call that was started. */
+    int64 _LastOperationId = 0;
+    
+    /** Gate that every request goes through. Shared with the completion callbacks of requests in flight. */
+    TSharedPtr<FHallidayRequestScheduler, ESPMode::ThreadSafe> _RequestScheduler;
+    
+    /** FPlatformTime::Seconds() at which Initialize() was called, or 0 before that. */
+    double _InitializeTime = 0.0;
+    
+    /** FPlatformTime::Seconds() at which the last request was created. Updated from any thread. */
+    std::atomic<double> _LastRequestTime{0.0};
+    
     /** UserInfo is a Web3Auth class that contains the details of your player's login. This is only set once the player logs in. */
     FUserInfo _UserInfo;
 };
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HallidayTypes.h"
+#include "Templates/Tuple.h"
+#include <type_traits>
+
+/**
+ * A 256 bit unsigned integer as a 32 byte big-endian word. Used for token ids and amounts that do not fit in 64 bits.
+ */
+struct HALLIDAYSDK_API FHallidayUint256
+{
+    uint8 Bytes[32] = {0};
+
+    FHallidayUint256() = default;
+
+    /** Set the value of a 64 bit number. */
+    explicit FHallidayUint256(uint64 Value);
+
+    /**
+     * Parse a decimal or "0x" hex number.
+     * @param Value Number to parse.
+     * @param OutValue Receives the number.
+     * @returns False if the value is malformed or does not fit in 256 bits.
+     */
+    static bool FromString(const FString& Value, FHallidayUint256& OutValue);
+};
+
+/**
+ * Encoder for contract calldata and abi.encode() data that writes straight into a reusable byte buffer without a server round trip.
+ * Static values are written in place. Dynamic values (bytes, string, T[] and tuples that contain them) are written to a tail and referenced by offset as the ABI requires.
+ *
+ * Values are added in declaration order, either one by one:
+ *     Encoder.Begin(FHallidayErc20::Transfer); // From HallidaySelectors.h
+ *     Encoder.AddAddress(To);
+ *     Encoder.AddUint(Amount);
+ *     const TArray<uint8>& Calldata = Encoder.Finish();
+ * or with the typed template:
+ *     const TArray<uint8>& Calldata = Encoder.EncodeCall(Selector, To, Amount);
+ *
+ * Buffers are kept between calls, so encoding calls of a similar shape does not allocate once the encoder is warm. An encoder must only be used by one thread at a time.
+ */
+class HALLIDAYSDK_API FHallidayAbiEncoder
+{
+public:
+    /** Size of an ABI word in bytes. */
+    static constexpr int32 WordSize = 32;
+
+    /**
+     * Compute the 4 byte function selector of a canonical function signature, e.g. "transfer(address,uint256)".
+     * This hashes the signature at runtime. Use the compile-time constants in HallidaySelectors.h for signatures known when building.
+     * @param FunctionSignature Canonical signature without spaces or parameter names.
+     * @returns The first 4 bytes of the Keccak256 hash of the signature as a big-endian number.
+     */
+    static uint32 ComputeSelector(const FString& FunctionSignature);
+
+    /**
+     * Write an unsigned number as a 32 byte big-endian word.
+     * @param Value Decimal digits or a "0x" hex number.
+     * @param Bits Size of the uint type, e.g. 256 for uint256.
+     * @param OutWord Buffer of 32 bytes that receives the word.
+     * @returns False if the value is malformed or does not fit in Bits bits.
+     */
+    static bool ParseUint(const FString& Value, int32 Bits, uint8* OutWord);
+
+    /**
+     * Write a signed number as a 32 byte two's complement word.
+     * @param Value Decimal digits or a "0x" hex number with an optional leading "-".
+     * @param Bits Size of the int type, e.g. 256 for int256.
+     * @param OutWord Buffer of 32 bytes that receives the word.
+     * @returns False if the value is malformed or does not fit in Bits bits.
+     */
+    static bool ParseInt(const FString& Value, int32 Bits, uint8* OutWord);
+
+    FHallidayAbiEncoder();
+
+    /**
+     * Start encoding the arguments of a function call. The previous calldata is discarded.
+     * @param Selector Function selector, e.g. from HallidaySelectors.h or ComputeSelector().
+     */
+    void Begin(uint32 Selector);
+
+    /**
+     * Start encoding a tuple of values without a selector, i.e. abi.encode(). The previous data is discarded.
+     */
+    void Begin();
+
+    /** Add a uint8 to uint64 value. */
+    void AddUint(uint64 Value);
+
+    /** Add a uint256 value. */
+    void AddUint(const FHallidayUint256& Value);
+
+    /** Add an int8 to int64 value. */
+    void AddInt(int64 Value);
+
+    /** Add a bool value. */
+    void AddBool(bool bValue);
+
+    /** Add an address value. */
+    void AddAddress(const FHallidayAddress& Address);
+
+    /**
+     * Add a bytes1 to bytes32 value.
+     * @param Bytes Bytes of the value.
+     * @param Size Number of bytes, between 1 and 32.
+     */
+    void AddFixedBytes(const uint8* Bytes, int32 Size);
+
+    /**
+     * Add a dynamic bytes value.
+     * @param Bytes Bytes of the value.
+     * @param Size Number of bytes.
+     */
+    void AddBytes(const uint8* Bytes, int32 Size);
+
+    /** Add a string value. It is encoded as UTF-8. */
+    void AddString(const FString& Value);
+
+    /** Start a tuple. Fixed-size arrays T[k] are encoded like tuples, so use this for them as well. */
+    void BeginTuple();
+
+    /** Finish the tuple started by the matching BeginTuple(). */
+    void EndTuple();
+
+    /** Start a dynamic array T[]. Its length is the number of values added before EndArray(). */
+    void BeginArray();
+
+    /** Finish the array started by the matching BeginArray(). */
+    void EndArray();
+
+    /**
+     * Finish encoding. Every tuple and array must have been ended.
+     * @returns The encoded data. It stays valid until the next call to Begin().
+     */
+    const TArray<uint8>& Finish();
+
+    /** The data produced by the last Finish() or EncodeCall(). */
+    const TArray<uint8>& GetEncoded() const { return Data; }
+
+    /**
+     * Parse a function signature and encode the arguments of a call from strings. This is slower than the typed methods and is meant for Blueprints.
+     * @param FunctionSignature Signature such as "safeTransferFrom(address,address,uint256)". Tuples, T[] and T[k] are supported.
+     * @param Arguments One string per parameter. Numbers may be decimal or "0x" hex and bytes are hex. Arrays are written as "[a,b]" and tuples as "(a,b)", with strings inside them in double quotes.
+     * @returns False if the signature is malformed or an argument does not match its type. Otherwise the calldata is available from GetEncoded().
+     */
+    bool EncodeCall(const FString& FunctionSignature, const TArray<FString>& Arguments);
+
+    /**
+     * Encode a function call from typed C++ values in one call.
+     * Integers map to uintN or intN, bool to bool, FHallidayAddress to address, FHallidayHash32 to bytes32, FHallidayUint256 to uint256, FString to string,
+     * TArray<uint8> to bytes, any other TArray<T> to T[] and TTuple<...> to a tuple.
+     * @param Selector Function selector, e.g. from HallidaySelectors.h or ComputeSelector().
+     * @param Args Arguments in declaration order.
+     * @returns The calldata. It stays valid until the next call to Begin().
+     */
+    template<typename... TArgs>
+    const TArray<uint8>& EncodeCall(uint32 Selector, const TArgs&... Args)
+    {
+        Begin(Selector);
+        (Add(Args), ...);
+        return Finish();
+    }
+
+    void Add(bool bValue) { AddBool(bValue); }
+    void Add(const FHallidayAddress& Address) { AddAddress(Address); }
+    void Add(const FHallidayHash32& Hash) { AddFixedBytes(Hash.Bytes, FHallidayHash32::Size); }
+    void Add(const FHallidayUint256& Value) { AddUint(Value); }
+    void Add(const FString& Value) { AddString(Value); }
+    void Add(const TArray<uint8>& Bytes) { AddBytes(Bytes.GetData(), Bytes.Num()); }
+
+    template<typename T>
+    typename TEnableIf<std::is_integral<T>::value>::Type Add(T Value)
+    {
+        if constexpr (std::is_signed<T>::value)
+        {
+            AddInt((int64)Value);
+        }
+        else
+        {
+            AddUint((uint64)Value);
+        }
+    }
+
+    template<typename T, typename AllocatorType>
+    void Add(const TArray<T, AllocatorType>& Values)
+    {
+        BeginArray();
+        for (const T& Value : Values)
+        {
+            Add(Value);
+        }
+        EndArray();
+    }
+
+    template<typename... TElements>
+    void Add(const TTuple<TElements...>& Tuple)
+    {
+        BeginTuple();
+        VisitTupleElements([this](const auto& Element) { Add(Element); }, Tuple);
+        EndTuple();
+    }
+
+private:
+    /** A tuple or array whose head and tail are being written. */
+    struct FFrame
+    {
+        /** Static values and offset slots of dynamic values. */
+        TArray<uint8> Head;
+
+        /** Encodings of the dynamic values. */
+        TArray<uint8> Tail;
+
+        /** Position of each offset slot in Head and of the value it points to in Tail. */
+        TArray<TPair<int32, int32>> Offsets;
+
+        /** Number of values added to the frame. */
+        int32 NumValues = 0;
+
+        /** Whether any value of the frame is dynamic, which makes the frame itself dynamic. */
+        bool bHasDynamicValue = false;
+
+        /** Whether the frame is a dynamic array that is prefixed with its length. */
+        bool bIsArray = false;
+    };
+
+    /** Start a frame that reuses the buffers of a previous frame at the same depth. */
+    void PushFrame(bool bIsArray);
+
+    /** Finish the innermost frame and add it to its parent. */
+    void PopFrame();
+
+    /** Add a zeroed static word to the innermost frame and return it. */
+    uint8* AddStaticWord();
+
+    /** Add an offset slot to the innermost frame and return the tail that the dynamic value must be appended to. */
+    TArray<uint8>& AddDynamicValue();
+
+    /** Resolve the offset slots of a frame now that the size of its head is known. */
+    static void PatchOffsets(FFrame& Frame);
+
+    /** Frames from the outermost argument tuple to the innermost open tuple or array. Entries beyond Depth are kept for their buffers. */
+    TArray<FFrame> Frames;
+
+    /** Index of the innermost open frame. */
+    int32 Depth = 0;
+
+    /** Selector written in front of the data, if any. */
+    uint32 Selector = 0;
+
+    bool bHasSelector = false;
+
+    /** The finished data. */
+    TArray<uint8> Data;
+};
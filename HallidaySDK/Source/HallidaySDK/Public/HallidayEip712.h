@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HallidayTypes.h"
+
+/**
+ * EIP-191 and EIP-712 message hashing for off-chain signatures such as match results, marketplace listings and login challenges.
+ * The hashes are signed with AHalliday::_SignHash(), so the signatures recover to the player's signer address.
+ */
+class HALLIDAYSDK_API FHallidayEip712
+{
+public:
+    /**
+     * Hash a message the way personal_sign does, i.e. keccak256("\x19Ethereum Signed Message:\n" + len(Message) + Message).
+     * @param Message Bytes of the message.
+     * @param Size Number of bytes in the message.
+     * @param OutHash Receives the hash to sign.
+     */
+    static void HashPersonalMessage(const uint8* Message, int32 Size, FHallidayHash32& OutHash);
+
+    /**
+     * Hash typed data, i.e. keccak256("\x19\x01" + DomainSeparator + StructHash).
+     * @param DomainSeparator Hash of the EIP-712 domain.
+     * @param StructHash Hash of the message struct.
+     * @param OutHash Receives the hash to sign.
+     */
+    static void HashTypedData(const FHallidayHash32& DomainSeparator, const FHallidayHash32& StructHash, FHallidayHash32& OutHash);
+};
+
+/**
+ * An EIP-712 struct type parsed from its encoded type, e.g. "Mail(address from,address to,string contents)".
+ * The type hash is computed once when the type is parsed, so hashing a message only hashes its values.
+ * Members may be address, bool, string, bytes, bytes1 to bytes32, uint8 to uint256 and int8 to int256. Arrays and nested structs are not supported.
+ */
+class HALLIDAYSDK_API FHallidayEip712Type
+{
+public:
+    /**
+     * Parse an encoded type. Whitespace around names and separators is ignored.
+     * @param EncodedType Type in the form "Name(type1 name1,type2 name2,...)".
+     * @param OutType Receives the parsed type.
+     * @returns False if the type is malformed or uses an unsupported member type.
+     */
+    static bool Parse(const FString& EncodedType, FHallidayEip712Type& OutType);
+
+    /**
+     * Build the EIP712Domain type and hash the domain with it. Empty members of the domain are left out.
+     * @param Domain Domain of the typed data.
+     * @param OutDomainSeparator Receives the domain separator.
+     * @returns False if a member of the domain is malformed.
+     */
+    static bool HashDomain(const FHallidayEip712Domain& Domain, FHallidayHash32& OutDomainSeparator);
+
+    /**
+     * Hash a message of this type, i.e. keccak256(TypeHash + encodeData(Values)).
+     * @param Values One value per member in declaration order. Numbers may be decimal or "0x" hex, bytes are hex and bools are "true" or "false".
+     * @param OutStructHash Receives the struct hash.
+     * @returns False if the number of values is wrong or a value does not fit its member type.
+     */
+    bool HashStruct(const TArray<FString>& Values, FHallidayHash32& OutStructHash) const;
+
+    /** Canonical encoded type without whitespace. */
+    const FString& GetEncodedType() const { return EncodedType; }
+
+    /** keccak256 of the canonical encoded type. */
+    const FHallidayHash32& GetTypeHash() const { return TypeHash; }
+
+    /** Number of members of the struct. */
+    int32 NumMembers() const { return Members.Num(); }
+
+private:
+    enum class EMemberKind : uint8
+    {
+        Address,
+        Bool,
+        String,
+        Bytes,
+        FixedBytes,
+        Uint,
+        Int,
+    };
+
+    struct FMember
+    {
+        EMemberKind Kind;
+
+        /** Bytes of a FixedBytes member or bits of an Uint or Int member. */
+        int32 Size;
+    };
+
+    FString EncodedType;
+    FHallidayHash32 TypeHash;
+    TArray<FMember> Members;
+};
+
+/** A registered EIP-712 type together with the separator of the domain it is signed in. */
+struct FHallidayEip712Schema
+{
+    FHallidayEip712Type Type;
+    
+    FHallidayHash32 DomainSeparator;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Hex codec shared by every key, hash, address and signature path in the SDK.
+ * Encoding always produces lowercase hex. Decoding accepts both cases and rejects any non-hex character instead of silently producing garbage.
+ * Blocks of 16 bytes are converted with SSE2 or NEON where available and the remainder with a scalar table lookup.
+ */
+class HALLIDAYSDK_API FHallidayHex
+{
+public:
+    /**
+     * Encode bytes as lowercase hex into a caller-provided buffer.
+     * @param Bytes Bytes to encode.
+     * @param Size Number of bytes to encode.
+     * @param OutChars Buffer of at least Size * 2 characters. No null terminator is written.
+     */
+    static void EncodeChars(const uint8* Bytes, int32 Size, TCHAR* OutChars);
+    
+    /**
+     * Decode hex characters into bytes.
+     * @param Chars Hex characters to decode.
+     * @param Size Number of bytes to decode, i.e. half the number of characters.
+     * @param OutBytes Buffer of at least Size bytes.
+     * @returns False if any character is not a hex digit. OutBytes is left partially written in that case.
+     */
+    static bool DecodeChars(const TCHAR* Chars, int32 Size, uint8* OutBytes);
+    
+    /**
+     * Encode bytes as a lowercase hex string. The string is allocated once at its final size.
+     * @param Bytes Bytes to encode.
+     * @param Size Number of bytes to encode.
+     * @param bWithPrefix Whether to prefix the string with "0x".
+     * @returns A hex string of the bytes.
+     */
+    static FString Encode(const uint8* Bytes, int32 Size, bool bWithPrefix);
+    
+    /**
+     * Decode a hex string of an exact size, e.g. a key, hash or address. An optional "0x" prefix is skipped.
+     * @param HexString Hex string to decode.
+     * @param OutBytes Buffer of Size bytes.
+     * @param Size Expected number of bytes.
+     * @returns False if the string has the wrong length or contains a character that is not a hex digit.
+     */
+    static bool Decode(const FString& HexString, uint8* OutBytes, int32 Size);
+    
+    /**
+     * Decode a hex string of any even length, e.g. calldata. An optional "0x" prefix is skipped.
+     * @param HexString Hex string to decode.
+     * @param OutBytes Array that receives the bytes. It is emptied on failure.
+     * @returns False if the string has an odd length or contains a character that is not a hex digit.
+     */
+    static bool Decode(const FString& HexString, TArray<uint8>& OutBytes);
+    
+    /**
+     * Decode a big-endian hex number into a fixed-size buffer, e.g. a uint256 or a gas value. Leading zero nibbles may be omitted and an optional "0x" prefix is skipped.
+     * @param HexString Hex string to decode.
+     * @param OutBytes Buffer of Size bytes that receives the right-aligned value.
+     * @param Size Size of the buffer.
+     * @returns False if the value does not fit in Size bytes or contains a character that is not a hex digit.
+     */
+    static bool DecodeNumber(const FString& HexString, uint8* OutBytes, int32 Size);
+};
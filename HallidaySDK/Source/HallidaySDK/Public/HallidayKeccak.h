@@ -0,0 +1,203 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * A Keccak-256 digest that can be computed at compile time.
+ */
+struct FHallidayKeccak256Digest
+{
+    uint8 Bytes[32] = {0};
+};
+
+/**
+ * Keccak-f[1600] and a one-shot Keccak-256 that are usable in constant expressions, e.g. to bake function selectors and event topics into static tables.
+ * FHallidayKeccak256 uses the same permutation at runtime.
+ */
+struct FHallidayConstexprKeccak256
+{
+    /** Round constants of the Keccak-f[1600] permutation. */
+    static constexpr uint64 RoundConstants[24] = {
+        0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+        0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+        0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+        0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+        0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+        0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+    };
+    
+    /** Number of bytes absorbed per permutation. */
+    static constexpr int32 Rate = 136;
+    
+    static constexpr uint64 RotateLeft(uint64 Value, int32 Shift)
+    {
+        return (Value << Shift) | (Value >> (64 - Shift));
+    }
+    
+    /**
+     * Apply the 24 round Keccak-f[1600] permutation to the state.
+     * @param State 25 lanes of the Keccak state.
+     */
+    static constexpr void Permute(uint64* State)
+    {
+        // The steps are written out per lane because loop counters and index arithmetic count against the constant evaluation limit of the compiler, e.g. /constexpr:steps on MSVC.
+        for (int32 Round = 0; Round < 24; ++Round)
+        {
+            // Theta
+            const uint64 C0 = State[0] ^ State[5] ^ State[10] ^ State[15] ^ State[20];
+            const uint64 C1 = State[1] ^ State[6] ^ State[11] ^ State[16] ^ State[21];
+            const uint64 C2 = State[2] ^ State[7] ^ State[12] ^ State[17] ^ State[22];
+            const uint64 C3 = State[3] ^ State[8] ^ State[13] ^ State[18] ^ State[23];
+            const uint64 C4 = State[4] ^ State[9] ^ State[14] ^ State[19] ^ State[24];
+            const uint64 D0 = C4 ^ RotateLeft(C1, 1);
+            const uint64 D1 = C0 ^ RotateLeft(C2, 1);
+            const uint64 D2 = C1 ^ RotateLeft(C3, 1);
+            const uint64 D3 = C2 ^ RotateLeft(C4, 1);
+            const uint64 D4 = C3 ^ RotateLeft(C0, 1);
+            
+            // Rho and pi, with the theta step applied to each lane as it is read
+            const uint64 B0 = State[0] ^ D0;
+            const uint64 B1 = RotateLeft(State[6] ^ D1, 44);
+            const uint64 B2 = RotateLeft(State[12] ^ D2, 43);
+            const uint64 B3 = RotateLeft(State[18] ^ D3, 21);
+            const uint64 B4 = RotateLeft(State[24] ^ D4, 14);
+            const uint64 B5 = RotateLeft(State[3] ^ D3, 28);
+            const uint64 B6 = RotateLeft(State[9] ^ D4, 20);
+            const uint64 B7 = RotateLeft(State[10] ^ D0, 3);
+            const uint64 B8 = RotateLeft(State[16] ^ D1, 45);
+            const uint64 B9 = RotateLeft(State[22] ^ D2, 61);
+            const uint64 B10 = RotateLeft(State[1] ^ D1, 1);
+            const uint64 B11 = RotateLeft(State[7] ^ D2, 6);
+            const uint64 B12 = RotateLeft(State[13] ^ D3, 25);
+            const uint64 B13 = RotateLeft(State[19] ^ D4, 8);
+            const uint64 B14 = RotateLeft(State[20] ^ D0, 18);
+            const uint64 B15 = RotateLeft(State[4] ^ D4, 27);
+            const uint64 B16 = RotateLeft(State[5] ^ D0, 36);
+            const uint64 B17 = RotateLeft(State[11] ^ D1, 10);
+            const uint64 B18 = RotateLeft(State[17] ^ D2, 15);
+            const uint64 B19 = RotateLeft(State[23] ^ D3, 56);
+            const uint64 B20 = RotateLeft(State[2] ^ D2, 62);
+            const uint64 B21 = RotateLeft(State[8] ^ D3, 55);
+            const uint64 B22 = RotateLeft(State[14] ^ D4, 39);
+            const uint64 B23 = RotateLeft(State[15] ^ D0, 41);
+            const uint64 B24 = RotateLeft(State[21] ^ D1, 2);
+            
+            // Chi
+            State[0] = B0 ^ (~B1 & B2);
+            State[1] = B1 ^ (~B2 & B3);
+            State[2] = B2 ^ (~B3 & B4);
+            State[3] = B3 ^ (~B4 & B0);
+            State[4] = B4 ^ (~B0 & B1);
+            State[5] = B5 ^ (~B6 & B7);
+            State[6] = B6 ^ (~B7 & B8);
+            State[7] = B7 ^ (~B8 & B9);
+            State[8] = B8 ^ (~B9 & B5);
+            State[9] = B9 ^ (~B5 & B6);
+            State[10] = B10 ^ (~B11 & B12);
+            State[11] = B11 ^ (~B12 & B13);
+            State[12] = B12 ^ (~B13 & B14);
+            State[13] = B13 ^ (~B14 & B10);
+            State[14] = B14 ^ (~B10 & B11);
+            State[15] = B15 ^ (~B16 & B17);
+            State[16] = B16 ^ (~B17 & B18);
+            State[17] = B17 ^ (~B18 & B19);
+            State[18] = B18 ^ (~B19 & B15);
+            State[19] = B19 ^ (~B15 & B16);
+            State[20] = B20 ^ (~B21 & B22);
+            State[21] = B21 ^ (~B22 & B23);
+            State[22] = B22 ^ (~B23 & B24);
+            State[23] = B23 ^ (~B24 & B20);
+            State[24] = B24 ^ (~B20 & B21);
+            
+            // Iota
+            State[0] ^= RoundConstants[Round];
+        }
+    }
+    
+    /**
+     * Hash characters, e.g. a function or event signature, at compile time.
+     * @param Data Characters to hash. Each is taken as one byte, so only pass ASCII.
+     * @param Size Number of characters to hash.
+     * @returns The digest.
+     */
+    static constexpr FHallidayKeccak256Digest Hash(const ANSICHAR* Data, SIZE_T Size)
+    {
+        uint64 State[25] = {};
+        SIZE_T Offset = 0;
+        for (; Size - Offset >= (SIZE_T)Rate; Offset += Rate)
+        {
+            for (int32 i = 0; i < Rate; ++i)
+            {
+                State[i >> 3] ^= (uint64)(uint8)Data[Offset + i] << ((i & 7) * 8);
+            }
+            Permute(State);
+        }
+        
+        // Absorb the tail and apply the Keccak padding.
+        const int32 Remaining = (int32)(Size - Offset);
+        for (int32 i = 0; i < Remaining; ++i)
+        {
+            State[i >> 3] ^= (uint64)(uint8)Data[Offset + i] << ((i & 7) * 8);
+        }
+        State[Remaining >> 3] ^= (uint64)0x01 << ((Remaining & 7) * 8);
+        State[(Rate - 1) >> 3] ^= (uint64)0x80 << (((Rate - 1) & 7) * 8);
+        Permute(State);
+        
+        FHallidayKeccak256Digest Digest;
+        for (int32 i = 0; i < 32; ++i)
+        {
+            Digest.Bytes[i] = (uint8)(State[i >> 3] >> ((i & 7) * 8));
+        }
+        return Digest;
+    }
+};
+
+/**
+ * Keccak-256 hasher as used by Ethereum.
+ * This is the original Keccak padding (0x01) and NOT the NIST SHA3-256 padding (0x06), so the digests match keccak256() in Solidity and ethers.
+ * Data can be hashed in one call with Hash() or streamed with Update() and Final().
+ */
+class HALLIDAYSDK_API FHallidayKeccak256
+{
+public:
+    /** Size of a digest in bytes. */
+    static constexpr int32 DigestSize = 32;
+    
+    /** Number of bytes absorbed per permutation. */
+    static constexpr int32 Rate = 136;
+    
+    FHallidayKeccak256();
+    
+    /**
+     * Clear the state so the hasher can be reused for a new message.
+     */
+    void Reset();
+    
+    /**
+     * Absorb more data into the hash.
+     * @param Data Bytes to absorb.
+     * @param Size Number of bytes to absorb.
+     */
+    void Update(const uint8* Data, int64 Size);
+    
+    /**
+     * Finish the hash and write the digest. Call Reset() before reusing the hasher.
+     * @param OutDigest Buffer of DigestSize bytes that receives the digest.
+     */
+    void Final(uint8* OutDigest);
+    
+    /**
+     * Hash a message in one call.
+     * @param Data Bytes to hash.
+     * @param Size Number of bytes to hash.
+     * @param OutDigest Buffer of DigestSize bytes that receives the digest.
+     */
+    static void Hash(const uint8* Data, int64 Size, uint8* OutDigest);
+    
+private:
+    /** The 1600 bit Keccak state as 25 little-endian lanes. */
+    uint64 State[25];
+    
+    /** Number of bytes absorbed into the current block. */
+    int32 BlockOffset;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Parsed responses of read calls for stale-while-revalidate.
+ * A cached response is delivered right away and revalidated in the background once it is older than its TTL. The revalidation sends the ETag as If-None-Match, and a 304 or a body with the same content hash leaves the cached response as it is.
+ * The cache must only be used on the game thread.
+ */
+template<typename TResponseType>
+class THallidayResponseCache
+{
+public:
+    /**
+     * Find a cached response.
+     * @param Key Key of the read call.
+     * @returns The response, or nullptr if none is cached.
+     */
+    const TResponseType* Find(const FString& Key) const
+    {
+        const FEntry* Entry = Entries.Find(Key);
+        return Entry ? &Entry->Response : nullptr;
+    }
+
+    /**
+     * Check whether a cached response is recent enough to be delivered without revalidating it.
+     * @param Key Key of the read call.
+     * @param TtlSeconds Seconds a response stays fresh after it was fetched or revalidated.
+     */
+    bool IsFresh(const FString& Key, double TtlSeconds) const
+    {
+        const FEntry* Entry = Entries.Find(Key);
+        return Entry && FPlatformTime::Seconds() - Entry->ValidatedTime < TtlSeconds;
+    }
+
+    /**
+     * Get the ETag of a cached response to send as If-None-Match.
+     * @param Key Key of the read call.
+     * @returns The ETag, or an empty string if there is none.
+     */
+    FString GetETag(const FString& Key) const
+    {
+        const FEntry* Entry = Entries.Find(Key);
+        return Entry ? Entry->ETag : FString();
+    }
+
+    /**
+     * Check a response from the backend against the cached one and mark the cached one as fresh again if the data did not change.
+     * @param Key Key of the read call.
+     * @param bIsNotModified Whether the backend answered 304 Not Modified.
+     * @param ContentHash Hash of the response body. Ignored for a 304.
+     * @returns True if the cached response is still current, false if the response must be parsed and stored.
+     */
+    bool Revalidate(const FString& Key, bool bIsNotModified, uint64 ContentHash)
+    {
+        FEntry* Entry = Entries.Find(Key);
+        if (Entry == nullptr || (!bIsNotModified && Entry->ContentHash != ContentHash))
+        {
+            return false;
+        }
+
+        Entry->ValidatedTime = FPlatformTime::Seconds();
+        return true;
+    }
+
+    /**
+     * Store a response that changed.
+     * @param Key Key of the read call.
+     * @param Response Parsed response.
+     * @param ETag ETag header of the response, if any.
+     * @param ContentHash Hash of the response body.
+     * @returns The stored response.
+     */
+    const TResponseType& Store(const FString& Key, TResponseType&& Response, const FString& ETag, uint64 ContentHash)
+    {
+        FEntry& Entry = Entries.FindOrAdd(Key);
+        Entry.Response = MoveTemp(Response);
+        Entry.ETag = ETag;
+        Entry.ContentHash = ContentHash;
+        Entry.ValidatedTime = FPlatformTime::Seconds();
+        return Entry.Response;
+    }
+
+    /** Remove every cached response. */
+    void Empty()
+    {
+        Entries.Empty();
+    }
+
+private:
+    struct FEntry
+    {
+        TResponseType Response;
+
+        FString ETag;
+
+        uint64 ContentHash = 0;
+
+        /** FPlatformTime::Seconds() at which the response was last fetched or revalidated. */
+        double ValidatedTime = 0.0;
+    };
+
+    /** Responses keyed by the endpoint, player and chain of the read call. */
+    TMap<FString, FEntry> Entries;
+};
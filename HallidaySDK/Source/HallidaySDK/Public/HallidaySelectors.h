@@ -0,0 +1,171 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HallidayKeccak.h"
+
+/**
+ * Compile-time function selectors and event topics.
+ * Use the literals for your own contracts, e.g.
+ *     using namespace HallidayLiterals;
+ *     constexpr uint32 MintSelector = "mint(address,uint256)"_selector;
+ *     Encoder.EncodeCall(MintSelector, To, Amount);
+ * Signatures must be canonical: no spaces, no parameter names and full type names such as uint256.
+ */
+
+/**
+ * Compute the 4 byte selector of a canonical function signature at compile time.
+ * @param Signature Function signature, e.g. "transfer(address,uint256)".
+ * @param Size Number of characters in the signature.
+ * @returns The first 4 bytes of the Keccak256 hash of the signature as a big-endian number.
+ */
+constexpr uint32 HallidayComputeSelector(const ANSICHAR* Signature, SIZE_T Size)
+{
+    const FHallidayKeccak256Digest Digest = FHallidayConstexprKeccak256::Hash(Signature, Size);
+    return ((uint32)Digest.Bytes[0] << 24) | ((uint32)Digest.Bytes[1] << 16) | ((uint32)Digest.Bytes[2] << 8) | (uint32)Digest.Bytes[3];
+}
+
+/** Compute the selector of a function signature given as a string literal. */
+template<SIZE_T N>
+constexpr uint32 HallidayComputeSelector(const ANSICHAR (&Signature)[N])
+{
+    return HallidayComputeSelector(Signature, N - 1);
+}
+
+/**
+ * Compute topic 0 of an event signature given as a string literal at compile time.
+ * @param Signature Event signature, e.g. "Transfer(address,address,uint256)".
+ * @returns The Keccak256 hash of the signature.
+ */
+template<SIZE_T N>
+constexpr FHallidayKeccak256Digest HallidayComputeTopic(const ANSICHAR (&Signature)[N])
+{
+    return FHallidayConstexprKeccak256::Hash(Signature, N - 1);
+}
+
+namespace HallidayLiterals
+{
+    /** "transfer(address,uint256)"_selector is the 4 byte selector of the function. */
+    constexpr uint32 operator""_selector(const ANSICHAR* Signature, SIZE_T Size)
+    {
+        return HallidayComputeSelector(Signature, Size);
+    }
+
+    /** "Transfer(address,address,uint256)"_topic is topic 0 of the event. */
+    constexpr FHallidayKeccak256Digest operator""_topic(const ANSICHAR* Signature, SIZE_T Size)
+    {
+        return FHallidayConstexprKeccak256::Hash(Signature, Size);
+    }
+}
+
+/** A function or event signature together with its selector. */
+struct FHallidaySelectorEntry
+{
+    const ANSICHAR* Signature;
+    uint32 Selector;
+};
+
+/** Functions and events of ERC-20 tokens. */
+struct FHallidayErc20
+{
+    static constexpr uint32 TotalSupply = HallidayComputeSelector("totalSupply()");
+    static constexpr uint32 BalanceOf = HallidayComputeSelector("balanceOf(address)");
+    static constexpr uint32 Transfer = HallidayComputeSelector("transfer(address,uint256)");
+    static constexpr uint32 TransferFrom = HallidayComputeSelector("transferFrom(address,address,uint256)");
+    static constexpr uint32 Approve = HallidayComputeSelector("approve(address,uint256)");
+    static constexpr uint32 Allowance = HallidayComputeSelector("allowance(address,address)");
+    static constexpr uint32 Name = HallidayComputeSelector("name()");
+    static constexpr uint32 Symbol = HallidayComputeSelector("symbol()");
+    static constexpr uint32 Decimals = HallidayComputeSelector("decimals()");
+
+    static constexpr FHallidayKeccak256Digest TransferEvent = HallidayComputeTopic("Transfer(address,address,uint256)");
+    static constexpr FHallidayKeccak256Digest ApprovalEvent = HallidayComputeTopic("Approval(address,address,uint256)");
+};
+
+/** Functions and events of ERC-721 tokens. Transfer and Approval share their topics with ERC-20. */
+struct FHallidayErc721
+{
+    static constexpr uint32 BalanceOf = FHallidayErc20::BalanceOf;
+    static constexpr uint32 OwnerOf = HallidayComputeSelector("ownerOf(uint256)");
+    static constexpr uint32 TransferFrom = FHallidayErc20::TransferFrom;
+    static constexpr uint32 SafeTransferFrom = HallidayComputeSelector("safeTransferFrom(address,address,uint256)");
+    static constexpr uint32 SafeTransferFromWithData = HallidayComputeSelector("safeTransferFrom(address,address,uint256,bytes)");
+    static constexpr uint32 Approve = FHallidayErc20::Approve;
+    static constexpr uint32 SetApprovalForAll = HallidayComputeSelector("setApprovalForAll(address,bool)");
+    static constexpr uint32 GetApproved = HallidayComputeSelector("getApproved(uint256)");
+    static constexpr uint32 IsApprovedForAll = HallidayComputeSelector("isApprovedForAll(address,address)");
+    static constexpr uint32 TokenURI = HallidayComputeSelector("tokenURI(uint256)");
+
+    static constexpr FHallidayKeccak256Digest TransferEvent = FHallidayErc20::TransferEvent;
+    static constexpr FHallidayKeccak256Digest ApprovalEvent = FHallidayErc20::ApprovalEvent;
+    static constexpr FHallidayKeccak256Digest ApprovalForAllEvent = HallidayComputeTopic("ApprovalForAll(address,address,bool)");
+};
+
+/** Functions and events of ERC-1155 tokens. */
+struct FHallidayErc1155
+{
+    static constexpr uint32 BalanceOf = HallidayComputeSelector("balanceOf(address,uint256)");
+    static constexpr uint32 BalanceOfBatch = HallidayComputeSelector("balanceOfBatch(address[],uint256[])");
+    static constexpr uint32 SafeTransferFrom = HallidayComputeSelector("safeTransferFrom(address,address,uint256,uint256,bytes)");
+    static constexpr uint32 SafeBatchTransferFrom = HallidayComputeSelector("safeBatchTransferFrom(address,address,uint256[],uint256[],bytes)");
+    static constexpr uint32 SetApprovalForAll = FHallidayErc721::SetApprovalForAll;
+    static constexpr uint32 IsApprovedForAll = FHallidayErc721::IsApprovedForAll;
+    static constexpr uint32 Uri = HallidayComputeSelector("uri(uint256)");
+
+    static constexpr FHallidayKeccak256Digest TransferSingleEvent = HallidayComputeTopic("TransferSingle(address,address,address,uint256,uint256)");
+    static constexpr FHallidayKeccak256Digest TransferBatchEvent = HallidayComputeTopic("TransferBatch(address,address,address,uint256[],uint256[])");
+    static constexpr FHallidayKeccak256Digest ApprovalForAllEvent = FHallidayErc721::ApprovalForAllEvent;
+    static constexpr FHallidayKeccak256Digest UriEvent = HallidayComputeTopic("URI(string,uint256)");
+};
+
+/** Every standard function the SDK knows, e.g. to name a selector in logs. */
+constexpr FHallidaySelectorEntry HallidayKnownFunctions[] = {
+    { "totalSupply()", FHallidayErc20::TotalSupply },
+    { "balanceOf(address)", FHallidayErc20::BalanceOf },
+    { "transfer(address,uint256)", FHallidayErc20::Transfer },
+    { "transferFrom(address,address,uint256)", FHallidayErc20::TransferFrom },
+    { "approve(address,uint256)", FHallidayErc20::Approve },
+    { "allowance(address,address)", FHallidayErc20::Allowance },
+    { "name()", FHallidayErc20::Name },
+    { "symbol()", FHallidayErc20::Symbol },
+    { "decimals()", FHallidayErc20::Decimals },
+    { "ownerOf(uint256)", FHallidayErc721::OwnerOf },
+    { "safeTransferFrom(address,address,uint256)", FHallidayErc721::SafeTransferFrom },
+    { "safeTransferFrom(address,address,uint256,bytes)", FHallidayErc721::SafeTransferFromWithData },
+    { "setApprovalForAll(address,bool)", FHallidayErc721::SetApprovalForAll },
+    { "getApproved(uint256)", FHallidayErc721::GetApproved },
+    { "isApprovedForAll(address,address)", FHallidayErc721::IsApprovedForAll },
+    { "tokenURI(uint256)", FHallidayErc721::TokenURI },
+    { "balanceOf(address,uint256)", FHallidayErc1155::BalanceOf },
+    { "balanceOfBatch(address[],uint256[])", FHallidayErc1155::BalanceOfBatch },
+    { "safeTransferFrom(address,address,uint256,uint256,bytes)", FHallidayErc1155::SafeTransferFrom },
+    { "safeBatchTransferFrom(address,address,uint256[],uint256[],bytes)", FHallidayErc1155::SafeBatchTransferFrom },
+    { "uri(uint256)", FHallidayErc1155::Uri },
+};
+
+/**
+ * Find the signature of a standard function by its selector.
+ * @param Selector Selector to look up.
+ * @returns The signature, or nullptr if the function is not in HallidayKnownFunctions.
+ */
+constexpr const ANSICHAR* HallidayFindKnownFunction(uint32 Selector)
+{
+    for (const FHallidaySelectorEntry& Entry : HallidayKnownFunctions)
+    {
+        if (Entry.Selector == Selector)
+        {
+            return Entry.Signature;
+        }
+    }
+    return nullptr;
+}
+
+// Known selectors from the token standards. A mismatch means the compile-time Keccak is broken.
+static_assert(FHallidayErc20::Transfer == 0xa9059cbb, "transfer(address,uint256) must be 0xa9059cbb");
+static_assert(FHallidayErc20::TransferFrom == 0x23b872dd, "transferFrom(address,address,uint256) must be 0x23b872dd");
+static_assert(FHallidayErc20::Approve == 0x095ea7b3, "approve(address,uint256) must be 0x095ea7b3");
+static_assert(FHallidayErc20::BalanceOf == 0x70a08231, "balanceOf(address) must be 0x70a08231");
+static_assert(FHallidayErc721::SafeTransferFrom == 0x42842e0e, "safeTransferFrom(address,address,uint256) must be 0x42842e0e");
+static_assert(FHallidayErc721::SetApprovalForAll == 0xa22cb465, "setApprovalForAll(address,bool) must be 0xa22cb465");
+static_assert(FHallidayErc1155::SafeTransferFrom == 0xf242432a, "safeTransferFrom(address,address,uint256,uint256,bytes) must be 0xf242432a");
+static_assert(FHallidayErc1155::SafeBatchTransferFrom == 0x2eb2c2d6, "safeBatchTransferFrom(address,address,uint256[],uint256[],bytes) must be 0x2eb2c2d6");
+static_assert(FHallidayErc20::TransferEvent.Bytes[0] == 0xdd && FHallidayErc20::TransferEvent.Bytes[31] == 0xef, "Transfer(address,address,uint256) must be 0xddf252ad...f523b3ef");
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "CoreMinimal.h"
+
 #include "HallidayTypes.generated.h"
 
 UENUM(BlueprintType)
@@ -64,6 +66,153 @@ enum class ETransactionType : uint8
     CALL_CONTRACT,
 };
 
+/**
+ * A 20 byte account or contract address stored as raw bytes.
+ * Equality is constant-time and case-insensitive by construction. The EIP-55 hex string is only formatted when ToString() is called.
+ * In JSON it is read and written as a hex string, so it can be used directly as a field of a response struct.
+ */
+USTRUCT(BlueprintType)
+struct HALLIDAYSDK_API FHallidayAddress
+{
+    GENERATED_BODY()
+    
+    static constexpr int32 Size = 20;
+    
+    UPROPERTY()
+        uint8 Bytes[20];
+    
+    FHallidayAddress();
+    explicit FHallidayAddress(const uint8* InBytes);
+    
+    /**
+     * Parse a hex address with or without "0x" as the prefix. The checksum case is not validated.
+     * @returns False if the string is not exactly 20 bytes of hex.
+     */
+    static bool FromString(const FString& HexString, FHallidayAddress& OutAddress);
+    
+    /** Format the address as an EIP-55 checksummed hex string with "0x" as the prefix. */
+    FString ToString() const;
+    
+    bool IsZero() const;
+    bool operator==(const FHallidayAddress& Other) const;
+    bool operator!=(const FHallidayAddress& Other) const { return !(*this == Other); }
+    
+    bool ExportTextItem(FString& ValueStr, const FHallidayAddress& DefaultValue, UObject* Parent, int32 PortFlags, UObject* ExportRootScope) const;
+    bool ImportTextItem(const TCHAR*& Buffer, int32 PortFlags, UObject* Parent, FOutputDevice* ErrorText);
+    
+    friend uint32 GetTypeHash(const FHallidayAddress& Address);
+};
+
+/**
+ * A 32 byte hash, e.g. a transaction hash or a UserOperation hash, stored as raw bytes.
+ * Equality is constant-time. The hex string is only formatted when ToString() is called.
+ * In JSON it is read and written as a hex string, so it can be used directly as a field of a response struct.
+ */
+USTRUCT(BlueprintType)
+struct HALLIDAYSDK_API FHallidayHash32
+{
+    GENERATED_BODY()
+    
+    static constexpr int32 Size = 32;
+    
+    UPROPERTY()
+        uint8 Bytes[32];
+    
+    FHallidayHash32();
+    explicit FHallidayHash32(const uint8* InBytes);
+    
+    /**
+     * Parse a hex hash with or without "0x" as the prefix.
+     * @returns False if the string is not exactly 32 bytes of hex.
+     */
+    static bool FromString(const FString& HexString, FHallidayHash32& OutHash);
+    
+    /** Format the hash as a lowercase hex string with "0x" as the prefix. */
+    FString ToString() const;
+    
+    bool IsZero() const;
+    bool operator==(const FHallidayHash32& Other) const;
+    bool operator!=(const FHallidayHash32& Other) const { return !(*this == Other); }
+    
+    bool ExportTextItem(FString& ValueStr, const FHallidayHash32& DefaultValue, UObject* Parent, int32 PortFlags, UObject* ExportRootScope) const;
+    bool ImportTextItem(const TCHAR*& Buffer, int32 PortFlags, UObject* Parent, FOutputDevice* ErrorText);
+    
+    friend uint32 GetTypeHash(const FHallidayHash32& Hash);
+};
+
+/** Size of a compact recoverable signature (r, s, v) in bytes. */
+#define HALLIDAY_SIGNATURE_SIZE 65
+
+/**
+ * A 65 byte compact recoverable ECDSA signature (r, s, v) stored as raw bytes.
+ * Equality is constant-time. The hex string is only formatted when ToString() is called.
+ * In JSON it is read and written as a hex string, so it can be used directly as a field of a response struct. An empty string or "0x" reads as an all-zero signature.
+ */
+USTRUCT(BlueprintType)
+struct HALLIDAYSDK_API FHallidaySignature
+{
+    GENERATED_BODY()
+    
+    static constexpr int32 Size = HALLIDAY_SIGNATURE_SIZE;
+    
+    UPROPERTY()
+        uint8 Bytes[65];
+    
+    FHallidaySignature();
+    explicit FHallidaySignature(const uint8* InBytes);
+    
+    /**
+     * Parse a hex signature with or without "0x" as the prefix.
+     * @returns False if the string is not exactly 65 bytes of hex.
+     */
+    static bool FromString(const FString& HexString, FHallidaySignature& OutSignature);
+    
+    /** Format the signature as a lowercase hex string with "0x" as the prefix. */
+    FString ToString() const;
+    
+    bool IsZero() const;
+    bool operator==(const FHallidaySignature& Other) const;
+    bool operator!=(const FHallidaySignature& Other) const { return !(*this == Other); }
+    
+    bool ExportTextItem(FString& ValueStr, const FHallidaySignature& DefaultValue, UObject* Parent, int32 PortFlags, UObject* ExportRootScope) const;
+    bool ImportTextItem(const TCHAR*& Buffer, int32 PortFlags, UObject* Parent, FOutputDevice* ErrorText);
+    
+    friend uint32 GetTypeHash(const FHallidaySignature& Signature);
+};
+
+template<>
+struct TStructOpsTypeTraits<FHallidayAddress> : public TStructOpsTypeTraitsBase2<FHallidayAddress>
+{
+    enum
+    {
+        WithExportTextItem = true,
+        WithImportTextItem = true,
+        WithIdenticalViaEquality = true,
+    };
+};
+
+template<>
+struct TStructOpsTypeTraits<FHallidayHash32> : public TStructOpsTypeTraitsBase2<FHallidayHash32>
+{
+    enum
+    {
+        WithExportTextItem = true,
+        WithImportTextItem = true,
+        WithIdenticalViaEquality = true,
+    };
+};
+
+template<>
+struct TStructOpsTypeTraits<FHallidaySignature> : public TStructOpsTypeTraitsBase2<FHallidaySignature>
+{
+    enum
+    {
+        WithExportTextItem = true,
+        WithImportTextItem = true,
+        WithIdenticalViaEquality = true,
+    };
+};
+
 // Client facing
 USTRUCT(BlueprintType)
 struct FWallet
@@ -230,7 +379,7 @@ struct FAATransaction
     GENERATED_BODY()
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
-        FString sender;
+        FHallidayAddress sender;
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
         FBigNumber nonce;
@@ -260,7 +409,7 @@ struct FAATransaction
         FString paymasterAndData;
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
-        FString signature;
+        FHallidaySignature signature;
 };
 
 USTRUCT(BlueprintType)
@@ -275,7 +424,7 @@ struct FBuildTransactionResponse
     FAATransaction transaction;
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    FString tx_hash;
+    FHallidayHash32 tx_hash;
 };
 
 USTRUCT(BlueprintType)
@@ -287,14 +436,181 @@ struct FSubmitTransactionResponse
     FString tx_id;
 };
 
-/** Internal use only. You should never need to interface with this response. */
+/** A 32 byte hash to sign with a key that was added with AHalliday::AddSigningKey(). Used by AHalliday::SignBatch(). */
+struct FHallidaySignRequest
+{
+    /** Handle returned by AHalliday::AddSigningKey(). */
+    int32 KeyHandle;
+    
+    /** Hash to sign. */
+    FHallidayHash32 Hash;
+};
+
+/** Internal use only. A private key that was added with AHalliday::AddSigningKey(). */
+struct FHallidaySigningKey
+{
+    uint8 SecretKey[32];
+    
+    bool bIsValid;
+};
+
+/** EIP-712 domain of typed data that is signed with AHalliday::SignTypedData(). Empty members are left out of the domain. */
 USTRUCT(BlueprintType)
-struct FGetSignerPublicAddressResponse
+struct HALLIDAYSDK_API FHallidayEip712Domain
 {
     GENERATED_BODY()
     
+    /** Name of the signing domain, e.g. the name of your game or marketplace. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+        FString Name;
+    
+    /** Current major version of the signing domain. */
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    FString address;
+        FString Version;
+    
+    /** Chain id the signature is valid on. 0 leaves it out of the domain. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+        int64 ChainId = 0;
+    
+    /** Address of the contract that verifies the signature. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+        FString VerifyingContract;
+    
+    /** 32 byte hex salt that disambiguates the domain. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+        FString Salt;
+};
+
+class AHalliday;
+
+/**
+ * Handle to a call of AHalliday such as GetAssets() or TransferAsset(), returned so that the call can be cancelled.
+ * Blueprints pass it to AHalliday::CancelRequest().
+ */
+USTRUCT(BlueprintType)
+struct HALLIDAYSDK_API FHallidayRequestHandle
+{
+    GENERATED_BODY()
+    
+    /** Unique id of the call, or 0 if the call was answered from the cache without a request. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 Id = 0;
+    
+    /** Actor the call was made on. */
+    TWeakObjectPtr<AHalliday> Owner;
+    
+    /** Whether the handle refers to a call that sent or shares a request. */
+    bool IsValid() const { return Id != 0; }
+    
+    /** Cancel the call. Does nothing if the handle is invalid, the call finished or the actor is gone. */
+    void Cancel() const;
+};
+
+/** Counters of the requests the SDK has sent and saved. Returned by AHalliday::GetStats(). */
+USTRUCT(BlueprintType)
+struct HALLIDAYSDK_API FHallidayStats
+{
+    GENERATED_BODY()
+    
+    /** Number of GetAssets(), GetBalances() and GetTransaction() requests sent to the Halliday backend. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 ReadRequestsSent = 0;
+    
+    /** Number of read calls that attached to an identical request already in flight instead of sending their own. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 ReadRequestsCoalesced = 0;
+    
+    /** Number of GetAssets() and GetBalances() calls that were answered from the response cache right away. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 ReadCacheHits = 0;
+    
+    /** Number of revalidations that found the cached response unchanged, either by a 304 or by an identical body, so nothing was broadcast. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 ReadRevalidationsUnchanged = 0;
+    
+    /** Number of GetOrCreateHallidayAAWallet() calls answered from the wallet cache without a request. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 WalletCacheHits = 0;
+    
+    /** Number of GetOrCreateHallidayAAWallet() calls that had to ask the Halliday backend. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 WalletCacheMisses = 0;
+    
+    /** Number of requests sent to warm the connection up in Initialize() or after the connection was idle. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 ConnectionWarmups = 0;
+    
+    /** Seconds from Initialize() to the first OnWalletReceived broadcast, or -1 if no wallet has been received yet. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        float TimeToFirstWalletSeconds = -1.0f;
+    
+    /** Number of requests waiting for a free slot in the request scheduler. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int32 QueuedRequests = 0;
+    
+    /** Highest number of requests that waited in the request scheduler at once. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int32 PeakQueuedRequests = 0;
+    
+    /** Number of requests sent that have not completed yet. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int32 RequestsInFlight = 0;
+    
+    /** Average seconds a request waited in the request scheduler before it was sent. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        float AverageQueueWaitSeconds = 0.0f;
+    
+    /** Longest a request waited in the request scheduler before it was sent. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        float MaxQueueWaitSeconds = 0.0f;
+    
+    /** Number of times a rate limiter halved its rate and concurrency because the Halliday backend answered 429 or 5xx. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 RateLimitBackoffs = 0;
+    
+    /** Number of throttled requests that were queued again instead of failing. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 RequeuedRequests = 0;
+    
+    /** Number of second requests sent for slow reads. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 HedgedRequests = 0;
+    
+    /** Number of second requests that answered before the read they were sent for. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 HedgeWins = 0;
+    
+    /** Number of requests that were cancelled before they completed, e.g. with CancelRequest() or because the actor left play. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 CancelledRequests = 0;
+    
+    /** Number of asset and balance responses that arrived compressed and were decoded by the SDK. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 CompressedResponses = 0;
+    
+    /** Number of body bytes received for asset and balance responses, before decoding. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 ResponseBytesReceived = 0;
+    
+    /** Number of body bytes of asset and balance responses after decoding. Compare with ResponseBytesReceived to see the bandwidth saved. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 ResponseBytesDecoded = 0;
+    
+    /** Number of times signed transactions were submitted, including retries. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 TransactionSubmitAttempts = 0;
+    
+    /** Number of times a signed transaction was submitted again after a transient failure. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 TransactionSubmitRetries = 0;
+    
+    /** Seconds spent retrying submits in total, from the first failure of each transaction to its last response. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        float TransactionSubmitRetrySeconds = 0.0f;
+    
+    /** Number of signed transactions that were given up on. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+        int64 FailedTransactionSubmits = 0;
 };
 
 /** Internal use only. You should never need to interface with this response. */
@@ -304,5 +620,5 @@ struct FKeccak256Response
     GENERATED_BODY()
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    FString hashed_message;
+    FHallidayHash32 hashed_message;
 };
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "HallidayTypes.h"
+
+#include "HallidayTypesLibrary.generated.h"
+
+/**
+ * Blueprint helpers to create, compare and format FHallidayAddress, FHallidayHash32 and FHallidaySignature values.
+ */
+UCLASS()
+class HALLIDAYSDK_API UHallidayTypesLibrary : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+    
+public:
+    /**
+     * Parse a hex address with or without "0x" as the prefix.
+     * @param HexString Address to parse.
+     * @param bSuccess False if the string is not exactly 20 bytes of hex.
+     */
+    UFUNCTION(BlueprintPure, Category = "Halliday|Types")
+        static FHallidayAddress MakeHallidayAddress(const FString& HexString, bool& bSuccess);
+    
+    /** Format an address as an EIP-55 checksummed hex string. */
+    UFUNCTION(BlueprintPure, Category = "Halliday|Types", meta = (DisplayName = "To String (Halliday Address)", CompactNodeTitle = "->", BlueprintAutocast))
+        static FString Conv_HallidayAddressToString(const FHallidayAddress& Address);
+    
+    UFUNCTION(BlueprintPure, Category = "Halliday|Types", meta = (DisplayName = "Equal (Halliday Address)", CompactNodeTitle = "=="))
+        static bool EqualEqual_HallidayAddress(const FHallidayAddress& A, const FHallidayAddress& B);
+    
+    /**
+     * Parse a hex hash with or without "0x" as the prefix.
+     * @param HexString Hash to parse.
+     * @param bSuccess False if the string is not exactly 32 bytes of hex.
+     */
+    UFUNCTION(BlueprintPure, Category = "Halliday|Types")
+        static FHallidayHash32 MakeHallidayHash32(const FString& HexString, bool& bSuccess);
+    
+    /** Format a hash as a lowercase hex string. */
+    UFUNCTION(BlueprintPure, Category = "Halliday|Types", meta = (DisplayName = "To String (Halliday Hash32)", CompactNodeTitle = "->", BlueprintAutocast))
+        static FString Conv_HallidayHash32ToString(const FHallidayHash32& Hash);
+    
+    UFUNCTION(BlueprintPure, Category = "Halliday|Types", meta = (DisplayName = "Equal (Halliday Hash32)", CompactNodeTitle = "=="))
+        static bool EqualEqual_HallidayHash32(const FHallidayHash32& A, const FHallidayHash32& B);
+    
+    /**
+     * Parse a hex signature with or without "0x" as the prefix.
+     * @param HexString Signature to parse.
+     * @param bSuccess False if the string is not exactly 65 bytes of hex.
+     */
+    UFUNCTION(BlueprintPure, Category = "Halliday|Types")
+        static FHallidaySignature MakeHallidaySignature(const FString& HexString, bool& bSuccess);
+    
+    /** Format a signature as a lowercase hex string. */
+    UFUNCTION(BlueprintPure, Category = "Halliday|Types", meta = (DisplayName = "To String (Halliday Signature)", CompactNodeTitle = "->", BlueprintAutocast))
+        static FString Conv_HallidaySignatureToString(const FHallidaySignature& Signature);
+    
+    UFUNCTION(BlueprintPure, Category = "Halliday|Types", meta = (DisplayName = "Equal (Halliday Signature)", CompactNodeTitle = "=="))
+        static bool EqualEqual_HallidaySignature(const FHallidaySignature& A, const FHallidaySignature& B);
+};
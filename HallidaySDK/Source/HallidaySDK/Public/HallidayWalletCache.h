@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HallidayTypes.h"
+
+/**
+ * Wallets of players keyed by player and blockchain.
+ * A wallet address never changes once it exists, so wallets are kept in memory and in a JSON file under Saved/Halliday. Returning players then get their wallet without a request.
+ * Player ids are only unique within one app, so AHalliday keeps one file per API key and environment.
+ * The cache must only be used on the game thread.
+ */
+class HALLIDAYSDK_API FHallidayWalletCache
+{
+public:
+    /**
+     * Load the wallets saved in a file, replacing the wallets in memory. Later changes are saved to the same file.
+     * @param InFilePath File to load from and save to. A missing file leaves the cache empty.
+     */
+    void Load(const FString& InFilePath);
+
+    /**
+     * Find the wallet of a player.
+     * @param InGamePlayerId Id of the player.
+     * @param BlockchainType Blockchain of the wallet.
+     * @param OutWallet Receives the wallet.
+     * @returns False if the wallet is not cached.
+     */
+    bool Find(const FString& InGamePlayerId, EBlockchainType BlockchainType, FWallet& OutWallet) const;
+
+    /**
+     * Add a wallet and save the cache if it changed.
+     * @param Wallet Wallet returned by the Halliday backend.
+     */
+    void Add(const FWallet& Wallet);
+
+    /**
+     * Remove every wallet of a player and save the cache.
+     * @param InGamePlayerId Id of the player.
+     */
+    void Remove(const FString& InGamePlayerId);
+
+    /** Remove every wallet and delete the file. */
+    void Empty();
+
+private:
+    /** Write every wallet to FilePath. */
+    void Save() const;
+
+    static FString MakeKey(const FString& InGamePlayerId, EBlockchainType BlockchainType);
+
+    /** Wallets keyed by player and blockchain. */
+    TMap<FString, FWallet> Wallets;
+
+    /** File the cache is saved to. Nothing is saved while it is empty. */
+    FString FilePath;
+};